@@ -0,0 +1,426 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+
+#include <string.h>
+#include <glob.h>
+#include <unistd.h>
+
+#include "sudoku.h"
+#include "sudoku_stream.h"
+#include "sudoku_cnf.h"
+#include "alloc.h"
+#include "bench_util.h"
+
+
+// ===== USEFULL DEFINES =====
+
+// Stages of the resolution of a grid, in order
+#define BENCH_PARSE 0
+#define BENCH_ENCODE 1
+#define BENCH_SOLVE 2
+#define BENCH_OUTPUT 3
+#define BENCH_STAGES 4
+
+#define BENCH_RUNS 5
+
+// Directory of the default corpus, given by CMake
+#ifndef BENCH_DATA_DIR
+#define BENCH_DATA_DIR "data"
+#endif
+
+// ===========================
+
+
+// ===== STRUCTS =====
+
+// Samples of a stage, one per grid and per run
+struct bench_stage {
+  double *seconds;
+  size_t length;
+  size_t allocations;
+  size_t allocated_bytes;
+  uint64_t counters[BENCH_COUNTERS];    // Sums of the hardware events
+};
+
+struct bench_file {
+  char *filename;
+  size_t grids;           // Valid grids of the file
+  size_t invalid;         // Invalid grids of the file
+  size_t solved;          // Solvable grids of the file
+  size_t clauses;         // Sums over the grids of the file
+  size_t litts;
+  size_t vars;
+  struct bench_stage stages[BENCH_STAGES];
+};
+
+// ===================
+
+
+// ===== PRIVATE =====
+
+void bench_stop(struct bench_stage *stage, bench_mark m) {
+  bench_measure r = bench_mark_stop(m);
+  stage->seconds[stage->length++] = r.seconds;
+  stage->allocations += r.allocations;
+  stage->allocated_bytes += r.allocated_bytes;
+  for (size_t k = 0; k < BENCH_COUNTERS; k++)
+    stage->counters[k] += r.counters[k];
+}
+
+/* Reads the whole content of filename, stores its length in length
+ *
+ * Returns NULL on failure
+ */
+char *bench_read_file(char *filename, size_t *length) {
+  FILE *file = fopen(filename, "r");
+  if (!file) return NULL;
+
+  size_t capacity = 4096;
+  char *buffer = malloc(capacity);
+  *length = 0;
+
+  while (buffer) {
+    *length += fread(buffer + *length, 1, capacity - *length, file);
+    if (*length < capacity) break;
+
+    capacity *= 2;
+    char *larger = realloc(buffer, capacity);
+    if (!larger) free(buffer);
+    buffer = larger;
+  }
+
+  fclose(file);
+  return buffer;
+}
+
+/* Parses every grid of content, storing them in grids (at most capacity)
+ *
+ * Returns the number of grids read and -1 on failure
+ */
+long bench_parse(struct bench_file *bf, char *content, size_t length,
+                 s_sudoku *grids, size_t capacity, bool measure) {
+  FILE *file = fmemopen(content, length, "r");
+  s_sudoku_stream st = file ? s_sudoku_stream_create(file) : NULL;
+  if (!st) {
+    if (file) fclose(file);
+    return -1;
+  }
+
+  size_t count = 0;
+  bf->invalid = 0;
+
+  while (!s_sudoku_stream_eof(st)) {
+    bench_mark m = bench_mark_start();
+    s_sudoku g = s_sudoku_stream_next(st);
+
+    if (!g) {
+      if (!s_sudoku_stream_eof(st)) bf->invalid++;
+      continue;
+    }
+
+    if (measure) bench_stop(&bf->stages[BENCH_PARSE], m);
+
+    if (count < capacity) grids[count] = g;
+    else s_sudoku_free(g);
+    count++;
+  }
+
+  s_sudoku_stream_free(st);
+  fclose(file);
+  return count;
+}
+
+/* Encodes, solves and outputs g with the solver sv, which keeps the rules
+ * of each size loaded, only the givens are encoded for each grid
+ *    - assumptions must be an array of n * n litterals (n the size of g)
+ *
+ * Returns 0 on success and -1 on failure
+ */
+int bench_grid(struct bench_file *bf, s_sudoku_solver sv, s_sudoku g, int *assumptions,
+               char *output, size_t output_size, bool first_run) {
+  bench_mark m = bench_mark_start();
+  size_t length = sudoku_to_assumptions(g, assumptions);
+  bench_stop(&bf->stages[BENCH_ENCODE], m);
+
+  sudoku_stats before, after;
+  s_sudoku_solver_get_stats(sv, &before);
+
+  m = bench_mark_start();
+  int solved = s_sudoku_solver_solve_assuming(sv, g, assumptions, length);
+  bench_stop(&bf->stages[BENCH_SOLVE], m);
+  if (solved == -1) return -1;
+
+  // Size of the formula given to the sat solver (rules and assumptions)
+  s_sudoku_solver_get_stats(sv, &after);
+  if (first_run) {
+    bf->clauses += after.dpll.clauses - before.dpll.clauses + length;
+    bf->litts += after.dpll.litts - before.dpll.litts + length;
+    bf->vars += after.dpll.vars - before.dpll.vars;
+  }
+
+  if (first_run && solved) bf->solved++;
+
+  m = bench_mark_start();
+  length = s_sudoku_render(g, SUDOKU_FORMAT_PRETTY, output, output_size);
+  bench_stop(&bf->stages[BENCH_OUTPUT], m);
+
+  return length > 0 ? 0 : -1;
+}
+
+/* Runs the whole resolution of the grids of the file bf->filename runs times
+ *
+ * Returns 0 on success and -1 on failure
+ */
+int bench_run_file(struct bench_file *bf, size_t runs) {
+  size_t length = 0;
+  char *content = bench_read_file(bf->filename, &length);
+  if (!content) return -1;
+  if (length == 0) {
+    free(content);
+    return 0;
+  }
+
+  // Count the grids first to size the samples
+  long grids = bench_parse(bf, content, length, NULL, 0, false);
+  if (grids <= 0) {
+    free(content);
+    return grids;
+  }
+  bf->grids = grids;
+
+  s_sudoku *parsed = malloc(sizeof(s_sudoku) * grids);
+  int status = parsed ? 0 : -1;
+
+  for (size_t k = 0; k < BENCH_STAGES && status == 0; k++) {
+    bf->stages[k].seconds = malloc(sizeof(double) * grids * runs);
+    if (!bf->stages[k].seconds) status = -1;
+  }
+
+  // The rules are encoded by the first grid of each size
+  s_sudoku_solver sv = s_sudoku_solver_create();
+  if (!sv) status = -1;
+
+  char *output = NULL;
+  size_t output_size = 0;
+  int *assumptions = NULL;
+  size_t assumptions_size = 0;
+
+  for (size_t run = 0; run < runs && status == 0; run++) {
+    if (bench_parse(bf, content, length, parsed, grids, true) != grids) {
+      status = -1;
+      break;
+    }
+
+    for (size_t k = 0; k < (size_t) grids; k++) {
+      size_t n = s_sudoku_size(parsed[k]);
+      size_t size = s_sudoku_render_size(n, SUDOKU_FORMAT_PRETTY);
+      if (size > output_size) {
+        free(output);
+        output_size = size;
+        output = malloc(output_size);
+      }
+      if (n * n > assumptions_size) {
+        free(assumptions);
+        assumptions_size = n * n;
+        assumptions = malloc(sizeof(int) * assumptions_size);
+      }
+
+      if (status == 0 && (!output || !assumptions
+                          || bench_grid(bf, sv, parsed[k], assumptions, output, output_size,
+                                        run == 0) == -1))
+        status = -1;
+      s_sudoku_free(parsed[k]);
+    }
+  }
+
+  if (sv) s_sudoku_solver_free(sv);
+  free(assumptions);
+  free(output);
+  free(parsed);
+  free(content);
+  return status;
+}
+
+int bench_compare_doubles(const void *a, const void *b) {
+  double x = *(const double *) a, y = *(const double *) b;
+  return (x > y) - (x < y);
+}
+
+/* Prints the opened hardware counters, divided by samples, as the fields of
+ * a JSON object. The counters which can't be read are null.
+ */
+void bench_print_counters(FILE *file, uint64_t *counters, size_t samples) {
+  double per_sample = samples ? 1.0 / samples : 0;
+
+  for (size_t k = 0; k < BENCH_COUNTERS; k++) {
+    fprintf(file, "%s\"%s\": ", k ? ", " : "", bench_counter_name(k));
+    if (bench_counter_available(k)) fprintf(file, "%.1f", counters[k] * per_sample);
+    else fprintf(file, "null");
+  }
+}
+
+void bench_print_stage(FILE *file, const char *name, struct bench_stage *stage,
+                       bool counters) {
+  double median = 0, p99 = 0, mean = 0;
+
+  if (stage->length > 0) {
+    qsort(stage->seconds, stage->length, sizeof(double), bench_compare_doubles);
+
+    size_t mid = stage->length / 2;
+    median = stage->length % 2 ? stage->seconds[mid]
+                               : (stage->seconds[mid - 1] + stage->seconds[mid]) / 2;
+
+    size_t rank = (99 * stage->length + 99) / 100;   // ceil(0.99 * length)
+    p99 = stage->seconds[rank - 1];
+
+    for (size_t k = 0; k < stage->length; k++)
+      mean += stage->seconds[k];
+    mean /= stage->length;
+  }
+
+  double per_sample = stage->length ? 1.0 / stage->length : 0;
+
+  fprintf(file, "\"%s\": {\"samples\": %zu, \"median_us\": %.3f, \"p99_us\": %.3f, "
+          "\"mean_us\": %.3f, \"allocations\": %.1f, \"allocated_bytes\": %.1f",
+          name, stage->length, median * 1e6, p99 * 1e6, mean * 1e6,
+          stage->allocations * per_sample, stage->allocated_bytes * per_sample);
+  if (counters) {
+    fprintf(file, ", ");
+    bench_print_counters(file, stage->counters, stage->length);
+  }
+  fprintf(file, "}");
+}
+
+void bench_print_file(FILE *file, struct bench_file *bf, bool first, bool counters) {
+  const char *names[] = {"parse", "encode", "solve", "output"};
+  double per_grid = bf->grids ? 1.0 / bf->grids : 0;
+
+  fprintf(file, "%s\n    {\"file\": \"%s\", \"grids\": %zu, \"invalid\": %zu, "
+          "\"solved\": %zu, \"clauses\": %.1f, \"litts\": %.1f, \"vars\": %.1f,\n"
+          "     \"stages\": {",
+          first ? "" : ",", bf->filename, bf->grids, bf->invalid, bf->solved,
+          bf->clauses * per_grid, bf->litts * per_grid, bf->vars * per_grid);
+
+  for (size_t k = 0; k < BENCH_STAGES; k++) {
+    fprintf(file, "%s", k ? ",\n                " : "");
+    bench_print_stage(file, names[k], &bf->stages[k], counters);
+  }
+  fprintf(file, "}}");
+}
+
+/* Prints the hardware events of each stage summed over every file, and
+ * their means per grid
+ */
+void bench_print_total(FILE *file, struct bench_stage *total) {
+  const char *names[] = {"parse", "encode", "solve", "output"};
+
+  fprintf(file, "\"total\": {");
+  for (size_t k = 0; k < BENCH_STAGES; k++) {
+    fprintf(file, "%s\"%s\": {\"samples\": %zu, ", k ? ",\n           " : "",
+            names[k], total[k].length);
+    bench_print_counters(file, total[k].counters, 1);
+    fprintf(file, ",\n             \"per_grid\": {");
+    bench_print_counters(file, total[k].counters, total[k].length);
+    fprintf(file, "}}");
+  }
+  fprintf(file, "}");
+}
+
+void usage(char *exec) {
+  printf("%s [-r runs] [-p] [filename]...\n", exec);
+  printf("    Parses, encodes, solves and renders every grid of the files runs\n");
+  printf("    times (default %d) and prints the times of each stage as JSON.\n", BENCH_RUNS);
+  printf("    Without filename, the files of %s are used.\n", BENCH_DATA_DIR);
+  printf("    Times are per grid, allocations and allocated bytes are means per grid.\n");
+  printf("    -p : also read the hardware counters (cycles, instructions, cache and\n");
+  printf("      branch misses) of each stage, as means per grid and totals. The\n");
+  printf("      counters which can't be opened are null.\n");
+}
+
+// ===================
+
+
+int main(int argc, char *argv[]) {
+  size_t runs = BENCH_RUNS;
+  bool counters = false;
+
+  int opt;
+  while ((opt = getopt(argc, argv, "r:p")) != -1) {
+    if (opt == 'r' && atoi(optarg) > 0) {
+      runs = atoi(optarg);
+    } else if (opt == 'p') {
+      counters = true;
+    } else {
+      usage(argv[0]);
+      exit(EXIT_FAILURE);
+    }
+  }
+
+  char **filenames = argv + optind;
+  size_t count = argc - optind;
+
+  glob_t corpus;
+  memset(&corpus, 0, sizeof(corpus));
+  if (count == 0) {
+    if (glob(BENCH_DATA_DIR "/*.txt", 0, NULL, &corpus) != 0) {
+      fprintf(stderr, "%s: no grid found\n", BENCH_DATA_DIR);
+      return EXIT_FAILURE;
+    }
+    filenames = corpus.gl_pathv;
+    count = corpus.gl_pathc;
+  }
+
+  alloc_set_counting(true);
+
+  // The benchmark still runs without the counters (no perf events in a
+  // container, perf_event_paranoid too high, ...)
+  int opened = counters ? bench_counters_open() : BENCH_COUNTERS;
+  if (opened == 0)
+    fprintf(stderr, "the hardware counters are not available (perf_event_open), they are null\n");
+  else if (opened < BENCH_COUNTERS)
+    fprintf(stderr, "some hardware counters are not available, they are null\n");
+
+  struct bench_stage total[BENCH_STAGES];
+  memset(total, 0, sizeof(total));
+
+  int status = EXIT_SUCCESS;
+  printf("{\"runs\": %zu, \"files\": [", runs);
+
+  bool first = true;
+  for (size_t k = 0; k < count; k++) {
+    struct bench_file bf;
+    memset(&bf, 0, sizeof(bf));
+    bf.filename = filenames[k];
+
+    if (bench_run_file(&bf, runs) == -1) {
+      fprintf(stderr, "%s: can't run the benchmark\n", filenames[k]);
+      status = EXIT_FAILURE;
+    } else {
+      bench_print_file(stdout, &bf, first, counters);
+      first = false;
+
+      for (size_t s = 0; s < BENCH_STAGES; s++) {
+        total[s].length += bf.stages[s].length;
+        for (size_t c = 0; c < BENCH_COUNTERS; c++)
+          total[s].counters[c] += bf.stages[s].counters[c];
+      }
+    }
+
+    for (size_t s = 0; s < BENCH_STAGES; s++)
+      free(bf.stages[s].seconds);
+  }
+
+  printf("\n]");
+  if (counters) {
+    printf(",\n");
+    bench_print_total(stdout, total);
+  }
+  printf("}\n");
+
+  bench_counters_close();
+  globfree(&corpus);
+  return status;
+}
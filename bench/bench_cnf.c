@@ -0,0 +1,295 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+
+#include <string.h>
+#include <unistd.h>
+
+#include "sudoku.h"
+#include "sudoku_cnf.h"
+#include "cnf.h"
+#include "alloc.h"
+#include "bench_util.h"
+
+
+// ===== USEFULL DEFINES =====
+
+// Minimum time spent measuring each primitive for each size
+#define BENCH_CNF_SECONDS 0.2
+
+// ===========================
+
+
+// ===== STRUCTS =====
+
+// Formula of the rules of an empty grid, as plain arrays
+struct bench_formula {
+  size_t n;
+  s_cnf cn;
+  size_t clauses_length;
+  size_t *ids;          // ids[k] is the id of clause k in cn
+  int **litts;          // litts[k] are the litterals of clause k
+  size_t *lengths;      // lengths[k] is the number of litterals of clause k
+};
+
+// Result of a primitive, summed over every round
+struct bench_result {
+  size_t ops;
+  double seconds;
+  size_t allocations;
+  size_t allocated_bytes;
+};
+
+// ===================
+
+
+// ===== PRIVATE =====
+
+void bench_formula_free(struct bench_formula *f) {
+  for (size_t k = 0; k < f->clauses_length; k++)
+    alloc_free(f->litts[k]);
+  free(f->litts);
+  free(f->lengths);
+  alloc_free(f->ids);
+  if (f->cn) s_cnf_free(f->cn);
+}
+
+/* Builds the formula of the rules of an empty grid of size n, the same as the
+ * solver builds for a grid without given
+ *
+ * Returns 0 on success and -1 on failure
+ */
+int bench_formula_create(struct bench_formula *f, size_t n) {
+  memset(f, 0, sizeof(struct bench_formula));
+  f->n = n;
+
+  s_sudoku g = s_sudoku_create(n);
+  if (!g) return -1;
+  f->cn = sudoku_to_cnf(g);
+  s_sudoku_free(g);
+  if (!f->cn) return -1;
+
+  f->ids = s_cnf_get_clauses_ids(f->cn, &f->clauses_length);
+  f->litts = calloc(f->clauses_length, sizeof(int *));
+  f->lengths = calloc(f->clauses_length, sizeof(size_t));
+  if (!f->ids || !f->litts || !f->lengths) return -1;
+
+  for (size_t k = 0; k < f->clauses_length; k++) {
+    f->litts[k] = s_cnf_clause_get_litts(f->cn, f->ids[k], &f->lengths[k]);
+    if (!f->litts[k]) return -1;
+  }
+
+  return 0;
+}
+
+void bench_add(struct bench_result *r, bench_measure m, size_t ops) {
+  r->ops += ops;
+  r->seconds += m.seconds;
+  r->allocations += m.allocations;
+  r->allocated_bytes += m.allocated_bytes;
+}
+
+struct bench_result bench_add_clause(struct bench_formula *f, double seconds) {
+  struct bench_result r = {0};
+  while (r.seconds < seconds) {
+    s_cnf cn = s_cnf_create();
+    if (!cn) break;
+
+    bench_mark m = bench_mark_start();
+    for (size_t k = 0; k < f->clauses_length; k++)
+      s_cnf_add_clause(cn, f->litts[k], f->lengths[k]);
+    bench_add(&r, bench_mark_stop(m), f->clauses_length);
+
+    s_cnf_free(cn);
+  }
+  return r;
+}
+
+struct bench_result bench_free(struct bench_formula *f, double seconds) {
+  struct bench_result r = {0};
+  while (r.seconds < seconds) {
+    s_cnf cn = s_cnf_copy(f->cn);
+    if (!cn) break;
+
+    bench_mark m = bench_mark_start();
+    s_cnf_free(cn);
+    bench_add(&r, bench_mark_stop(m), 1);
+  }
+  return r;
+}
+
+struct bench_result bench_copy(struct bench_formula *f, double seconds) {
+  struct bench_result r = {0};
+  while (r.seconds < seconds) {
+    bench_mark m = bench_mark_start();
+    s_cnf cn = s_cnf_copy(f->cn);
+    bench_add(&r, bench_mark_stop(m), 1);
+
+    if (!cn) break;
+    s_cnf_free(cn);
+  }
+  return r;
+}
+
+struct bench_result bench_remove_clause(struct bench_formula *f, double seconds) {
+  struct bench_result r = {0};
+  while (r.seconds < seconds) {
+    s_cnf cn = s_cnf_copy(f->cn);
+    if (!cn) break;
+
+    bench_mark m = bench_mark_start();
+    for (size_t k = 0; k < f->clauses_length; k++)
+      s_cnf_remove_clause(cn, f->ids[k]);
+    bench_add(&r, bench_mark_stop(m), f->clauses_length);
+
+    s_cnf_free(cn);
+  }
+  return r;
+}
+
+/* Looks for a litteral present and a litteral absent in every clause
+ */
+struct bench_result bench_contains_litt(struct bench_formula *f, double seconds) {
+  struct bench_result r = {0};
+  while (r.seconds < seconds) {
+    bench_mark m = bench_mark_start();
+    for (size_t k = 0; k < f->clauses_length; k++) {
+      s_cnf_clause_contains_litt(f->cn, f->ids[k], f->litts[k][0]);
+      s_cnf_clause_contains_litt(f->cn, f->ids[k], -f->litts[k][0]);
+    }
+    bench_add(&r, bench_mark_stop(m), 2 * f->clauses_length);
+  }
+  return r;
+}
+
+struct bench_result bench_clause_unit(struct bench_formula *f, double seconds) {
+  struct bench_result r = {0};
+  while (r.seconds < seconds) {
+    bench_mark m = bench_mark_start();
+    for (size_t k = 0; k < f->clauses_length; k++)
+      s_cnf_clause_unit(f->cn, f->ids[k]);
+    bench_add(&r, bench_mark_stop(m), f->clauses_length);
+  }
+  return r;
+}
+
+struct bench_result bench_get_clauses_ids(struct bench_formula *f, double seconds) {
+  struct bench_result r = {0};
+  while (r.seconds < seconds) {
+    size_t length = 0;
+    bench_mark m = bench_mark_start();
+    size_t *ids = s_cnf_get_clauses_ids(f->cn, &length);
+    bench_add(&r, bench_mark_stop(m), 1);
+
+    if (!ids) break;
+    alloc_free(ids);
+  }
+  return r;
+}
+
+struct bench_result bench_clause_get_litts(struct bench_formula *f, double seconds) {
+  struct bench_result r = {0};
+  while (r.seconds < seconds) {
+    bench_mark m = bench_mark_start();
+    for (size_t k = 0; k < f->clauses_length; k++) {
+      size_t length = 0;
+      alloc_free(s_cnf_clause_get_litts(f->cn, f->ids[k], &length));
+    }
+    bench_add(&r, bench_mark_stop(m), f->clauses_length);
+  }
+  return r;
+}
+
+void bench_print_result(FILE *file, const char *name, struct bench_result r, bool first) {
+  double per_op = r.ops ? 1.0 / r.ops : 0;
+  fprintf(file, "%s\n       \"%s\": {\"ops\": %zu, \"ns_per_op\": %.1f, "
+          "\"allocations_per_op\": %.2f, \"bytes_per_op\": %.1f}",
+          first ? "" : ",", name, r.ops, r.seconds * per_op * 1e9,
+          r.allocations * per_op, r.allocated_bytes * per_op);
+}
+
+void usage(char *exec) {
+  printf("%s [-t seconds] [size]...\n", exec);
+  printf("    Measures the primitives of the cnf formulas on the formulas of the rules\n");
+  printf("    of empty grids of each size (default 4 9 16 25) and prints the time and\n");
+  printf("    allocations per operation as JSON. Each primitive is repeated for at\n");
+  printf("    least seconds (default %.1f).\n", BENCH_CNF_SECONDS);
+}
+
+// ===================
+
+
+int main(int argc, char *argv[]) {
+  double seconds = BENCH_CNF_SECONDS;
+
+  int opt;
+  while ((opt = getopt(argc, argv, "t:")) != -1) {
+    if (opt == 't' && atof(optarg) > 0) {
+      seconds = atof(optarg);
+    } else {
+      usage(argv[0]);
+      exit(EXIT_FAILURE);
+    }
+  }
+
+  size_t default_sizes[] = {4, 9, 16, 25};
+  size_t count = argc - optind;
+  size_t *sizes = count ? malloc(sizeof(size_t) * count) : default_sizes;
+  if (!sizes) return EXIT_FAILURE;
+  if (count == 0) count = 4;
+
+  for (size_t k = 0; k < count && sizes != default_sizes; k++) {
+    int n = atoi(argv[optind + k]);
+    if (n <= 0) {
+      usage(argv[0]);
+      exit(EXIT_FAILURE);
+    }
+    sizes[k] = n;
+  }
+
+  const char *names[] = {"add_clause", "copy", "free", "remove_clause",
+                         "clause_contains_litt", "clause_unit",
+                         "get_clauses_ids", "clause_get_litts"};
+  struct bench_result (*primitives[])(struct bench_formula *, double) = {
+    bench_add_clause, bench_copy, bench_free, bench_remove_clause,
+    bench_contains_litt, bench_clause_unit, bench_get_clauses_ids,
+    bench_clause_get_litts
+  };
+  size_t primitives_length = sizeof(primitives) / sizeof(primitives[0]);
+
+  alloc_set_counting(true);
+
+  int status = EXIT_SUCCESS;
+  printf("{\"seconds\": %.3f, \"sizes\": [", seconds);
+
+  bool first = true;
+  for (size_t k = 0; k < count; k++) {
+    struct bench_formula f;
+    if (bench_formula_create(&f, sizes[k]) == -1) {
+      fprintf(stderr, "%zu: can't build the formula (the size must be a perfect square)\n", sizes[k]);
+      bench_formula_free(&f);
+      status = EXIT_FAILURE;
+      continue;
+    }
+
+    printf("%s\n    {\"n\": %zu, \"clauses\": %zu, \"litts\": %zu, \"vars\": %zu,\n"
+           "     \"primitives\": {",
+           first ? "" : ",", f.n, f.clauses_length, s_cnf_get_litts_count(f.cn),
+           s_cnf_get_vars_count(f.cn));
+
+    for (size_t p = 0; p < primitives_length; p++)
+      bench_print_result(stdout, names[p], primitives[p](&f, seconds), p == 0);
+    printf("}}");
+    fflush(stdout);
+    first = false;
+
+    bench_formula_free(&f);
+  }
+
+  printf("\n]}\n");
+
+  if (sizes != default_sizes) free(sizes);
+  return status;
+}
@@ -0,0 +1,115 @@
+#define _GNU_SOURCE
+
+#include <stdlib.h>
+#include <stdbool.h>
+
+#include <string.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#endif
+
+#include "alloc.h"
+#include "util.h"
+#include "bench_util.h"
+
+
+// ===== PRIVATE =====
+
+// File descriptor of each hardware counter, -1 when it is closed
+static int bench_counters[BENCH_COUNTERS] = {-1, -1, -1, -1};
+
+/* Reads every opened counter in counters, the closed ones read as 0
+ */
+void bench_counters_read(uint64_t *counters) {
+  for (size_t k = 0; k < BENCH_COUNTERS; k++) {
+    counters[k] = 0;
+    if (bench_counters[k] != -1
+        && read(bench_counters[k], &counters[k], sizeof(uint64_t)) != sizeof(uint64_t))
+      counters[k] = 0;
+  }
+}
+
+#ifdef __linux__
+int bench_counter_open(uint64_t config) {
+  struct perf_event_attr attr;
+  memset(&attr, 0, sizeof(attr));
+  attr.size = sizeof(attr);
+  attr.type = PERF_TYPE_HARDWARE;
+  attr.config = config;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+
+  // Counts the calling thread on any cpu
+  return syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+}
+#endif
+
+// ===================
+
+
+// ===== BASE FUNCTIONS =====
+
+bench_mark bench_mark_start() {
+  alloc_stats stats;
+  alloc_get_total(&stats);
+
+  bench_mark m = {0, stats.allocations, stats.bytes, {0}};
+  bench_counters_read(m.counters);
+  m.start = util_now();
+  return m;
+}
+
+bench_measure bench_mark_stop(bench_mark m) {
+  double now = util_now();
+  uint64_t counters[BENCH_COUNTERS];
+  bench_counters_read(counters);
+
+  alloc_stats stats;
+  alloc_get_total(&stats);
+
+  bench_measure r = {now - m.start, stats.allocations - m.allocations,
+                     stats.bytes - m.allocated_bytes, {0}};
+  for (size_t k = 0; k < BENCH_COUNTERS; k++)
+    r.counters[k] = counters[k] - m.counters[k];
+  return r;
+}
+
+int bench_counters_open() {
+  int opened = 0;
+
+#ifdef __linux__
+  uint64_t configs[BENCH_COUNTERS] = {
+    PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+    PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES
+  };
+
+  for (size_t k = 0; k < BENCH_COUNTERS; k++) {
+    if (bench_counters[k] == -1) bench_counters[k] = bench_counter_open(configs[k]);
+    if (bench_counters[k] != -1) opened++;
+  }
+#endif
+
+  return opened;
+}
+
+void bench_counters_close() {
+  for (size_t k = 0; k < BENCH_COUNTERS; k++) {
+    if (bench_counters[k] != -1) close(bench_counters[k]);
+    bench_counters[k] = -1;
+  }
+}
+
+bool bench_counter_available(size_t k) {
+  return k < BENCH_COUNTERS && bench_counters[k] != -1;
+}
+
+const char *bench_counter_name(size_t k) {
+  const char *names[] = {"cycles", "instructions", "cache_misses", "branch_misses"};
+  return k < BENCH_COUNTERS ? names[k] : "unknown";
+}
+
+// ==========================
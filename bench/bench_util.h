@@ -0,0 +1,80 @@
+#ifndef BENCH_UTIL_H
+#define BENCH_UTIL_H
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+
+// ===== USEFULL DEFINES =====
+
+// Hardware counters read around the measures, see bench_counters_open
+#define BENCH_CYCLES 0
+#define BENCH_INSTRUCTIONS 1
+#define BENCH_CACHE_MISSES 2
+#define BENCH_BRANCH_MISSES 3
+#define BENCH_COUNTERS 4
+
+// ===========================
+
+
+// ===== STRUCTS =====
+
+/* Time, allocations and hardware counters at the start of a measure, see
+ * bench_mark_start
+ */
+typedef struct bench_mark {
+  double start;
+  size_t allocations;
+  size_t allocated_bytes;
+  uint64_t counters[BENCH_COUNTERS];
+} bench_mark;
+
+// Time, allocations and hardware events between bench_mark_start and
+// bench_mark_stop
+typedef struct bench_measure {
+  double seconds;
+  size_t allocations;
+  size_t allocated_bytes;
+  uint64_t counters[BENCH_COUNTERS];
+} bench_measure;
+
+// ===================
+
+
+// ===== BASE FUNCTIONS =====
+
+/* The allocations are the ones counted by the allocator of the library
+ * (see alloc.h), the counting must be started with alloc_set_counting. Allocations
+ * made by the benchmarks themselves or inside the C library are not seen.
+ */
+bench_mark bench_mark_start();
+
+bench_measure bench_mark_stop(bench_mark m);
+
+/* Opens the hardware counters (perf_event_open on Linux) of the calling
+ * thread, they are then read by bench_mark_start and bench_mark_stop. Only
+ * the user space events are counted so it works with the default
+ * perf_event_paranoid.
+ *
+ * Each counter the kernel or the hardware doesn't give stays closed and
+ * reads as 0, see bench_counter_available.
+ *
+ * Returns the number of counters opened (0 when none is available)
+ */
+int bench_counters_open();
+
+void bench_counters_close();
+
+/* Returns whether the counter k (BENCH_CYCLES, ...) is opened
+ */
+bool bench_counter_available(size_t k);
+
+/* Returns the name of the counter k ("cycles", ...)
+ */
+const char *bench_counter_name(size_t k);
+
+// ==========================
+
+
+#endif
@@ -0,0 +1,120 @@
+#ifndef ALLOC_H
+#define ALLOC_H
+
+#include <stdlib.h>
+#include <stdbool.h>
+
+
+// ===== USEFULL DEFINES =====
+
+// Part of the library an allocation is made for, the counters are kept per
+// subsystem
+typedef enum alloc_subsystem {
+  ALLOC_SUDOKU,     // Grids, streams, writers and packs
+  ALLOC_CNF,        // Formulas, their clauses and litterals
+  ALLOC_DPLL,       // Valuations of the solver
+  ALLOC_ENCODE,     // Encoding of the grids and solver cache
+  ALLOC_RUNTIME,    // Batches, pipelines, queues, daemon and traces
+  ALLOC_COUNT,      // Model counting and its cache of components
+  ALLOC_PREPROCESS, // Simplification of the formulas before the search
+  ALLOC_SUBSYSTEMS, // Number of subsystems
+} alloc_subsystem;
+
+// ===========================
+
+
+// ===== STRUCTS =====
+
+/* Allocator used by every allocation of the library, ctx is given back to
+ * each function
+ *
+ * size returns the usable size of a block, it is only used to follow the
+ * live and peak bytes and may be NULL.
+ */
+typedef struct alloc_allocator {
+  void *(*malloc)(void *ctx, size_t size);
+  void *(*calloc)(void *ctx, size_t count, size_t size);
+  void *(*realloc)(void *ctx, void *ptr, size_t size);
+  void (*free)(void *ctx, void *ptr);
+  size_t (*size)(void *ctx, void *ptr);
+  void *ctx;
+} alloc_allocator;
+
+/* Counters of the allocations, see alloc_get_stats
+ *
+ * A block may be freed by another subsystem than the one which allocated it
+ * (the arrays returned by the getters of the cnf formulas for example), so
+ * frees, live and peak bytes are only counted for the whole library.
+ */
+typedef struct alloc_stats {
+  size_t allocations;     // Calls to malloc, calloc and realloc
+  size_t bytes;           // Bytes requested by these calls
+  size_t frees;
+  size_t live_bytes;      // Usable bytes of the blocks not freed yet
+  size_t peak_bytes;      // Highest live_bytes
+} alloc_stats;
+
+// ===================
+
+
+// ===== BASE FUNCTIONS =====
+
+/* Replaces the allocator of the library, NULL restores the C library one
+ *    - allocator must have non-null malloc, calloc, realloc and free
+ *
+ * It must be called while no block of the library is allocated, a block
+ * can't be freed by another allocator than the one which allocated it.
+ * The blocks documented as to be freed with free() by the caller can only
+ * be freed that way with the C library allocator, use alloc_free otherwise.
+ */
+void alloc_set_allocator(const alloc_allocator *allocator);
+
+/* Starts (or stops) counting the allocations, the counting is off by
+ * default and only costs a load then. The counters are shared by every
+ * thread.
+ */
+void alloc_set_counting(bool counting);
+
+/* Resets every counter, the live bytes restart from 0 so the peak is the
+ * one of the blocks allocated from now on
+ */
+void alloc_reset_stats();
+
+/* Allocation functions of the library, they behave as the C library ones
+ * and count the allocation for subsystem
+ *
+ * Returns NULL on failure
+ */
+void *alloc_malloc(alloc_subsystem subsystem, size_t size);
+
+void *alloc_calloc(alloc_subsystem subsystem, size_t count, size_t size);
+
+void *alloc_realloc(alloc_subsystem subsystem, void *ptr, size_t size);
+
+void alloc_free(void *ptr);
+
+// ==========================
+
+
+// ===== GETTERS =====
+
+/* Stores the counters of subsystem in stats, only allocations and bytes
+ * are kept per subsystem (the other fields are 0)
+ *    - subsystem must be < ALLOC_SUBSYSTEMS
+ *    - stats must be a valid non-null pointer
+ */
+void alloc_get_stats(alloc_subsystem subsystem, alloc_stats *stats);
+
+/* Stores the counters of the whole library in stats
+ *    - stats must be a valid non-null pointer
+ */
+void alloc_get_total(alloc_stats *stats);
+
+/* Returns the name of subsystem ("sudoku", "cnf", ...)
+ */
+const char *alloc_subsystem_name(alloc_subsystem subsystem);
+
+// ===================
+
+
+#endif
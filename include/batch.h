@@ -0,0 +1,84 @@
+#ifndef BATCH_H
+#define BATCH_H
+
+#include <stdlib.h>
+#include <stdbool.h>
+
+#include "sudoku.h"
+#include "sudoku_writer.h"
+#include "sudoku_cnf.h"
+
+
+// ===== USEFULL DEFINES =====
+
+// Number of grids in flight per worker thread
+#define BATCH_JOBS_PER_THREAD 64
+
+// ===========================
+
+
+// ===== STRUCTS =====
+
+typedef struct batch_options {
+  size_t threads;         // Number of worker threads (0 for one per core)
+  sudoku_format format;   // Output format of the results
+  sudoku_stats *stats;    // If not NULL, the statistics of the resolutions
+                          // are added to it (see sudoku_stats_add)
+  bool count;             // Counts the solutions instead of solving
+  size_t portfolio;       // Sat solvers racing on each grid, 0 or 1 for a
+                          // single one (see s_sudoku_solver_create_portfolio)
+  bool conquer;           // The solvers of the portfolio share the search
+  bool preprocess;        // The formula of each grid is simplified before it
+                          // is solved (see s_sudoku_solver_set_preprocess)
+} batch_options;
+
+// ===================
+
+
+// ===== BASE FUNCTIONS =====
+
+/* Solves every grid of the files filenames with a pool of worker threads
+ * and writes the results with w in the order of the input
+ *    - filenames must be an array of count valid file names, - is the
+ *      standard input
+ *    - w must be a valid non-null writer
+ *
+ * The grids are read as streams (see sudoku_stream.h) by the calling thread
+ * and handed to the workers, each of them solving its own grids with its
+ * own state. At most BATCH_JOBS_PER_THREAD grids per worker are in memory
+ * at the same time, whatever the size of the input.
+ *
+ * The result of a grid is written as :
+ *    - SUDOKU_FORMAT_PRETTY : the grid, whether it can be solved and the
+ *      solution
+ *    - SUDOKU_FORMAT_SEMICOLON : the solution
+ *    - SUDOKU_FORMAT_LINE : the solution on a single line
+ * The solution of a grid that can't be solved is replaced by the line
+ * "unsolvable" in the two last formats. In the two first formats the
+ * results are separated by an empty line.
+ *
+ * With options.count, the result of a grid is the line of the number of its
+ * solutions (see s_sudoku_solver_count_all) whatever the format.
+ *
+ * Invalid grids are reported on the standard error and skipped.
+ *
+ * Returns 0 on success and -1 on failure (including invalid grids or files
+ * and inputs without any grid)
+ */
+int batch_solve(char **filenames, size_t count, s_sudoku_writer w,
+                batch_options options);
+
+/* Writes the result of the resolution of a grid in the given format (see
+ * batch_solve)
+ *    - initial is the grid before its resolution
+ *    - solution is the solved grid (unused when solved is false)
+ *
+ * Returns 0 on success and -1 on failure
+ */
+int batch_write_result(s_sudoku_writer w, s_sudoku initial, s_sudoku solution,
+                       int solved, sudoku_format format);
+
+// ==========================
+
+
+#endif
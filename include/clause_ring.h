@@ -0,0 +1,81 @@
+#ifndef CLAUSE_RING_H
+#define CLAUSE_RING_H
+
+#include <stdlib.h>
+#include <stdbool.h>
+
+
+// ===== STRUCTS =====
+
+// Private lock-free ring of clauses with a single producer and any number of
+// readers
+typedef struct clause_ring *s_clause_ring;
+
+// ===================
+
+
+// ===== BASE FUNCTIONS =====
+
+/* Creates an empty ring that can hold capacity litterals and returns it
+ *    - capacity must be > 1, it is rounded up to a power of two
+ *
+ * Only one thread may push clauses in the ring. Any number of threads may
+ * read them, each with its own cursor, and the clauses are never removed:
+ * the producer overwrites the oldest ones when the ring is full, without
+ * waiting for the readers. A reader which falls behind loses the clauses
+ * overwritten, it is never given a clause being overwritten (each read is
+ * checked after the copy, as with a seqlock). Nobody ever takes a lock.
+ *
+ * Returns NULL on failure
+ */
+s_clause_ring s_clause_ring_create(size_t capacity);
+
+void s_clause_ring_free(s_clause_ring r);
+
+/* Empties the ring, only called when no other thread uses it: the cursors
+ * must be set back to 0
+ *    - r must be a valid non-null ring
+ */
+void s_clause_ring_clear(s_clause_ring r);
+
+/* Adds the clause of the length litterals litts to the ring, only called by
+ * the producer
+ *    - r must be a valid non-null ring
+ *    - litts must be a valid array of non zero litterals
+ *
+ * Returns false if the clause is empty or doesn't fit in the ring and true
+ * otherwise
+ */
+bool s_clause_ring_push(s_clause_ring r, const int *litts, size_t length);
+
+/* Copies in litts the next clause of the ring after *cursor and moves
+ * *cursor after it
+ *    - r must be a valid non-null ring
+ *    - cursor must be a valid pointer, 0 for the first clause
+ *    - litts must be a valid array of capacity litterals, the longer
+ *      clauses are skipped
+ *
+ * Returns the length of the clause and 0 when there is none left
+ */
+size_t s_clause_ring_read(s_clause_ring r, size_t *cursor, int *litts, size_t capacity);
+
+// ==========================
+
+
+// ===== GETTERS =====
+
+/* Returns the number of clauses pushed since the creation or the last
+ * clear, it may already be outdated when the ring is used by other threads
+ *    - r must be a valid non-null ring
+ */
+size_t s_clause_ring_pushed(s_clause_ring r);
+
+/* Returns the number of litterals the ring can hold
+ *    - r must be a valid non-null ring
+ */
+size_t s_clause_ring_capacity(s_clause_ring r);
+
+// ===================
+
+
+#endif
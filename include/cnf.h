@@ -114,7 +114,8 @@ int s_cnf_clause_contains_litt(s_cnf cn, size_t c_id, int litt);
  *
  * Modifying the returned array doesn't modify the cnf formula.
  *
- * The returned array must be freed by the user
+ * The returned array must be freed by the user with alloc_free (or free
+ * with the default allocator)
  *
  * This function returns NULL on empty lists
  * If invalid arguments are passed to this function
@@ -131,7 +132,8 @@ size_t *s_cnf_get_clauses_ids(s_cnf cn, size_t *n);
  *
  * Modifying the returned array does't modify the cnf formula.
  *
- * The returned array must be freed by the user
+ * The returned array must be freed by the user with alloc_free (or free
+ * with the default allocator)
  *
  * This function returns NULL on empty lists
  * If invalid arguments are passed to this function
@@ -140,6 +142,29 @@ size_t *s_cnf_get_clauses_ids(s_cnf cn, size_t *n);
  */
 int *s_cnf_clause_get_litts(s_cnf cn, size_t c_id, size_t *n);
 
+/* Returns the number of clauses in the cnf formula cn
+ *    - cn must be a valid non-null cnf formula
+ *
+ * Returns 0 on invalid arguments
+ */
+size_t s_cnf_get_clauses_count(s_cnf cn);
+
+/* Returns the number of litterals in the cnf formula cn, summed over all of
+ * its clauses
+ *    - cn must be a valid non-null cnf formula
+ *
+ * Returns 0 on invalid arguments
+ */
+size_t s_cnf_get_litts_count(s_cnf cn);
+
+/* Returns the number of variables of the cnf formula cn, that is the largest
+ * variable appearing in one of its litterals
+ *    - cn must be a valid non-null cnf formula
+ *
+ * Returns 0 on invalid arguments
+ */
+size_t s_cnf_get_vars_count(s_cnf cn);
+
 // ===================
 
 // ===== UTILITY FUNCTIONS =====
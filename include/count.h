@@ -0,0 +1,72 @@
+#ifndef COUNT_H
+#define COUNT_H
+
+#include <stdlib.h>
+
+#include "cnf.h"
+
+
+// ===== USEFULL DEFINES =====
+
+// Size of the keys of the components cached before the cache is emptied
+#define COUNT_CACHE_BYTES ((size_t) 256 * 1024 * 1024)
+
+// Characters of the largest count_number in decimal, without the null one
+#define COUNT_DIGITS 39
+
+// ===========================
+
+
+// ===== STRUCTS =====
+
+// Number of models, exact up to 2^128 - 1
+__extension__ typedef unsigned __int128 count_number;
+
+// Statistics of a count, see count_models
+typedef struct count_stats {
+  size_t decisions;       // Variables branched on
+  size_t conflicts;       // Branches without any model
+  size_t components;      // Independent components counted
+  size_t cache_hits;      // Components whose count was already known
+  size_t cache_entries;   // Components in the cache at the end
+  size_t cache_flushes;   // Times the cache was emptied, see COUNT_CACHE_BYTES
+  size_t vars;            // Size of the formula
+  size_t clauses;
+  double seconds;         // Time spent in the count
+} count_stats;
+
+// ===================
+
+
+// ===== BASE FUNCTIONS =====
+
+/* Counts the models of the formula cn over its variables 1 to
+ * s_cnf_get_vars_count(cn), a variable in no clause doubling the count
+ *      - cn must be a valid non-null cnf formula
+ *      - count must be a valid pointer
+ *      - stats is filled with the statistics of the count if not NULL
+ *
+ * The count is exact (#SAT), the models are never enumerated: after the
+ * propagation of each decision the remaining clauses are split into
+ * components without any variable in common, counted one by one and
+ * multiplied. The count of each component is cached under its variables
+ * and its shortened clauses, so a component reached again by other
+ * decisions is not counted twice.
+ *
+ * Returns 0 on success (0 models when cn is unsatisfiable) and -1 on
+ * failure (allocation, count above 2^128 - 1)
+ */
+int count_models(s_cnf cn, count_number *count, count_stats *stats);
+
+/* Writes count in decimal in buffer, followed by a null character
+ *      - buffer must be a valid array of size bytes, COUNT_DIGITS + 1 are
+ *        always enough
+ *
+ * Returns the number of digits written, 0 when buffer is too small
+ */
+size_t count_render(count_number count, char *buffer, size_t size);
+
+// ==========================
+
+
+#endif
@@ -0,0 +1,81 @@
+#ifndef DAEMON_H
+#define DAEMON_H
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "sudoku_cnf.h"
+
+
+// ===== PROTOCOL =====
+
+/* The daemon answers requests made of one line each. A request is a grid in
+ * the line format (see s_sudoku_create_from_line) and its answer is a single
+ * line :
+ *    - the solution of the grid in the line format
+ *    - "unsolvable" if the grid can't be solved
+ *    - "invalid" if the request is not a valid grid
+ *
+ * Empty requests are ignored. Answers are given in the order of the
+ * requests.
+ *
+ *    > .12....1.3.2.2..
+ *    < 3124243113424213
+ *    > 1..1............
+ *    < unsolvable
+ */
+
+// Maximum length of a request, longer requests are invalid
+#define DAEMON_MAX_REQUEST 4096
+
+// Bytes of answers waiting to be sent to a client above which its requests
+// are not read anymore, until it reads its answers
+#define DAEMON_MAX_PENDING (16 * (DAEMON_MAX_REQUEST + 1))
+
+// ====================
+
+
+// ===== BASE FUNCTIONS =====
+
+/* Writes the answer to the request line in answer and returns its length
+ * (see the protocol above)
+ *    - sv must be a valid non-null solver
+ *    - line must be a valid array of length characters, without the final
+ *      new line
+ *    - answer must be a valid array of at least DAEMON_MAX_REQUEST + 1
+ *      characters
+ */
+size_t daemon_answer(s_sudoku_solver sv, const char *line, size_t length,
+                     char *answer);
+
+/* Answers every request read from in to out until the end of in, the
+ * answer to a request is flushed before reading the next one
+ *    - in must be a valid file opened for reading
+ *    - out must be a valid file opened for writing
+ *
+ * Returns 0 on success and -1 on failure
+ */
+int daemon_run_stream(FILE *in, FILE *out);
+
+/* Listens on the unix domain socket path and answers the requests of every
+ * client connected to it until daemon_stop is called (or SIGINT / SIGTERM is
+ * received)
+ *    - path must be a valid path for a socket, an existing file at path is
+ *      replaced
+ *
+ * Every client is served by the same thread and the same solver so the
+ * state kept by the solver stays warm from a request to another.
+ *
+ * Returns 0 on success and -1 on failure
+ */
+int daemon_run_socket(char *path);
+
+/* Makes daemon_run_socket return as soon as possible, it can be called from
+ * a signal handler or another thread
+ */
+void daemon_stop();
+
+// ==========================
+
+
+#endif
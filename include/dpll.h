@@ -6,6 +6,66 @@
 #include "cnf.h"
 
 
+// ===== STRUCTS =====
+
+// Private reusable CDCL solver, see s_dpll_create
+typedef struct dpll *s_dpll;
+
+// Called with each model found by s_dpll_enumerate_assuming, returns 0 to
+// go on and another value to stop the enumeration
+typedef int (*dpll_model_callback)(s_dpll s, void *ctx);
+
+// Called with each clause learnt by a solver and its lbd (number of decision
+// levels of its litterals), see dpll_options
+typedef void (*dpll_export_callback)(const int *litts, size_t length, size_t lbd, void *ctx);
+
+// Called by a solver at level 0 for clauses to learn, stores one in litts (an
+// array of capacity litterals) and returns its length, 0 when there is none
+// left, see dpll_options
+typedef size_t (*dpll_import_callback)(int *litts, size_t capacity, void *ctx);
+
+// Statistics of a resolution, see dpll_valuations_stats
+typedef struct dpll_stats {
+  size_t decisions;       // Litterals chosen to branch on
+  size_t propagations;    // Unit clauses propagated
+  size_t pure_litterals;  // Pure litterals assigned
+  size_t conflicts;       // Empty clauses reached
+  size_t backtracks;      // Second branches of a decision explored
+  size_t max_depth;       // Deepest decision level reached
+  size_t clauses;         // Size of the formula at the start
+  size_t litts;
+  size_t vars;
+  size_t exported;        // Clauses learnt given to the export callback
+  size_t imported;        // Clauses kept from the import callback
+  double seconds;         // Time spent in the resolution
+} dpll_stats;
+
+// Restart policies of the solver, see dpll_options
+typedef enum dpll_restarts {
+  DPLL_RESTARTS_LUBY,       // restart_base times the luby sequence (default)
+  DPLL_RESTARTS_GEOMETRIC,  // restart_base times 1.5 to the restarts done
+  DPLL_RESTARTS_NONE,
+} dpll_restarts;
+
+// Configuration of the search of a solver, see s_dpll_set_options
+typedef struct dpll_options {
+  unsigned seed;            // Of the random choices below, 0 for none
+  double random_decisions;  // Part of the decisions on a random variable
+  int phase;                // First value tried for each variable, -1 false
+                            // (default), 1 true, 0 random
+  dpll_restarts restarts;
+  size_t restart_base;      // Conflicts of the first restart
+  double var_decay;         // Of the activities at each conflict, in ]0, 1[
+  const int *cancel;        // If not NULL, the search stops as soon as it
+                            // finds *cancel non zero, see s_dpll_set_options
+  dpll_export_callback export_clause;   // Clause sharing between solvers,
+  dpll_import_callback import_clause;   // unused when NULL, see
+  void *sharing;                        // s_dpll_set_options
+} dpll_options;
+
+// ===================
+
+
 // ===== BASE FUNCTIONS =====
 
 /* DPLL SAT SOLVER
@@ -19,10 +79,229 @@ bool dpll(s_cnf cn);
  *
  * *valuations must be initialized to NULL
  * *valuations_length must be initialized to 0
+ *
+ * *valuations must be freed by the user with alloc_free (or free with the
+ * default allocator)
  */
 bool dpll_valuations(s_cnf cn, int **valuations, size_t *valuations_length);
 
+/* Same as dpll_valuations, and fills stats with the statistics of the
+ * resolution if it is not NULL
+ */
+bool dpll_valuations_stats(s_cnf cn, int **valuations, size_t *valuations_length,
+                           dpll_stats *stats);
+
+/* Adds the statistics stats to total, the counters are summed except
+ * max_depth which is the maximum of both
+ */
+void dpll_stats_add(dpll_stats *total, const dpll_stats *stats);
+
 // ==========================
 
 
+// ===== SOLVER =====
+
+/* Creates an empty conflict driven clause learning solver and returns it
+ *
+ * Contrary to dpll, the solver keeps its arrays (assignment, trail, watches,
+ * heap, clauses) from a formula to the next: after s_dpll_reset, loading
+ * and solving a formula no larger than the ones already solved does not
+ * allocate.
+ *
+ * A solver must only be used by one thread at a time.
+ *
+ * Returns NULL on failure
+ */
+s_dpll s_dpll_create();
+
+void s_dpll_free(s_dpll s);
+
+/* Forgets the formula of s, its model and its checkpoint in constant time,
+ * the memory of s is kept for the next formula
+ *      - s must be a valid solver
+ */
+void s_dpll_reset(s_dpll s);
+
+/* Adds the clause of the length litterals litts to the formula of s
+ *      - s must be a valid solver
+ *      - litts must be a valid array of non zero litterals
+ *
+ * The empty clause makes the formula unsatisfiable.
+ *
+ * Returns 0 on success and -1 on failure
+ */
+int s_dpll_add_clause(s_dpll s, const int *litts, size_t length);
+
+/* Adds every clause of cn to the formula of s
+ *      - s must be a valid solver
+ *      - cn must be a valid formula
+ *
+ * Returns 0 on success and -1 on failure
+ */
+int s_dpll_add_cnf(s_dpll s, s_cnf cn);
+
+/* Solves the formula of s
+ *      - s must be a valid solver
+ *
+ * Returns 1 if the formula is satisfiable, 0 if it is not and -1 on failure
+ */
+int s_dpll_solve(s_dpll s);
+
+/* Solves the formula of s under the assumptions, the length litterals of
+ * assumptions which are taken as true for this resolution only
+ *      - s must be a valid solver
+ *      - assumptions must be a valid array of non zero litterals
+ *
+ * The solver is incremental: clauses may be added between two resolutions
+ * and the clauses learnt, even under assumptions, only depend on the formula
+ * so they are kept and speed up the next resolutions of related questions.
+ * When there is no model, s_dpll_get_core tells which assumptions failed.
+ *
+ * Returns 1 if the formula is satisfiable with the assumptions, 0 if it is
+ * not and -1 on failure
+ */
+int s_dpll_solve_assuming(s_dpll s, const int *assumptions, size_t length);
+
+/* Counts the models of the formula of s under the assumptions (see
+ * s_dpll_solve_assuming), stopping at limit models
+ *      - s must be a valid solver
+ *      - assumptions must be a valid array of non zero litterals
+ *      - limit must be > 0
+ *
+ * The models are found by a single search: each model is blocked by a
+ * clause of its decisions and the search goes on from there, so a count up
+ * to 2 to check that a model is unique costs about one resolution. The
+ * blocking clauses hold on a variable only assumed during the count, and
+ * are removed with it and the clauses learnt from them at the end, so the
+ * formula is unchanged afterwards. s_dpll_value gives the first model found.
+ *
+ * Returns the number of models found, at most limit, and -1 on failure
+ */
+long s_dpll_count_assuming(s_dpll s, const int *assumptions, size_t length, size_t limit);
+
+/* Calls callback with each model of the formula of s under the assumptions
+ * (see s_dpll_solve_assuming) as soon as it is found, until every model is
+ * found or callback returns a non zero value
+ *      - s must be a valid solver
+ *      - assumptions must be a valid array of non zero litterals
+ *      - callback must be a valid function, which reads the model with
+ *        s_dpll_value and must not change s
+ *
+ * After each model the last decision not flipped yet is flipped and the
+ * search goes on from there, as in dpll, so no clause is added to block the
+ * models and the memory used does not grow with their number. s_dpll_value
+ * gives the last model found once it returns.
+ *
+ * Returns the number of models given to callback and -1 on failure
+ */
+long s_dpll_enumerate_assuming(s_dpll s, const int *assumptions, size_t length,
+                               dpll_model_callback callback, void *ctx);
+
+/* Chooses a variable to split the search of the formula of s under the
+ * assumptions in two cubes, the assumptions with the variable true and with
+ * it false (see s_portfolio_conquer_assuming)
+ *      - s must be a valid solver
+ *      - assumptions must be a valid array of non zero litterals
+ *
+ * The unassigned variables of the shortest clauses left by the assumptions
+ * are propagated both ways (lookahead) and the one assigning the most
+ * variables on both sides is chosen. A variable whose propagation fails one
+ * way is assigned the other way for the next ones.
+ *
+ * Returns the variable, 0 if the assumptions are contradictory or leave no
+ * clause to split on, so that solving them is immediate, and -1 on failure
+ */
+int s_dpll_lookahead(s_dpll s, const int *assumptions, size_t length);
+
+/* Stores in options the default configuration of the solvers, used by
+ * s_dpll_create
+ */
+void dpll_default_options(dpll_options *options);
+
+/* Stores in options the configuration k of a portfolio: the configuration 0
+ * is the default one and the next ones differ by their seed, phases,
+ * random decisions, restarts and decay, so that solvers running them on the
+ * same formula take different paths (see portfolio.h)
+ */
+void dpll_portfolio_options(size_t k, dpll_options *options);
+
+/* Sets the configuration of the next resolutions of s
+ *      - s must be a valid solver
+ *      - options must be valid options (see dpll_default_options)
+ *
+ * The phase and the seed apply to the variables added afterwards and to
+ * every variable after s_dpll_rollback. The search of every resolution
+ * (solve, count and enumeration) stops when it reads a non zero *cancel,
+ * read atomically by the thread of s and written by any other, and the
+ * resolution returns -1. A conflict at level 0 is still answered, so a
+ * resolution cancelled can be run again.
+ *
+ * Solvers with the same formula can share the clauses they learn: the
+ * search gives each clause learnt to export_clause, and imports the clauses
+ * of import_clause (learnt by the others) at its start and at each restart.
+ * Both are called by the thread of s with sharing, and never while counting.
+ * The imported clauses must be implied by the formula of s, the ones with
+ * variables above s_dpll_vars(s) are ignored.
+ *
+ * Returns 0 on success and -1 on invalid options
+ */
+int s_dpll_set_options(s_dpll s, const dpll_options *options);
+
+/* Stores the configuration of s in options
+ */
+void s_dpll_get_options(s_dpll s, dpll_options *options);
+
+/* Saves the formula of s, restored by s_dpll_rollback
+ *      - s must be a valid solver
+ *
+ * Returns 0 on success and -1 on failure
+ */
+int s_dpll_checkpoint(s_dpll s);
+
+/* Restores the formula saved by the last s_dpll_checkpoint: the clauses
+ * added and learnt since are forgotten and the search starts again as in a
+ * new solver, so the next resolutions don't depend on the previous ones
+ *      - s must be a valid solver with a checkpoint (see s_dpll_reset)
+ *
+ * It takes a time linear in the size of the saved formula and does not
+ * allocate.
+ *
+ * Returns 0 on success and -1 on failure
+ */
+int s_dpll_rollback(s_dpll s);
+
+/* Returns 1 if var is true in the model found by the last s_dpll_solve (or
+ * the first one found by s_dpll_count_assuming, see also
+ * s_dpll_enumerate_assuming), 0 if it is false and -1 if there is no model
+ * or var is not a variable of the formula
+ */
+int s_dpll_value(s_dpll s, int var);
+
+/* Returns the failed assumptions of the last s_dpll_solve_assuming which
+ * found no model, an array of *length assumptions which can't be all true
+ * together with the formula. The array is owned by s and valid until its
+ * next resolution.
+ *      - s must be a valid solver
+ *      - length must be a valid non-null pointer
+ *
+ * *length is 0 when the formula is unsatisfiable without any assumption.
+ *
+ * Returns NULL on failure
+ */
+const int *s_dpll_get_core(s_dpll s, size_t *length);
+
+/* Returns the greatest variable of the formula of s
+ */
+size_t s_dpll_vars(s_dpll s);
+
+/* Stores in stats the statistics of the last s_dpll_solve, backtracks are
+ * the backjumps after a conflict
+ *      - s must be a valid solver
+ *      - stats must be a valid non-null pointer
+ */
+void s_dpll_get_stats(s_dpll s, dpll_stats *stats);
+
+// ==================
+
+
 #endif
@@ -0,0 +1,87 @@
+#ifndef PIPELINE_H
+#define PIPELINE_H
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "sudoku.h"
+#include "sudoku_writer.h"
+#include "sudoku_cnf.h"
+
+
+// ===== USEFULL DEFINES =====
+
+// Stages of the pipeline, in order
+#define PIPELINE_PARSE 0
+#define PIPELINE_ENCODE 1
+#define PIPELINE_SOLVE 2
+#define PIPELINE_EMIT 3
+#define PIPELINE_STAGES 4
+
+// Default number of grids each queue between two stages can hold
+#define PIPELINE_QUEUE_CAPACITY 256
+
+// ===========================
+
+
+// ===== STRUCTS =====
+
+typedef struct pipeline_options {
+  size_t queue_capacity;  // Capacity of the queues between the stages
+  sudoku_format format;   // Output format of the results (see batch_solve)
+  sudoku_stats *stats;    // If not NULL, the statistics of the resolutions
+                          // are added to it (see sudoku_stats_add)
+} pipeline_options;
+
+typedef struct pipeline_stage_stats {
+  size_t items;           // Number of grids processed by the stage
+  double busy_seconds;    // Time spent processing them
+  double wait_seconds;    // Time spent waiting for its input or its output
+} pipeline_stage_stats;
+
+typedef struct pipeline_queue_stats {
+  size_t capacity;        // Number of grids the queue can hold
+  size_t max_depth;       // Maximum number of grids it held
+  double mean_depth;      // Mean number of grids it held (sampled on push)
+} pipeline_queue_stats;
+
+typedef struct pipeline_stats {
+  double seconds;                                       // Total time
+  pipeline_stage_stats stages[PIPELINE_STAGES];
+  pipeline_queue_stats queues[PIPELINE_STAGES - 1];     // Input of stage k + 1
+} pipeline_stats;
+
+// ===================
+
+
+// ===== BASE FUNCTIONS =====
+
+/* Same as batch_solve but every stage of the resolution of the grids runs on
+ * its own thread :
+ *    - parse  : reads the grids of the files
+ *    - encode : computes their givens as assumptions (see
+ *               sudoku_to_assumptions)
+ *    - solve  : solves them with the rules of their size kept loaded (see
+ *               s_sudoku_solver_solve_assuming)
+ *    - emit   : writes the results with w (on the calling thread)
+ *
+ * The stages are connected by bounded lock-free queues, a stage waits when
+ * its output queue is full so at most queue_capacity grids (rounded up to
+ * a power of 2) are held between two stages.
+ *
+ * If stats is not NULL, the statistics of the stages and queues are stored
+ * in it so the slowest stage can be found.
+ *
+ * Returns 0 on success and -1 on failure (see batch_solve)
+ */
+int pipeline_solve(char **filenames, size_t count, s_sudoku_writer w,
+                   pipeline_options options, pipeline_stats *stats);
+
+/* Prints stats as a JSON object to file
+ */
+void pipeline_stats_print(FILE *file, pipeline_stats *stats);
+
+// ==========================
+
+
+#endif
@@ -0,0 +1,144 @@
+#ifndef PORTFOLIO_H
+#define PORTFOLIO_H
+
+#include <stdlib.h>
+
+#include "cnf.h"
+#include "dpll.h"
+
+
+// ===== USEFULL DEFINES =====
+
+// Cubes of a cube-and-conquer per solver, see s_portfolio_conquer_assuming
+#define PORTFOLIO_CUBES_PER_SOLVER 16
+
+// Clauses learnt shared with the other solvers: at most PORTFOLIO_SHARE_LENGTH
+// litterals on at most PORTFOLIO_SHARE_LBD decision levels, see
+// s_portfolio_set_sharing
+#define PORTFOLIO_SHARE_LENGTH 8
+#define PORTFOLIO_SHARE_LBD 4
+
+// Litterals of the clauses shared by a solver kept for the others to import
+#define PORTFOLIO_SHARE_CAPACITY ((size_t) 1 << 16)
+
+// ===========================
+
+
+// ===== STRUCTS =====
+
+// Private portfolio of sat solvers with the same formula, racing or sharing
+// the search
+typedef struct portfolio *s_portfolio;
+
+// Statistics of the last resolution of a portfolio
+typedef struct portfolio_stats {
+  size_t cubes;     // Cubes solved by the solvers, 0 for a race
+  size_t steals;    // Cubes taken from the deque of another solver
+  size_t shared;    // Clauses learnt given to the other solvers
+  size_t imported;  // Clauses learnt taken from the other solvers
+} portfolio_stats;
+
+// ===================
+
+
+// ===== BASE FUNCTIONS =====
+
+/* Creates a portfolio of solvers sat solvers with an empty formula and
+ * returns it
+ *    - solvers must be > 0
+ *
+ * The solver k is configured with dpll_portfolio_options(k), so the solvers
+ * have different seeds, phases, restart policies and decays and take
+ * different paths on the same formula.
+ *
+ * Returns NULL on failure
+ */
+s_portfolio s_portfolio_create(size_t solvers);
+
+void s_portfolio_free(s_portfolio p);
+
+/* Returns the number of solvers of p
+ */
+size_t s_portfolio_size(s_portfolio p);
+
+/* Returns the solver k of p, to add clauses, checkpoint or roll back one of
+ * the solvers only (NULL if k >= s_portfolio_size(p))
+ *
+ * The cancel flag and the sharing callbacks of its options must not be
+ * changed.
+ */
+s_dpll s_portfolio_solver(s_portfolio p, size_t k);
+
+/* Sets whether the solvers of p share the clauses they learn during their
+ * resolutions (on by default)
+ *
+ * Each solver puts the short clauses it learns (see PORTFOLIO_SHARE_LENGTH
+ * and PORTFOLIO_SHARE_LBD) in its own ring (see clause_ring.h), and takes
+ * the ones of the others at each restart (see dpll_options), so a conflict
+ * found by one solver is not searched again by the others. Neither side
+ * waits for the other: a solver which restarts too rarely misses the
+ * clauses overwritten in the meantime.
+ *
+ * The clauses shared are only implied by the formula of the solver which
+ * learnt them: sharing must be off while the solvers have different
+ * formulas (see s_portfolio_solver).
+ */
+void s_portfolio_set_sharing(s_portfolio p, bool sharing);
+
+/* Same as s_dpll_add_clause, for every solver of p
+ *
+ * Returns 0 on success and -1 on failure
+ */
+int s_portfolio_add_clause(s_portfolio p, const int *litts, size_t length);
+
+/* Same as s_dpll_add_cnf, for every solver of p
+ *
+ * Returns 0 on success and -1 on failure
+ */
+int s_portfolio_add_cnf(s_portfolio p, s_cnf cn);
+
+/* Same as s_dpll_solve_assuming, with every solver of p at once: the solver
+ * 0 runs in the calling thread and each other one in its own thread. As soon
+ * as one of them finds the answer the others are cancelled, they stop at
+ * their next conflict.
+ *    - p must be a valid non-null portfolio
+ *
+ * The model and the statistics are the ones of the solver which found the
+ * answer (see s_portfolio_winner).
+ *
+ * Returns 1 if the formula is satisfiable, 0 if it isn't and -1 on failure
+ */
+int s_portfolio_solve_assuming(s_portfolio p, const int *assumptions, size_t length);
+
+/* Same as s_portfolio_solve_assuming, but the solvers of p share the search
+ * instead of racing (cube-and-conquer)
+ *    - p must be a valid non-null portfolio
+ *
+ * The search is split into cubes, conjunctions of the assumptions and of
+ * litterals chosen by lookahead (see s_dpll_lookahead), until there are
+ * about PORTFOLIO_CUBES_PER_SOLVER cubes per solver. Each solver splits the
+ * cubes it takes, keeps one side and puts the other in its own deque, where
+ * the solvers without any cube left steal them. The search stops as soon as
+ * a cube has a model, the formula is unsatisfiable once every cube is
+ * refuted.
+ *
+ * Returns 1 if the formula is satisfiable, 0 if it isn't and -1 on failure
+ */
+int s_portfolio_conquer_assuming(s_portfolio p, const int *assumptions, size_t length);
+
+/* Returns the solver which found the answer of the last resolution of p and
+ * NULL if there is none
+ *
+ * After a cube-and-conquer its model is a model of the formula and its
+ * statistics are the ones of the last cube it solved.
+ */
+s_dpll s_portfolio_winner(s_portfolio p);
+
+/* Stores in stats the statistics of the last resolution of p
+ */
+void s_portfolio_get_stats(s_portfolio p, portfolio_stats *stats);
+
+// ==========================
+
+
+#endif
@@ -0,0 +1,126 @@
+#ifndef PREPROCESS_H
+#define PREPROCESS_H
+
+#include <stdlib.h>
+
+#include "cnf.h"
+
+
+// ===== USEFULL DEFINES =====
+
+// A variable is only eliminated when it is in at most
+// PREPROCESS_MAX_OCCURRENCES clauses and none of the resolvents replacing
+// them has more than PREPROCESS_MAX_RESOLVENT litterals, see
+// s_preprocess_create
+#define PREPROCESS_MAX_OCCURRENCES 32
+#define PREPROCESS_MAX_RESOLVENT 16
+
+// ===========================
+
+
+// ===== STRUCTS =====
+
+// Private preprocessing of a cnf formula, the simplified formula and what is
+// needed to turn its models into models of the original one
+typedef struct preprocess *s_preprocess;
+
+// Statistics of a preprocessing, see s_preprocess_create
+typedef struct preprocess_stats {
+  size_t fixed;           // Variables assigned by the propagation of the units
+  size_t subsumed;        // Clauses removed because another one subsumes them
+  size_t strengthened;    // Litterals removed by self-subsuming resolution
+  size_t eliminated;      // Variables eliminated by resolution
+  size_t resolvents;      // Clauses added in place of the eliminated ones
+  size_t vars;            // Size of the original formula
+  size_t clauses;
+  size_t litts;
+  size_t removed_clauses; // Clauses and litterals the simplified formula has
+  size_t removed_litts;   // less than the original one
+  double seconds;         // Time spent in the preprocessing
+} preprocess_stats;
+
+// ===================
+
+
+// ===== BASE FUNCTIONS =====
+
+/* Simplifies the formula cn and returns the preprocessing, which holds the
+ * simplified formula (see s_preprocess_cnf)
+ *      - cn must be a valid non-null cnf formula
+ *      - frozen must be a valid array of length variables which must stay in
+ *        the formula, the ones assumed when solving it for example (NULL if
+ *        length is 0)
+ *
+ * The simplifications, repeated until none applies :
+ *    - the unit clauses are propagated, their variables are fixed and
+ *      removed from the formula
+ *    - a clause containing every litteral of another one is removed
+ *      (subsumption), a litteral whose opposite makes another clause
+ *      subsume the clause is removed from it (self-subsuming resolution)
+ *    - a variable is eliminated by replacing the clauses containing it with
+ *      their resolvents on it when they are not more numerous (bounded
+ *      variable elimination, as in SatELite)
+ *
+ * The simplified formula is satisfiable if and only if cn is, its models are
+ * turned into models of cn by s_preprocess_extend. cn is left unchanged.
+ *
+ * Returns NULL on failure
+ */
+s_preprocess s_preprocess_create(s_cnf cn, const int *frozen, size_t length);
+
+/* Same as s_preprocess_create for the clauses of litts, one after the other
+ * and each one followed by 0
+ *      - litts must be a valid array of length litterals ending with 0 (NULL
+ *        if length is 0)
+ *
+ * Returns NULL on failure
+ */
+s_preprocess s_preprocess_create_from_clauses(const int *litts, size_t length,
+                                              const int *frozen, size_t frozen_length);
+
+void s_preprocess_free(s_preprocess pp);
+
+/* Returns the simplified formula of pp, which contains the empty clause when
+ * the original formula was found unsatisfiable
+ *
+ * The formula is built at the first call and belongs to pp, it must not be
+ * changed nor freed.
+ *
+ * Returns NULL on failure
+ */
+s_cnf s_preprocess_cnf(s_preprocess pp);
+
+/* Same as s_preprocess_cnf, as the clauses of the simplified formula one
+ * after the other and each one followed by 0, which are not copied
+ *      - length must be a valid pointer, where the number of litterals and
+ *        separators is stored
+ */
+const int *s_preprocess_clauses(s_preprocess pp, size_t *length);
+
+/* Turns a model of the simplified formula of pp into a model of the
+ * original formula
+ *      - model must be a valid array of the s_preprocess_vars(pp) litterals of
+ *        a model of the simplified formula, model[k] being k + 1 or -(k + 1)
+ *        (the variables in no clause of the simplified formula can have any
+ *        value)
+ *
+ * The values of the variables fixed or eliminated by pp are set, in place.
+ */
+void s_preprocess_extend(s_preprocess pp, int *model);
+
+/* Returns the number of variables of the original formula of pp
+ */
+size_t s_preprocess_vars(s_preprocess pp);
+
+/* Stores in stats the statistics of the preprocessing pp
+ */
+void s_preprocess_get_stats(s_preprocess pp, preprocess_stats *stats);
+
+/* Adds the statistics stats to total, the sizes of the formulas are summed
+ */
+void preprocess_stats_add(preprocess_stats *total, const preprocess_stats *stats);
+
+// ==========================
+
+
+#endif
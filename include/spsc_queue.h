@@ -0,0 +1,66 @@
+#ifndef SPSC_QUEUE_H
+#define SPSC_QUEUE_H
+
+#include <stdlib.h>
+#include <stdbool.h>
+
+
+// ===== STRUCTS =====
+
+// Private bounded lock-free queue with a single producer and a single
+// consumer
+typedef struct spsc_queue *s_spsc_queue;
+
+// ===================
+
+
+// ===== BASE FUNCTIONS =====
+
+/* Creates an empty queue that can hold capacity items and returns it
+ *    - capacity must be > 0, it is rounded up to a power of two
+ *
+ * Only one thread may push items in the queue and only one thread may pop
+ * them (it can be the same thread). Neither of them ever takes a lock.
+ *
+ * Returns NULL on failure
+ */
+s_spsc_queue s_spsc_queue_create(size_t capacity);
+
+void s_spsc_queue_free(s_spsc_queue q);
+
+/* Adds item at the end of the queue, only called by the producer
+ *    - q must be a valid non-null queue
+ *
+ * Returns false if the queue is full and true otherwise
+ */
+bool s_spsc_queue_push(s_spsc_queue q, void *item);
+
+/* Removes the first item of the queue and stores it in item, only called by
+ * the consumer
+ *    - q must be a valid non-null queue
+ *    - item must be a valid non-null pointer
+ *
+ * Returns false if the queue is empty and true otherwise
+ */
+bool s_spsc_queue_pop(s_spsc_queue q, void **item);
+
+// ==========================
+
+
+// ===== GETTERS =====
+
+/* Returns the number of items in the queue, it may already be outdated when
+ * the queue is used by other threads
+ *    - q must be a valid non-null queue
+ */
+size_t s_spsc_queue_length(s_spsc_queue q);
+
+/* Returns the number of items the queue can hold
+ *    - q must be a valid non-null queue
+ */
+size_t s_spsc_queue_capacity(s_spsc_queue q);
+
+// ===================
+
+
+#endif
@@ -13,6 +13,36 @@
  */
 #define GRID_EMPTY_CELL 0
 
+/* Text representations of a grid
+ */
+typedef enum sudoku_format {
+  SUDOKU_FORMAT_PRETTY,     // Box drawing (see s_sudoku_print)
+  SUDOKU_FORMAT_SEMICOLON,  // Format of s_sudoku_create_from_file
+  SUDOKU_FORMAT_LINE,       // Format of s_sudoku_create_from_line
+} sudoku_format;
+
+// ===========================
+
+
+// ===== CELL CHARACTERS =====
+
+/* One character per cell representation used by the line format (see
+ * s_sudoku_create_from_line) :
+ *    - '.' or '0' is an empty cell
+ *    - '1' to '9' are the values 1 to 9
+ *    - 'A' to 'Z' (or 'a' to 'z') are the values 10 to 35
+ *
+ * Returns the value of the cell or -1 if c is not a valid cell character
+ */
+int s_sudoku_char_to_value(char c);
+
+/* Returns the character representing val (see s_sudoku_char_to_value)
+ *
+ * Empty cells are represented by a '.'
+ * Returns '?' if val can't be represented by a single character
+ */
+char s_sudoku_value_to_char(size_t val);
+
 // ===========================
 
 
@@ -36,6 +66,13 @@ s_sudoku s_sudoku_create(size_t n);
 
 void s_sudoku_free(s_sudoku g);
 
+/* Returns a full copy of grid g
+ *    - g must be a non-null grid
+ *
+ * Returns NULL on failure
+ */
+s_sudoku s_sudoku_copy(s_sudoku g);
+
 // ==========================
 
 
@@ -115,10 +152,55 @@ int s_sudoku_set_cell_value(s_sudoku g, size_t i, size_t j, size_t val);
  * other than numbers it will be replaced by an empty cell in the
  * final grid.
  *
+ * The file is mapped in memory and read only once.
+ *
  * Returns NULL on failure
  */
 s_sudoku s_sudoku_create_from_file(char *filename);
 
+/* Returns a new grid created following the description given in buffer
+ * (same format as s_sudoku_create_from_file)
+ *    - buffer must be a valid array of length characters, it does not need
+ *      to be null terminated
+ *
+ * The buffer is parsed in a single pass, without any copy of it.
+ *
+ * Returns NULL on failure
+ */
+s_sudoku s_sudoku_create_from_buffer(const char *buffer, size_t length);
+
+/* Returns a new grid created from a single line description where each
+ * character is a cell, line by line (see s_sudoku_char_to_value)
+ *    - line must be a valid array of length characters
+ *    - length (without trailing blanks) must be n * n with n a perfect
+ *      square (16, 81, 256, ...)
+ *
+ *      Example of a 4*4 grid (same as the one of s_sudoku_create_from_file) :
+ *
+ *      .12....1.3.2.2..
+ *
+ * Returns NULL on failure
+ */
+s_sudoku s_sudoku_create_from_line(const char *line, size_t length);
+
+/* Returns the maximum number of bytes needed to render a grid of size n in
+ * the given format (see s_sudoku_render)
+ */
+size_t s_sudoku_render_size(size_t n, sudoku_format format);
+
+/* Renders grid g in the given format in buffer, in a single pass
+ *    - g must be a non-null grid
+ *    - buffer must be a valid array of size bytes
+ *    - size must be >= s_sudoku_render_size(n, format) (n the size of g)
+ *
+ * Every line of the rendered grid (including the last one) ends with a new
+ * line. The buffer is not null terminated.
+ *
+ * Returns the number of bytes written in buffer and 0 on failure
+ */
+size_t s_sudoku_render(s_sudoku g, sudoku_format format, char *buffer,
+                       size_t size);
+
 /* Prints a pretty grid to file with the
  * numbers and size of grid g
  *    - file must be a valid file
@@ -1,8 +1,37 @@
 #ifndef SUDOKU_CNF_H
 #define SUDOKU_CNF_H
 
+#include <stdio.h>
+#include <stdbool.h>
+
 #include "sudoku.h"
 #include "cnf.h"
+#include "dpll.h"
+#include "count.h"
+#include "preprocess.h"
+
+// ===== STRUCTS =====
+
+// Private solver keeping the state that can be reused from a grid to another
+typedef struct sudoku_solver *s_sudoku_solver;
+
+// Called with each solution found by s_sudoku_solver_enumerate, returns 0 to
+// go on and another value to stop the enumeration
+typedef int (*sudoku_solution_callback)(s_sudoku solution, void *ctx);
+
+// Statistics of the grids solved by a solver, see s_sudoku_solver_get_stats
+typedef struct sudoku_stats {
+  size_t grids;           // Grids solved
+  size_t solvable;        // Grids that can be solved
+  double encode_seconds;  // Time spent reducing the grids to formulas
+  double solve_seconds;   // Time spent solving the formulas
+  dpll_stats dpll;        // Statistics of the resolutions (see dpll_stats_add)
+  preprocess_stats preprocess;  // Simplifications of the formulas, see
+                                // s_sudoku_solver_set_preprocess (their time
+                                // is not in encode_seconds)
+} sudoku_stats;
+
+// ===================
 
 // ===== SAT VARIABLES =====
 
@@ -52,7 +81,185 @@ sat_var litt_to_sat_var(s_sudoku g, int litt);
  */
 s_cnf sudoku_to_cnf(s_sudoku g);
 
+/* Sets the values of the cells of g according to the valuations of a
+ * solution of the formula of g (see dpll_valuations)
+ *      - g must be a valid grid
+ *      - valuations must be a valid array of length litterals, only the
+ *        positive ones are used
+ */
+void sudoku_apply_valuations(s_sudoku g, int *valuations, size_t length);
+
+/* Stores in litts the litterals of the default conditions of g (the values
+ * of its non empty cells), to solve g with the rules of its size and these
+ * litterals as assumptions (see s_sudoku_solver_solve_assuming)
+ *      - g must be a valid grid
+ *      - litts must be a valid array of n * n litterals (n the size of g)
+ *
+ * Returns the number of litterals stored
+ */
+size_t sudoku_to_assumptions(s_sudoku g, int *litts);
+
+/* Keeps the rules of sudoku encoded for each size of grid in files of the
+ * directory, read by the solvers instead of encoding the rules again and
+ * written when missing. NULL only keeps the rules in the memory of each
+ * solver (the default).
+ *      - directory must be NULL or an existing directory
+ *
+ * It must be called before the solvers are used by other threads.
+ *
+ * Returns 0 on success and -1 on failure
+ */
+int sudoku_set_rules_cache(const char *directory);
+
+/* Solves grid g in place by reducing it to a sat formula (see sudoku_to_cnf)
+ * and solving this formula with a sat solver (see s_dpll_solve)
+ *      - g must be a valid grid
+ *
+ * If the grid can be solved, g contains the solution on return, otherwise
+ * it is left unchanged.
+ *
+ * Returns 1 if the grid can be solved, 0 if it can't and -1 on failure
+ */
+int sudoku_solve(s_sudoku g);
+
 // ==========================
 
+// ===== SOLVER =====
+
+/* Creates a solver for grids of any size and returns it
+ *
+ * A solver keeps what does not depend on the grid itself (for example the
+ * encoding of the rules of sudoku for each size of grid it has seen) so
+ * solving many grids with the same solver is faster than with sudoku_solve.
+ *
+ * A solver must only be used by one thread at a time.
+ *
+ * Returns NULL on failure
+ */
+s_sudoku_solver s_sudoku_solver_create();
+
+/* Same as s_sudoku_solver_create, but each grid is solved by a portfolio of
+ * solvers sat solvers in their own threads (see portfolio.h)
+ *      - solvers must be > 0
+ *
+ * The solvers race by default: the first one to find the answer cancels the
+ * others, so the time of a hard grid is the one of the luckiest
+ * configuration. With conquer they share the search of each grid instead,
+ * split into cubes (see s_portfolio_conquer_assuming), which suits the grids
+ * hard for every configuration. Either way it costs a core per solver.
+ * Counts and enumerations only use the first solver.
+ *
+ * Returns NULL on failure
+ */
+s_sudoku_solver s_sudoku_solver_create_portfolio(size_t solvers, bool conquer);
+
+void s_sudoku_solver_free(s_sudoku_solver sv);
+
+/* Sets whether the solver sv simplifies the formula of each grid before
+ * solving it (off by default)
+ *      - sv must be a valid non-null solver
+ *
+ * The rules and the values of the cells of the grid are simplified together
+ * (see preprocess.h): the variables of the cells with a value and the rules
+ * they satisfy are removed, the rules left are shortened, and the simplified
+ * formula is solved instead of the rules under assumptions. The rules are
+ * then loaded again by the next grid solved without preprocessing. Counts
+ * and enumerations are not preprocessed.
+ */
+void s_sudoku_solver_set_preprocess(s_sudoku_solver sv, bool preprocess);
+
+/* Same as sudoku_to_cnf but using the state kept by the solver sv, the
+ * returned formula must be freed by the user
+ *      - sv must be a valid non-null solver
+ *      - g must be a valid grid
+ *
+ * Returns NULL on failure
+ */
+s_cnf s_sudoku_solver_encode(s_sudoku_solver sv, s_sudoku g);
+
+/* Same as sudoku_solve but using the state kept by the solver sv: the rules
+ * of each size are encoded once and stay loaded in its sat solver, the values
+ * of the cells of g are given as assumptions (see sudoku_to_assumptions). A
+ * grid of the size of the previous one is solved without encoding the rules
+ * or allocating.
+ *      - sv must be a valid non-null solver
+ *      - g must be a valid grid
+ *
+ * Returns 1 if the grid can be solved, 0 if it can't and -1 on failure
+ */
+int s_sudoku_solver_solve(s_sudoku_solver sv, s_sudoku g);
+
+/* Same as s_sudoku_solver_solve with the assumptions already computed
+ *      - sv must be a valid non-null solver
+ *      - g must be a valid grid
+ *      - assumptions must be a valid array of the length litterals given by
+ *        sudoku_to_assumptions for g
+ *
+ * Returns 1 if the grid can be solved, 0 if it can't and -1 on failure
+ */
+int s_sudoku_solver_solve_assuming(s_sudoku_solver sv, s_sudoku g, const int *assumptions,
+                                   size_t length);
+
+/* Counts the solutions of grid g with the solver sv (see
+ * s_sudoku_solver_solve), stopping at limit solutions: a limit of 2 tells
+ * whether the solution of g is unique at about the cost of solving it
+ *      - sv must be a valid non-null solver
+ *      - g must be a valid grid
+ *      - limit must be > 0
+ *
+ * g is left unchanged.
+ *
+ * Returns the number of solutions found, at most limit, and -1 on failure
+ */
+long s_sudoku_solver_count(s_sudoku_solver sv, s_sudoku g, size_t limit);
+
+/* Counts every solution of grid g exactly, with the formula of the rules of
+ * the solver sv and a unit clause per non empty cell (see count_models)
+ *      - sv must be a valid non-null solver
+ *      - g must be a valid grid
+ *      - count must be a valid pointer
+ *
+ * The solutions are never enumerated, so grids with millions of solutions
+ * can be counted when their cells split into independent parts during the
+ * search. g is left unchanged.
+ *
+ * Returns 0 on success and -1 on failure
+ */
+int s_sudoku_solver_count_all(s_sudoku_solver sv, s_sudoku g, count_number *count);
+
+/* Calls callback with each solution of grid g as soon as it is found by the
+ * solver sv (see s_dpll_enumerate_assuming), until every solution is found
+ * or callback returns a non zero value
+ *      - sv must be a valid non-null solver
+ *      - g must be a valid grid
+ *      - callback must be a valid function, the grid it is given is only
+ *        valid during the call
+ *
+ * g is left unchanged and the memory used does not grow with the number of
+ * solutions.
+ *
+ * Returns the number of solutions given to callback and -1 on failure
+ */
+long s_sudoku_solver_enumerate(s_sudoku_solver sv, s_sudoku g,
+                               sudoku_solution_callback callback, void *ctx);
+
+/* Stores in stats the statistics of every grid solved by sv since its
+ * creation
+ *      - sv must be a valid non-null solver
+ *      - stats must be a valid non-null pointer
+ */
+void s_sudoku_solver_get_stats(s_sudoku_solver sv, sudoku_stats *stats);
+
+/* Adds the statistics stats to total (see dpll_stats_add)
+ */
+void sudoku_stats_add(sudoku_stats *total, const sudoku_stats *stats);
+
+/* Prints stats as a JSON object to file, with the peak resident memory of
+ * the process and the allocations counted by the library (see alloc.h)
+ */
+void sudoku_stats_print(FILE *file, const sudoku_stats *stats);
+
+// ==================
+
 
 #endif
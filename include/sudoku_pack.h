@@ -0,0 +1,124 @@
+#ifndef SUDOKU_PACK_H
+#define SUDOKU_PACK_H
+
+#include <stdlib.h>
+
+#include "sudoku.h"
+
+
+// ===== FILE FORMAT =====
+
+/* A pack file is a compact binary container of grids of the same size.
+ *
+ * It starts with a fixed header of SUDOKU_PACK_HEADER_SIZE bytes (integers
+ * are little endian) :
+ *
+ *    offset  size  content
+ *         0     4  magic "SDKP"
+ *         4     2  version (SUDOKU_PACK_VERSION)
+ *         6     2  size n of the grids
+ *         8     1  number of bits per cell
+ *         9     3  reserved (0)
+ *        12     4  size in bytes of a record
+ *        16     8  number of grids
+ *        24     8  reserved (0)
+ *
+ * It is followed by one fixed size record per grid. A record contains the
+ * n * n cells of the grid, line by line, each stored on the smallest number
+ * of bits able to represent the values 0 to n (4 bits for a 9 * 9 grid).
+ * The first cell is on the lowest bits of the first byte.
+ *
+ * Since records have a fixed size, grid k is found directly at offset
+ * SUDOKU_PACK_HEADER_SIZE + k * record size without parsing anything.
+ */
+
+#define SUDOKU_PACK_HEADER_SIZE 32
+#define SUDOKU_PACK_VERSION 1
+
+// =======================
+
+
+// ===== STRUCTS =====
+
+// Private read only pack file
+typedef struct sudoku_pack *s_sudoku_pack;
+
+// Private pack file being written
+typedef struct sudoku_pack_writer *s_sudoku_pack_writer;
+
+// ===================
+
+
+// ===== READER =====
+
+/* Opens the pack file filename and maps it in memory
+ *    - filename must be non-null and represent a valid pack file
+ *
+ * Returns NULL on failure
+ */
+s_sudoku_pack s_sudoku_pack_open(char *filename);
+
+void s_sudoku_pack_close(s_sudoku_pack pk);
+
+/* Returns the size n of the grids of the pack
+ *    - pk must be a valid non-null pack
+ *
+ * Returns 0 on failure
+ */
+size_t s_sudoku_pack_size(s_sudoku_pack pk);
+
+/* Returns the number of grids in the pack
+ *    - pk must be a valid non-null pack
+ *
+ * Returns 0 on failure
+ */
+size_t s_sudoku_pack_count(s_sudoku_pack pk);
+
+/* Returns a new grid with the content of the grid at index in the pack
+ *    - pk must be a valid non-null pack
+ *    - 0 <= index < count (count the number of grids in pk)
+ *
+ * Returns NULL on failure
+ */
+s_sudoku s_sudoku_pack_get(s_sudoku_pack pk, size_t index);
+
+/* Same as s_sudoku_pack_get but overwrites the cells of the existing grid g
+ * instead of allocating a new one
+ *    - g must be a non-null grid of the same size as the grids of the pack
+ *
+ * Returns 0 on success and -1 on failure
+ */
+int s_sudoku_pack_load(s_sudoku_pack pk, size_t index, s_sudoku g);
+
+// ==================
+
+
+// ===== WRITER =====
+
+/* Creates (or truncates) the pack file filename for grids of size n
+ *    - filename must be non-null
+ *    - n must be a valid grid size (see s_sudoku_create)
+ *
+ * Returns NULL on failure
+ */
+s_sudoku_pack_writer s_sudoku_pack_writer_create(char *filename, size_t n);
+
+/* Appends grid g at the end of the pack
+ *    - w must be a valid non-null writer
+ *    - g must be a non-null grid of the size given to the writer
+ *
+ * Returns 0 on success and -1 on failure
+ */
+int s_sudoku_pack_writer_add(s_sudoku_pack_writer w, s_sudoku g);
+
+/* Writes the final header of the pack, closes the file and frees the writer
+ *    - w must be a valid non-null writer
+ *
+ * Returns 0 on success and -1 on failure
+ */
+int s_sudoku_pack_writer_close(s_sudoku_pack_writer w);
+
+// ==================
+
+
+#endif
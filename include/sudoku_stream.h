@@ -0,0 +1,74 @@
+#ifndef SUDOKU_STREAM_H
+#define SUDOKU_STREAM_H
+
+#include <stdio.h>
+#include <stdbool.h>
+
+#include "sudoku.h"
+
+
+// ===== STRUCTS =====
+
+// Private stream of grids
+typedef struct sudoku_stream *s_sudoku_stream;
+
+// ===================
+
+
+// ===== BASE FUNCTIONS =====
+
+/* Creates a stream reading grids one after the other from file
+ *    - file must be a valid file opened for reading
+ *
+ * The stream does not own file, it must be closed by the user after
+ * s_sudoku_stream_free.
+ *
+ * The file may contain any number of grids, in any of the following
+ * formats (they can be mixed) :
+ *    - The semicolon format of s_sudoku_create_from_file, the size n of the
+ *      grid is given by its first line and the n - 1 following lines are
+ *      the rest of the grid
+ *    - The line format of s_sudoku_create_from_line, one grid per line (for
+ *      example the usual 81 characters strings with '.' or '0' for empty
+ *      cells)
+ *
+ * Empty lines and lines starting with '#' between grids are ignored.
+ *
+ * Only one grid is held in memory at a time so the memory used by the
+ * stream does not depend on the number of grids in the file.
+ *
+ * Returns NULL on failure
+ */
+s_sudoku_stream s_sudoku_stream_create(FILE *file);
+
+void s_sudoku_stream_free(s_sudoku_stream st);
+
+/* Returns the next grid of the stream, the grid must be freed by the user
+ *    - st must be a valid non-null stream
+ *
+ * Returns NULL at the end of the stream or if the next grid is invalid. An
+ * invalid grid is skipped so the next call returns the grid following it.
+ * Use s_sudoku_stream_eof to tell those two cases apart.
+ */
+s_sudoku s_sudoku_stream_next(s_sudoku_stream st);
+
+// ==========================
+
+
+// ===== GETTERS =====
+
+/* Returns whether the end of the stream was reached
+ *    - st must be a valid non-null stream
+ */
+bool s_sudoku_stream_eof(s_sudoku_stream st);
+
+/* Returns the line of the file where the last grid returned (or rejected)
+ * by s_sudoku_stream_next starts (the first line is 1)
+ *    - st must be a valid non-null stream
+ */
+size_t s_sudoku_stream_line(s_sudoku_stream st);
+
+// ===================
+
+
+#endif
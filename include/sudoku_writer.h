@@ -0,0 +1,75 @@
+#ifndef SUDOKU_WRITER_H
+#define SUDOKU_WRITER_H
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "sudoku.h"
+
+
+// ===== USEFULL DEFINES =====
+
+// Default capacity of the buffer of a writer
+#define SUDOKU_WRITER_CAPACITY (1 << 20)
+
+// ===========================
+
+
+// ===== STRUCTS =====
+
+// Private buffered grid writer
+typedef struct sudoku_writer *s_sudoku_writer;
+
+// ===================
+
+
+// ===== BASE FUNCTIONS =====
+
+/* Creates a writer that renders grids in a buffer of capacity bytes and
+ * writes them to file in large blocks
+ *    - file must be a valid file opened for writing
+ *    - capacity must be > 0 (SUDOKU_WRITER_CAPACITY is a good default)
+ *
+ * The writer does not own file, it must be closed by the user after
+ * s_sudoku_writer_free.
+ *
+ * Returns NULL on failure
+ */
+s_sudoku_writer s_sudoku_writer_create(FILE *file, size_t capacity);
+
+/* Flushes the writer and frees it
+ */
+void s_sudoku_writer_free(s_sudoku_writer w);
+
+/* Renders grid g in the given format at the end of the buffer of the writer
+ * (see s_sudoku_render)
+ *    - w must be a valid non-null writer
+ *    - g must be a non-null grid
+ *
+ * The buffer is written to the file only when it is full so nothing is
+ * written to it by most calls.
+ *
+ * Returns 0 on success and -1 on failure
+ */
+int s_sudoku_writer_write(s_sudoku_writer w, s_sudoku g, sudoku_format format);
+
+/* Appends the length bytes of str at the end of the buffer of the writer
+ *    - w must be a valid non-null writer
+ *    - str must be a valid array of length bytes
+ *
+ * Returns 0 on success and -1 on failure
+ */
+int s_sudoku_writer_write_string(s_sudoku_writer w, const char *str,
+                                 size_t length);
+
+/* Writes everything that is in the buffer of the writer to its file
+ *    - w must be a valid non-null writer
+ *
+ * Returns 0 on success and -1 on failure
+ */
+int s_sudoku_writer_flush(s_sudoku_writer w);
+
+// ==========================
+
+
+#endif
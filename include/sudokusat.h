@@ -0,0 +1,58 @@
+#ifndef SUDOKUSAT_H
+#define SUDOKUSAT_H
+
+#include <stdlib.h>
+
+#include "sudoku.h"
+#include "sudoku_cnf.h"
+
+
+/* Public API of the sudokusat library (libsudokusat.a and libsudokusat.so),
+ * to solve grids from memory in the calling process. These functions never
+ * read or write a file and never print anything.
+ *
+ * Every function takes a solver sv (see s_sudoku_solver_create) which keeps
+ * the encoding of the rules between calls, or NULL to use a temporary one.
+ * A solver must only be used by one thread at a time, use one solver per
+ * thread to solve grids in parallel.
+ */
+
+
+// ===== BASE FUNCTIONS =====
+
+/* Solves the grid of size n given by its n * n cells, line by line (0 for
+ * an empty cell), and stores the cells of its solution in solution
+ *    - sv must be a valid solver or NULL
+ *    - cells must be a valid array of n * n values in [0, n]
+ *    - n must be a perfect square (4, 9, 16, ...)
+ *    - solution must be a valid array of n * n values, it may be cells
+ *
+ * solution is left unchanged when the grid has no solution.
+ *
+ * Returns 1 if the grid is solved, 0 if it has no solution and -1 on
+ * failure (invalid grid or parameters)
+ */
+int sudokusat_solve_cells(s_sudoku_solver sv, const int *cells, size_t n, int *solution);
+
+/* Solves the grid described by grid and renders its solution in buffer in
+ * the given format (see s_sudoku_render), followed by a null character
+ *    - sv must be a valid solver or NULL
+ *    - grid must be a valid array of length characters, in the line format
+ *      (see s_sudoku_create_from_line) or the semicolon one (see
+ *      s_sudoku_create_from_buffer) when it contains a ';'
+ *    - buffer must be a valid array of size bytes
+ *    - size must be > s_sudoku_render_size(n, format) (n the size of the
+ *      grid)
+ *
+ * buffer is left unchanged when the grid has no solution.
+ *
+ * Returns the length of the rendered solution when the grid is solved, 0 if
+ * it has no solution and -1 on failure (invalid grid, buffer too small)
+ */
+long sudokusat_solve_string(s_sudoku_solver sv, const char *grid, size_t length,
+                            sudoku_format format, char *buffer, size_t size);
+
+// ==========================
+
+
+#endif
@@ -0,0 +1,74 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdbool.h>
+
+
+// ===== USEFULL DEFINES =====
+
+// Maximum number of events recorded by a trace, the following ones are
+// dropped so a long solve can't exhaust the memory
+#define TRACE_MAX_EVENTS (1 << 22)
+
+/* Tracing macros, they record events in the trace started by trace_start.
+ *
+ * They are compiled out unless SUDOKUSAT_TRACE is defined (cmake
+ * -DSUDOKUSAT_TRACE=ON) so they cost nothing in a normal build. When compiled
+ * in, they only cost a load until a trace is started, then a few atomic
+ * increments: the threads never wait for each other to record events.
+ *
+ *    - category and name must be string literals (they are not copied)
+ *
+ * TRACE_BEGIN and TRACE_END delimit a span and must be nested on each
+ * thread, TRACE_INSTANT records an event without duration.
+ */
+#ifdef SUDOKUSAT_TRACE
+#define TRACE_BEGIN(category, name) trace_event(category, name, 'B')
+#define TRACE_END(category, name) trace_event(category, name, 'E')
+#define TRACE_INSTANT(category, name) trace_event(category, name, 'i')
+#else
+#define TRACE_BEGIN(category, name) ((void) 0)
+#define TRACE_END(category, name) ((void) 0)
+#define TRACE_INSTANT(category, name) ((void) 0)
+#endif
+
+// ===========================
+
+
+// ===== BASE FUNCTIONS =====
+
+/* Starts recording the events of every thread, they are written to filename
+ * by trace_stop
+ *    - filename must be a valid path to a writable file
+ *
+ * Returns 0 on success and -1 on failure, when a trace is already started or
+ * when the tracing is compiled out
+ */
+int trace_start(const char *filename);
+
+/* Stops the trace and writes its events to its file in the Chrome trace
+ * event format (JSON), which can be opened in chrome://tracing or Perfetto.
+ * No thread may record events while the trace is stopped.
+ *
+ * Returns 0 on success and -1 on failure or when no trace is started
+ */
+int trace_stop();
+
+/* Records an event of the given phase ('B' begin, 'E' end or 'i' instant)
+ * in the current trace, use the TRACE_ macros instead
+ */
+void trace_event(const char *category, const char *name, char phase);
+
+// ==========================
+
+
+// ===== GETTERS =====
+
+/* Returns whether the tracing is compiled in
+ */
+bool trace_available();
+
+// ===================
+
+
+#endif
@@ -0,0 +1,47 @@
+#ifndef UTIL_H
+#define UTIL_H
+
+#include <stdlib.h>
+
+#include "alloc.h"
+
+/* Helpers shared by the modules of the library, they are not part of its
+ * interface (see sudokusat.h)
+ */
+
+
+// ===== BASE FUNCTIONS =====
+
+/* Returns the time in seconds of a monotonic clock, only meaningful as the
+ * difference of two calls
+ */
+double util_now();
+
+/* Returns the index of litt in the arrays indexed by litteral, 2 * var for
+ * var and 2 * var + 1 for -var (0 and 1 are unused)
+ *
+ * Inlined, it is called by the propagation of the solver for each watch.
+ */
+static inline size_t util_litt_index(int litt) {
+  return 2 * (size_t) abs(litt) + (litt < 0);
+}
+
+/* Compares the ints pointed by a and b, for qsort
+ */
+int util_compare_ints(const void *a, const void *b);
+
+/* Grows the array *ptr of *capacity items of size bytes to hold at least
+ * length items, allocated for subsystem (see alloc.h)
+ *
+ * The capacity is doubled as many times as needed, so that adding the items
+ * one by one takes amortized constant time.
+ *
+ * Returns 0 on success and -1 on failure (*ptr is left unchanged)
+ */
+int util_grow(alloc_subsystem subsystem, void **ptr, size_t *capacity, size_t length,
+              size_t size);
+
+// ==========================
+
+
+#endif
@@ -0,0 +1,166 @@
+#include <stdlib.h>
+#include <stdbool.h>
+
+#include <malloc.h>
+
+#include "alloc.h"
+
+
+// ===== PRIVATE =====
+
+void *alloc_libc_malloc(void *ctx, size_t size) {
+  return malloc(size);
+}
+
+void *alloc_libc_calloc(void *ctx, size_t count, size_t size) {
+  return calloc(count, size);
+}
+
+void *alloc_libc_realloc(void *ctx, void *ptr, size_t size) {
+  return realloc(ptr, size);
+}
+
+void alloc_libc_free(void *ctx, void *ptr) {
+  free(ptr);
+}
+
+size_t alloc_libc_size(void *ctx, void *ptr) {
+  return malloc_usable_size(ptr);
+}
+
+static const alloc_allocator alloc_libc = {
+  alloc_libc_malloc, alloc_libc_calloc, alloc_libc_realloc, alloc_libc_free,
+  alloc_libc_size, NULL
+};
+
+static alloc_allocator alloc_current = {
+  alloc_libc_malloc, alloc_libc_calloc, alloc_libc_realloc, alloc_libc_free,
+  alloc_libc_size, NULL
+};
+
+// The counters are updated with relaxed atomics, they are only read once
+// the work to measure is done
+static bool alloc_counting = false;
+
+static size_t alloc_allocations[ALLOC_SUBSYSTEMS];
+static size_t alloc_bytes[ALLOC_SUBSYSTEMS];
+static size_t alloc_frees = 0;
+static size_t alloc_live_bytes = 0;
+static size_t alloc_peak_bytes = 0;
+
+size_t alloc_block_size(void *ptr) {
+  if (!ptr || !alloc_current.size) return 0;
+  return alloc_current.size(alloc_current.ctx, ptr);
+}
+
+/* Counts an allocation of size bytes for subsystem, which changed the usable
+ * bytes of a block from old_size to new_size
+ */
+void alloc_count(alloc_subsystem subsystem, size_t size, size_t old_size, size_t new_size) {
+  __atomic_fetch_add(&alloc_allocations[subsystem], 1, __ATOMIC_RELAXED);
+  __atomic_fetch_add(&alloc_bytes[subsystem], size, __ATOMIC_RELAXED);
+
+  size_t live = __atomic_add_fetch(&alloc_live_bytes, new_size - old_size, __ATOMIC_RELAXED);
+
+  size_t peak = __atomic_load_n(&alloc_peak_bytes, __ATOMIC_RELAXED);
+  while (live > peak && live < (size_t) 1 << 62
+         && !__atomic_compare_exchange_n(&alloc_peak_bytes, &peak, live, true,
+                                         __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+}
+
+// ===================
+
+
+// ===== BASE FUNCTIONS =====
+
+void alloc_set_allocator(const alloc_allocator *allocator) {
+  alloc_current = allocator ? *allocator : alloc_libc;
+}
+
+void alloc_set_counting(bool counting) {
+  __atomic_store_n(&alloc_counting, counting, __ATOMIC_RELAXED);
+}
+
+void alloc_reset_stats() {
+  for (size_t k = 0; k < ALLOC_SUBSYSTEMS; k++) {
+    __atomic_store_n(&alloc_allocations[k], 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&alloc_bytes[k], 0, __ATOMIC_RELAXED);
+  }
+  __atomic_store_n(&alloc_frees, 0, __ATOMIC_RELAXED);
+  __atomic_store_n(&alloc_live_bytes, 0, __ATOMIC_RELAXED);
+  __atomic_store_n(&alloc_peak_bytes, 0, __ATOMIC_RELAXED);
+}
+
+void *alloc_malloc(alloc_subsystem subsystem, size_t size) {
+  void *ptr = alloc_current.malloc(alloc_current.ctx, size);
+
+  if (ptr && __atomic_load_n(&alloc_counting, __ATOMIC_RELAXED))
+    alloc_count(subsystem, size, 0, alloc_block_size(ptr));
+  return ptr;
+}
+
+void *alloc_calloc(alloc_subsystem subsystem, size_t count, size_t size) {
+  void *ptr = alloc_current.calloc(alloc_current.ctx, count, size);
+
+  if (ptr && __atomic_load_n(&alloc_counting, __ATOMIC_RELAXED))
+    alloc_count(subsystem, count * size, 0, alloc_block_size(ptr));
+  return ptr;
+}
+
+void *alloc_realloc(alloc_subsystem subsystem, void *ptr, size_t size) {
+  if (!__atomic_load_n(&alloc_counting, __ATOMIC_RELAXED))
+    return alloc_current.realloc(alloc_current.ctx, ptr, size);
+
+  size_t old_size = alloc_block_size(ptr);
+  void *new_ptr = alloc_current.realloc(alloc_current.ctx, ptr, size);
+  if (new_ptr) alloc_count(subsystem, size, old_size, alloc_block_size(new_ptr));
+  return new_ptr;
+}
+
+void alloc_free(void *ptr) {
+  if (!ptr) return;
+
+  if (__atomic_load_n(&alloc_counting, __ATOMIC_RELAXED)) {
+    __atomic_fetch_add(&alloc_frees, 1, __ATOMIC_RELAXED);
+    __atomic_fetch_sub(&alloc_live_bytes, alloc_block_size(ptr), __ATOMIC_RELAXED);
+  }
+
+  alloc_current.free(alloc_current.ctx, ptr);
+}
+
+// ==========================
+
+
+// ===== GETTERS =====
+
+void alloc_get_stats(alloc_subsystem subsystem, alloc_stats *stats) {
+  stats->allocations = __atomic_load_n(&alloc_allocations[subsystem], __ATOMIC_RELAXED);
+  stats->bytes = __atomic_load_n(&alloc_bytes[subsystem], __ATOMIC_RELAXED);
+  stats->frees = 0;
+  stats->live_bytes = 0;
+  stats->peak_bytes = 0;
+}
+
+void alloc_get_total(alloc_stats *stats) {
+  stats->allocations = 0;
+  stats->bytes = 0;
+  for (size_t k = 0; k < ALLOC_SUBSYSTEMS; k++) {
+    stats->allocations += __atomic_load_n(&alloc_allocations[k], __ATOMIC_RELAXED);
+    stats->bytes += __atomic_load_n(&alloc_bytes[k], __ATOMIC_RELAXED);
+  }
+
+  // The live bytes wrap below 0 when blocks allocated before
+  // alloc_reset_stats are freed
+  size_t live = __atomic_load_n(&alloc_live_bytes, __ATOMIC_RELAXED);
+  stats->frees = __atomic_load_n(&alloc_frees, __ATOMIC_RELAXED);
+  stats->live_bytes = live < (size_t) 1 << 62 ? live : 0;
+  stats->peak_bytes = __atomic_load_n(&alloc_peak_bytes, __ATOMIC_RELAXED);
+}
+
+const char *alloc_subsystem_name(alloc_subsystem subsystem) {
+  const char *names[] = {"sudoku", "cnf", "dpll", "encode", "runtime", "count",
+                         "preprocess"};
+  return subsystem < ALLOC_SUBSYSTEMS ? names[subsystem] : "unknown";
+}
+
+// ===================
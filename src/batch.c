@@ -0,0 +1,313 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+
+#include "sudoku.h"
+#include "sudoku_stream.h"
+#include "sudoku_writer.h"
+#include "sudoku_cnf.h"
+#include "count.h"
+#include "batch.h"
+#include "alloc.h"
+
+
+// ===== STRUCTS =====
+
+// A grid in flight
+struct batch_job {
+  s_sudoku initial;   // Grid as read from the input
+  s_sudoku solution;  // Grid being solved by a worker
+  int solved;         // Result of s_sudoku_solver_solve
+  count_number count; // Solutions of the grid when counting
+  bool done;
+};
+
+// Jobs are stored in a ring buffer indexed by their position in the input
+struct batch {
+  pthread_mutex_t lock;
+  pthread_cond_t work;  // Signaled when a job is added or the input ends
+  pthread_cond_t done;  // Signaled when a job is done
+
+  struct batch_job *jobs;
+  size_t capacity;
+
+  size_t head;      // Next job to write
+  size_t next;      // Next job to solve
+  size_t tail;      // Next job to read
+  bool input_ended;
+
+  bool count;           // The solutions are counted, see batch_options
+  size_t portfolio;
+  bool conquer;
+  bool preprocess;
+  sudoku_stats *stats;  // Statistics of the workers, NULL if not needed
+};
+
+// ===================
+
+
+// ===== PRIVATE =====
+
+/* Worker thread, solves jobs until the end of the input
+ */
+void *batch_worker(void *arg) {
+  struct batch *b = arg;
+
+  // Each worker has its own solver, kept from a grid to the next
+  s_sudoku_solver sv = b->portfolio > 1
+                       ? s_sudoku_solver_create_portfolio(b->portfolio, b->conquer)
+                       : s_sudoku_solver_create();
+  if (sv) s_sudoku_solver_set_preprocess(sv, b->preprocess);
+
+  pthread_mutex_lock(&b->lock);
+
+  while (true) {
+    while (b->next == b->tail && !b->input_ended)
+      pthread_cond_wait(&b->work, &b->lock);
+
+    if (b->next == b->tail) break; // Nothing left to solve
+
+    struct batch_job *job = &b->jobs[b->next++ % b->capacity];
+
+    pthread_mutex_unlock(&b->lock);
+    if (!sv)
+      job->solved = -1;
+    else if (b->count)
+      job->solved = s_sudoku_solver_count_all(sv, job->solution, &job->count);
+    else
+      job->solved = s_sudoku_solver_solve(sv, job->solution);
+    pthread_mutex_lock(&b->lock);
+
+    job->done = true;
+    pthread_cond_broadcast(&b->done);
+  }
+
+  if (sv && b->stats) {
+    sudoku_stats stats;
+    s_sudoku_solver_get_stats(sv, &stats);
+    sudoku_stats_add(b->stats, &stats);
+  }
+
+  pthread_mutex_unlock(&b->lock);
+
+  if (sv) s_sudoku_solver_free(sv);
+  return NULL;
+}
+
+/* Waits for the oldest job to be solved, writes its result and removes it
+ *
+ * Returns 0 on success and -1 on failure
+ */
+int batch_write_oldest(struct batch *b, s_sudoku_writer w, sudoku_format format) {
+  struct batch_job *job = &b->jobs[b->head % b->capacity];
+
+  pthread_mutex_lock(&b->lock);
+  while (!job->done) pthread_cond_wait(&b->done, &b->lock);
+  pthread_mutex_unlock(&b->lock);
+
+  int r = job->solved == -1 ? -1 : 0;
+
+  if (b->count && r == 0) {
+    char line[COUNT_DIGITS + 2];
+    size_t length = count_render(job->count, line, sizeof(line));
+    line[length++] = '\n';
+    r = s_sudoku_writer_write_string(w, line, length);
+  } else if (r == 0) {
+    // Grids of the pretty and semicolon formats are separated by an empty line
+    if (b->head > 0 && format != SUDOKU_FORMAT_LINE)
+      r = s_sudoku_writer_write_string(w, "\n", 1);
+
+    if (r == 0)
+      r = batch_write_result(w, job->initial, job->solution, job->solved, format);
+  }
+
+  s_sudoku_free(job->initial);
+  s_sudoku_free(job->solution);
+
+  // Only the reading thread moves head so the worker don't need to know
+  b->head++;
+  return r;
+}
+
+/* Reads every grid of filename and adds them to the jobs, writing the
+ * results of the oldest jobs when there is no room left
+ *
+ * Returns the number of grids read and -1 on failure
+ */
+long batch_read_file(struct batch *b, char *filename, s_sudoku_writer w,
+                     sudoku_format format, bool *invalid) {
+  bool use_stdin = strcmp(filename, "-") == 0;
+
+  FILE *file = use_stdin ? stdin : fopen(filename, "r");
+  if (!file) {
+    fprintf(stderr, "%s: can't open file\n", filename);
+    return -1;
+  }
+
+  s_sudoku_stream st = s_sudoku_stream_create(file);
+  if (!st) {
+    if (!use_stdin) fclose(file);
+    return -1;
+  }
+
+  long count = 0;
+
+  while (!s_sudoku_stream_eof(st)) {
+    s_sudoku g = s_sudoku_stream_next(st);
+    if (!g) {
+      if (!s_sudoku_stream_eof(st)) {
+        fprintf(stderr, "%s:%zu: invalid grid\n", filename, s_sudoku_stream_line(st));
+        *invalid = true;
+      }
+      continue;
+    }
+
+    s_sudoku solution = s_sudoku_copy(g);
+    if (!solution) {
+      s_sudoku_free(g);
+      count = -1;
+      break;
+    }
+
+    // Make room for the new job
+    if (b->tail - b->head == b->capacity && batch_write_oldest(b, w, format) == -1) {
+      s_sudoku_free(g);
+      s_sudoku_free(solution);
+      count = -1;
+      break;
+    }
+
+    pthread_mutex_lock(&b->lock);
+    struct batch_job *job = &b->jobs[b->tail % b->capacity];
+    job->initial = g;
+    job->solution = solution;
+    job->done = false;
+    b->tail++;
+    pthread_cond_signal(&b->work);
+    pthread_mutex_unlock(&b->lock);
+
+    count++;
+  }
+
+  s_sudoku_stream_free(st);
+  if (!use_stdin) fclose(file);
+  return count;
+}
+
+// ===================
+
+
+// ===== BASE FUNCTIONS =====
+
+int batch_write_result(s_sudoku_writer w, s_sudoku initial, s_sudoku solution,
+                       int solved, sudoku_format format) {
+  if (format == SUDOKU_FORMAT_PRETTY) {
+    char line[32];
+    int length = snprintf(line, sizeof(line), "Can be solved ? : %d\n", solved);
+
+    char solved_line[] = "Solved grid :\n";
+
+    if (s_sudoku_writer_write(w, initial, format) == -1
+        || s_sudoku_writer_write_string(w, line, length) == -1
+        || s_sudoku_writer_write_string(w, solved_line, strlen(solved_line)) == -1
+        || s_sudoku_writer_write(w, solved ? solution : initial, format) == -1)
+      return -1;
+    return 0;
+  }
+
+  if (!solved) {
+    char unsolvable[] = "unsolvable\n";
+    return s_sudoku_writer_write_string(w, unsolvable, strlen(unsolvable));
+  }
+
+  return s_sudoku_writer_write(w, solution, format);
+}
+
+int batch_solve(char **filenames, size_t count, s_sudoku_writer w,
+                batch_options options) {
+  if (!filenames || !w) return -1;
+
+  size_t threads = options.threads;
+  if (threads == 0) {
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    threads = cores > 0 ? cores : 1;
+  }
+
+  struct batch b;
+  b.capacity = threads * BATCH_JOBS_PER_THREAD;
+  b.jobs = alloc_malloc(ALLOC_RUNTIME, sizeof(struct batch_job) * b.capacity);
+  pthread_t *workers = alloc_malloc(ALLOC_RUNTIME, sizeof(pthread_t) * threads);
+  if (!b.jobs || !workers) {
+    alloc_free(b.jobs);
+    alloc_free(workers);
+    return -1;
+  }
+
+  pthread_mutex_init(&b.lock, NULL);
+  pthread_cond_init(&b.work, NULL);
+  pthread_cond_init(&b.done, NULL);
+  b.head = 0;
+  b.next = 0;
+  b.tail = 0;
+  b.input_ended = false;
+  b.count = options.count;
+  b.portfolio = options.portfolio;
+  b.conquer = options.conquer;
+  b.preprocess = options.preprocess;
+  b.stats = options.stats;
+
+  size_t started = 0;
+  while (started < threads
+         && pthread_create(&workers[started], NULL, batch_worker, &b) == 0)
+    started++;
+
+  int status = started > 0 ? 0 : -1;
+  bool invalid = false;
+  long grids = 0;
+
+  // Read every file, the results are written as soon as the window is full
+  for (size_t k = 0; k < count && status == 0; k++) {
+    long r = batch_read_file(&b, filenames[k], w, options.format, &invalid);
+    if (r == -1)
+      status = -1;
+    else
+      grids += r;
+  }
+
+  pthread_mutex_lock(&b.lock);
+  b.input_ended = true;
+  pthread_cond_broadcast(&b.work);
+  pthread_mutex_unlock(&b.lock);
+
+  // Write the results of the remaining jobs (without workers there is no way
+  // to solve them so just free them)
+  while (b.head != b.tail) {
+    if (started == 0) {
+      struct batch_job *job = &b.jobs[b.head++ % b.capacity];
+      s_sudoku_free(job->initial);
+      s_sudoku_free(job->solution);
+    } else if (batch_write_oldest(&b, w, options.format) == -1) {
+      status = -1;
+    }
+  }
+
+  for (size_t k = 0; k < started; k++)
+    pthread_join(workers[k], NULL);
+
+  pthread_cond_destroy(&b.done);
+  pthread_cond_destroy(&b.work);
+  pthread_mutex_destroy(&b.lock);
+  alloc_free(workers);
+  alloc_free(b.jobs);
+
+  if (invalid || grids == 0) status = -1;
+  return status;
+}
+
+// ==========================
@@ -0,0 +1,134 @@
+#include <stdlib.h>
+#include <stdbool.h>
+
+#include "clause_ring.h"
+#include "alloc.h"
+
+
+// ===== STRUCTS =====
+
+// Size of a cache line, the positions written by the producer are kept away
+// from the ones only read
+#define CACHE_LINE 64
+
+/* Each clause is stored as its length followed by its litterals, from
+ * position head to head + length. Positions grow forever and are taken
+ * modulo the capacity.
+ */
+typedef struct clause_ring {
+  // End of the clauses readable, only written by the producer
+  size_t head;
+  char head_padding[CACHE_LINE - sizeof(size_t)];
+
+  // End of the clause being written, only written by the producer before
+  // it writes the clause: the positions below reserved - capacity are
+  // overwritten
+  size_t reserved;
+  char reserved_padding[CACHE_LINE - sizeof(size_t)];
+
+  size_t pushed;        // Clauses pushed, only written by the producer
+  size_t mask;          // Capacity - 1 (capacity is a power of two)
+  int *litts;
+} *s_clause_ring;
+
+// ===================
+
+
+// ===== BASE FUNCTIONS =====
+
+s_clause_ring s_clause_ring_create(size_t capacity) {
+  if (capacity <= 1) return NULL;
+
+  size_t size = 1;
+  while (size < capacity) size *= 2;
+
+  s_clause_ring r = alloc_malloc(ALLOC_DPLL, sizeof(struct clause_ring));
+  if (!r) return NULL;
+
+  r->litts = alloc_malloc(ALLOC_DPLL, sizeof(int) * size);
+  if (!r->litts) {
+    alloc_free(r);
+    return NULL;
+  }
+
+  r->mask = size - 1;
+  s_clause_ring_clear(r);
+  return r;
+}
+
+void s_clause_ring_free(s_clause_ring r) {
+  alloc_free(r->litts);
+  alloc_free(r);
+}
+
+void s_clause_ring_clear(s_clause_ring r) {
+  r->head = 0;
+  r->reserved = 0;
+  r->pushed = 0;
+}
+
+bool s_clause_ring_push(s_clause_ring r, const int *litts, size_t length) {
+  if (length == 0 || length > r->mask) return false;
+
+  size_t head = r->head;
+  __atomic_store_n(&r->reserved, head + 1 + length, __ATOMIC_RELAXED);
+
+  // The readers must see the reservation before any litteral it overwrites
+  __atomic_thread_fence(__ATOMIC_RELEASE);
+
+  __atomic_store_n(&r->litts[head & r->mask], (int) length, __ATOMIC_RELAXED);
+  for (size_t k = 0; k < length; k++)
+    __atomic_store_n(&r->litts[(head + 1 + k) & r->mask], litts[k], __ATOMIC_RELAXED);
+
+  // Publish the clause after writing it
+  __atomic_store_n(&r->head, head + 1 + length, __ATOMIC_RELEASE);
+  __atomic_store_n(&r->pushed, r->pushed + 1, __ATOMIC_RELAXED);
+  return true;
+}
+
+size_t s_clause_ring_read(s_clause_ring r, size_t *cursor, int *litts, size_t capacity) {
+  size_t head = __atomic_load_n(&r->head, __ATOMIC_ACQUIRE);
+
+  while (*cursor < head) {
+    size_t start = *cursor;
+
+    // Overwritten since the last read, the start of the next clause is lost
+    if (head - start > r->mask + 1) break;
+
+    int value = __atomic_load_n(&r->litts[start & r->mask], __ATOMIC_RELAXED);
+    size_t length = value > 0 ? (size_t) value : 0;
+    if (length == 0 || length > head - start - 1) break;
+
+    size_t copied = length <= capacity ? length : 0;
+    for (size_t k = 0; k < copied; k++)
+      litts[k] = __atomic_load_n(&r->litts[(start + 1 + k) & r->mask], __ATOMIC_RELAXED);
+
+    // The clause was read whole if the producer had not started to
+    // overwrite it by then
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    size_t reserved = __atomic_load_n(&r->reserved, __ATOMIC_RELAXED);
+    if (reserved - start > r->mask + 1) break;
+
+    *cursor = start + 1 + length;
+    if (copied) return length;
+  }
+
+  // The clauses left are lost, the reader goes on with the next ones
+  if (*cursor < head) *cursor = head;
+  return 0;
+}
+
+// ==========================
+
+
+// ===== GETTERS =====
+
+size_t s_clause_ring_pushed(s_clause_ring r) {
+  return __atomic_load_n(&r->pushed, __ATOMIC_RELAXED);
+}
+
+size_t s_clause_ring_capacity(s_clause_ring r) {
+  return r->mask + 1;
+}
+
+// ===================
@@ -4,6 +4,11 @@
 #include <sys/queue.h>
 
 #include "cnf.h"
+#include "alloc.h"
+
+// The hash tables allocate through the allocator of the library too
+#define uthash_malloc(sz) alloc_malloc(ALLOC_CNF, sz)
+#define uthash_free(ptr, sz) alloc_free(ptr)
 #include "uthash/uthash.h"
 
 
@@ -41,10 +46,10 @@ void free_litterals(struct litteral *litterals) {
 
   HASH_ITER(hh, litterals, current_litteral, tmp) {
     HASH_DEL(litterals, current_litteral);
-    free(current_litteral);
+    alloc_free(current_litteral);
   }
 
-  free(litterals);
+  alloc_free(litterals);
 }
 
 /* Frees the whole hashmap of clauses and its
@@ -56,10 +61,10 @@ void free_clauses(struct clause *clauses) {
   HASH_ITER(hh, clauses, current_clause, tmp) {
     HASH_DEL(clauses, current_clause);
     free_litterals(current_clause->litterals);
-    free(current_clause);
+    alloc_free(current_clause);
   }
 
-  free(clauses);
+  alloc_free(clauses);
 }
 
 /* Returns a pointer to the given clause by its id
@@ -93,7 +98,7 @@ int get_nb_clauses(s_cnf cn) {
 // ===== BASE FUNCTIONS =====
 
 s_cnf s_cnf_create() {
-  s_cnf cn = malloc(sizeof(struct cnf));
+  s_cnf cn = alloc_malloc(ALLOC_CNF, sizeof(struct cnf));
   if (!cn) return NULL;
 
   cn->current_clause_id = 0;
@@ -103,19 +108,23 @@ s_cnf s_cnf_create() {
 
 void s_cnf_free(s_cnf cn) {
   free_clauses(cn->clauses);
-  free(cn);
+  alloc_free(cn);
 }
 
 s_cnf s_cnf_copy(s_cnf cn) {
   if (!cn) return NULL;
 
   s_cnf new_cn = s_cnf_create();
+  if (!new_cn) return NULL;
+
+  // The clauses added to the copy get new ids too
+  new_cn->current_clause_id = cn->current_clause_id;
 
   // Create a copy of each clause and append it to
   // the new hashmap of clauses
   struct clause *current_clause, *tmp;
   HASH_ITER(hh, cn->clauses, current_clause, tmp) {
-    struct clause *clause_copy = malloc(sizeof(struct clause));
+    struct clause *clause_copy = alloc_malloc(ALLOC_CNF, sizeof(struct clause));
     if (!clause_copy) {
       s_cnf_free(new_cn);
       return NULL;
@@ -128,7 +137,7 @@ s_cnf s_cnf_copy(s_cnf cn) {
     // to the new hashmap of litterals
     struct litteral *current_litteral, *tmp;
     HASH_ITER(hh, current_clause->litterals, current_litteral, tmp) {
-      struct litteral *litteral_copy = malloc(sizeof(struct litteral));
+      struct litteral *litteral_copy = alloc_malloc(ALLOC_CNF, sizeof(struct litteral));
       if (!litteral_copy) {
         s_cnf_free(new_cn);
         return NULL;
@@ -153,7 +162,7 @@ int s_cnf_add_clause(s_cnf cn, int *litt, size_t length) {
     if (litt[i] == 0) return -1;
 
   // Create a new clause and add it to the list of clauses
-  struct clause *clause = malloc(sizeof(struct clause));
+  struct clause *clause = alloc_malloc(ALLOC_CNF, sizeof(struct clause));
   if (!clause) return -1;
 
   clause->id = cn->current_clause_id++;
@@ -167,11 +176,11 @@ int s_cnf_add_clause(s_cnf cn, int *litt, size_t length) {
 
   // Append every given litterals to the list of litterals
   for (int i = 0; i < length; i++) {
-    struct litteral *litteral = malloc(sizeof(struct litteral));
+    struct litteral *litteral = alloc_malloc(ALLOC_CNF, sizeof(struct litteral));
     if (!litteral) {
       HASH_DEL(cn->clauses, clause);      // Remove just inserted clause
       free_litterals(clause->litterals);  // Free the litterals
-      free(clause);                       // Free the allocated clause
+      alloc_free(clause);                       // Free the allocated clause
       return -1;
     }
 
@@ -193,7 +202,7 @@ int s_cnf_remove_clause(s_cnf cn, size_t c_id) {
 
   // Free the clause
   free_litterals(cl->litterals);
-  free(cl);
+  alloc_free(cl);
 
   return 0;
 }
@@ -208,7 +217,7 @@ int s_cnf_clause_add_litt(s_cnf cn, size_t c_id, int litt) {
   if (s_cnf_clause_contains_litt(cn, c_id, litt) == 1) return 0;
 
   // Create a new litteral
-  struct litteral *litteral = malloc(sizeof(struct litteral));
+  struct litteral *litteral = alloc_malloc(ALLOC_CNF, sizeof(struct litteral));
   if (!litteral) return 1;
 
   // Insert the new litteral
@@ -228,6 +237,7 @@ int s_cnf_clause_remove_litt(s_cnf cn, size_t c_id, int litt) {
     struct litteral *litteral;
     HASH_FIND_INT(cl->litterals, &litt, litteral);
     HASH_DEL(cl->litterals, litteral);
+    alloc_free(litteral);
   }
 
   return 0;
@@ -278,7 +288,7 @@ size_t *s_cnf_get_clauses_ids(s_cnf cn, size_t *n) {
   *n = get_nb_clauses(cn);
 
   // Allocate array
-  size_t *clauses_ids = malloc(sizeof(size_t) * (*n));
+  size_t *clauses_ids = alloc_malloc(ALLOC_CNF, sizeof(size_t) * (*n));
   if (!clauses_ids) return NULL;
 
   int i = 0;
@@ -301,7 +311,7 @@ int *s_cnf_clause_get_litts(s_cnf cn, size_t c_id, size_t *n) {
   *n = get_clause_length(cl);
 
   // Allocate the array
-  int *litts = malloc(sizeof(int) * (*n));
+  int *litts = alloc_malloc(ALLOC_CNF, sizeof(int) * (*n));
   if (!litts) return NULL;
 
   int i = 0;
@@ -314,6 +324,39 @@ int *s_cnf_clause_get_litts(s_cnf cn, size_t c_id, size_t *n) {
   return litts;
 }
 
+size_t s_cnf_get_clauses_count(s_cnf cn) {
+  if (!cn) return 0;
+  return get_nb_clauses(cn);
+}
+
+size_t s_cnf_get_litts_count(s_cnf cn) {
+  if (!cn) return 0;
+
+  size_t count = 0;
+  struct clause *current_clause, *tmp;
+  HASH_ITER(hh, cn->clauses, current_clause, tmp) {
+    count += get_clause_length(current_clause);
+  }
+
+  return count;
+}
+
+size_t s_cnf_get_vars_count(s_cnf cn) {
+  if (!cn) return 0;
+
+  size_t count = 0;
+  struct clause *current_clause, *tmp;
+  HASH_ITER(hh, cn->clauses, current_clause, tmp) {
+    struct litteral *current_litteral, *tmp;
+    HASH_ITER(hh, current_clause->litterals, current_litteral, tmp) {
+      size_t var = abs(current_litteral->litt);
+      if (var > count) count = var;
+    }
+  }
+
+  return count;
+}
+
 // ===================
 
 
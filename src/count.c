@@ -0,0 +1,648 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdlib.h>
+#include <stdbool.h>
+
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+
+#include "cnf.h"
+#include "count.h"
+#include "alloc.h"
+#include "util.h"
+
+// The cache allocates through the allocator of the library too
+#define uthash_malloc(sz) alloc_malloc(ALLOC_COUNT, sz)
+#define uthash_free(ptr, sz) alloc_free(ptr)
+#include "uthash/uthash.h"
+
+
+// ===== STRUCTS =====
+
+// Count of a component, under the key of its variables followed by 0 and
+// the clauses of the component which lost a litteral (the other clauses of
+// the component are the ones made of its variables only), packed by
+// count_pack
+struct count_entry {
+  count_number count;
+  UT_hash_handle hh;
+  unsigned char key[];
+};
+
+// Component found by count_split, its key is at the start of its variables
+// on the stack
+struct count_component {
+  size_t start;
+  size_t vars;
+  size_t length;      // Of its key, 0 for a variable in no clause
+  int branch;         // Variable of the component in the most clauses
+};
+
+struct count {
+  size_t vars;
+
+  // Clauses without duplicated litterals nor tautologies
+  int *litts;
+  size_t *starts;       // Clause c is litts[starts[c]] to litts[starts[c + 1]]
+  size_t clauses;
+
+  // Clauses of other sizes than 2 containing each litteral (see count_index)
+  size_t *occurrences;
+  size_t *occurrences_starts;
+
+  // Other litteral of the binary clauses containing each litteral, such a
+  // clause without any true litteral has both unassigned after propagation
+  int *binaries;
+  size_t *binaries_starts;
+
+  // Indexed by clause, counters of the propagated litterals only
+  size_t *satisfied;    // True litterals
+  size_t *unassigned;
+  size_t *clause_stamps;
+
+  // Indexed by variable
+  signed char *values;
+  size_t *var_stamps;
+  size_t *scores;       // Clauses of the component being split
+  size_t stamp;
+
+  size_t *shortened;    // Clauses of the component being split which lost a
+  size_t shortened_capacity;  // litteral
+
+  int *trail;
+  size_t trail_length;
+  size_t qhead;         // Next litteral of the trail to propagate
+
+  // Variables and keys of the components being counted, by depth
+  int *stack;
+  size_t stack_length;
+  size_t stack_capacity;
+  struct count_component *components;
+  size_t components_length;
+  size_t components_capacity;
+
+  struct count_entry *cache;
+  size_t cache_bytes;
+  unsigned char *packed;  // Key being looked up, see count_pack
+  size_t packed_capacity;
+
+  bool failed;          // An allocation failed or the count overflowed
+  count_stats stats;
+};
+
+// ===================
+
+
+// ===== PRIVATE =====
+
+// Returns a * b, or 0 and marks the count failed if it overflows
+count_number count_multiply(struct count *c, count_number a, count_number b) {
+  if (a != 0 && b > (~(count_number) 0) / a) {
+    c->failed = true;
+    return 0;
+  }
+  return a * b;
+}
+
+// Returns a + b, or 0 and marks the count failed if it overflows
+count_number count_add(struct count *c, count_number a, count_number b) {
+  if (a > ~(count_number) 0 - b) {
+    c->failed = true;
+    return 0;
+  }
+  return a + b;
+}
+
+void count_free(struct count *c) {
+  struct count_entry *entry, *tmp;
+  HASH_ITER(hh, c->cache, entry, tmp) {
+    HASH_DEL(c->cache, entry);
+    alloc_free(entry);
+  }
+
+  alloc_free(c->litts);
+  alloc_free(c->starts);
+  alloc_free(c->occurrences);
+  alloc_free(c->occurrences_starts);
+  alloc_free(c->binaries);
+  alloc_free(c->binaries_starts);
+  alloc_free(c->satisfied);
+  alloc_free(c->unassigned);
+  alloc_free(c->clause_stamps);
+  alloc_free(c->values);
+  alloc_free(c->var_stamps);
+  alloc_free(c->scores);
+  alloc_free(c->trail);
+  alloc_free(c->shortened);
+  alloc_free(c->packed);
+  alloc_free(c->stack);
+  alloc_free(c->components);
+}
+
+/* Copies the clauses of cn in c, sorted, without their duplicated litterals
+ * and without the tautologies, and builds the occurrences of the litterals
+ *
+ * Returns 1 when cn has an empty clause, 0 otherwise and -1 on failure
+ */
+int count_load(struct count *c, s_cnf cn) {
+  c->vars = s_cnf_get_vars_count(cn);
+  size_t litts_count = s_cnf_get_litts_count(cn);
+  size_t ids_length = 0;
+  size_t *ids = s_cnf_get_clauses_ids(cn, &ids_length);
+
+  c->litts = alloc_malloc(ALLOC_COUNT, sizeof(int) * (litts_count + 1));
+  c->starts = alloc_malloc(ALLOC_COUNT, sizeof(size_t) * (ids_length + 1));
+  c->occurrences_starts = alloc_calloc(ALLOC_COUNT, 2 * c->vars + 3, sizeof(size_t));
+  c->binaries_starts = alloc_calloc(ALLOC_COUNT, 2 * c->vars + 3, sizeof(size_t));
+  c->values = alloc_calloc(ALLOC_COUNT, c->vars + 1, sizeof(signed char));
+  c->var_stamps = alloc_calloc(ALLOC_COUNT, c->vars + 1, sizeof(size_t));
+  c->scores = alloc_calloc(ALLOC_COUNT, c->vars + 1, sizeof(size_t));
+  c->trail = alloc_malloc(ALLOC_COUNT, sizeof(int) * (c->vars + 1));
+  if ((ids_length && !ids) || !c->litts || !c->starts || !c->occurrences_starts
+      || !c->binaries_starts || !c->values || !c->var_stamps || !c->scores || !c->trail) {
+    alloc_free(ids);
+    return -1;
+  }
+
+  int empty = 0;
+  size_t length = 0;
+  c->clauses = 0;
+
+  for (size_t k = 0; k < ids_length; k++) {
+    size_t n = 0;
+    int *litts = s_cnf_clause_get_litts(cn, ids[k], &n);
+    if (n > 0 && !litts) {
+      alloc_free(ids);
+      return -1;
+    }
+    if (n == 0) empty = 1;
+
+    qsort(litts, n, sizeof(int), util_compare_ints);
+
+    size_t start = length;
+    bool tautology = false;
+    for (size_t l = 0; l < n; l++) {
+      if (l > 0 && litts[l] == litts[l - 1]) continue;
+      for (size_t m = start; m < length; m++)
+        if (c->litts[m] == -litts[l]) tautology = true;
+      c->litts[length++] = litts[l];
+    }
+    alloc_free(litts);
+
+    if (tautology || n == 0) {
+      length = start;
+      continue;
+    }
+    c->starts[c->clauses++] = start;
+  }
+  c->starts[c->clauses] = length;
+  alloc_free(ids);
+
+  // Occurrences of the litterals, counted and then placed
+  for (size_t clause = 0; clause < c->clauses; clause++) {
+    size_t *starts = c->starts[clause + 1] - c->starts[clause] == 2 ? c->binaries_starts
+                                                                     : c->occurrences_starts;
+    for (size_t l = c->starts[clause]; l < c->starts[clause + 1]; l++)
+      starts[util_litt_index(c->litts[l]) + 1]++;
+  }
+  for (size_t k = 1; k < 2 * c->vars + 3; k++) {
+    c->occurrences_starts[k] += c->occurrences_starts[k - 1];
+    c->binaries_starts[k] += c->binaries_starts[k - 1];
+  }
+
+  size_t litts_length = 2 * c->vars + 2;
+  c->occurrences = alloc_malloc(ALLOC_COUNT, sizeof(size_t) * (length + 1));
+  c->binaries = alloc_malloc(ALLOC_COUNT, sizeof(int) * (length + 1));
+  size_t *placed = alloc_malloc(ALLOC_COUNT, sizeof(size_t) * 2 * litts_length);
+  c->satisfied = alloc_calloc(ALLOC_COUNT, c->clauses + 1, sizeof(size_t));
+  c->unassigned = alloc_malloc(ALLOC_COUNT, sizeof(size_t) * (c->clauses + 1));
+  c->clause_stamps = alloc_calloc(ALLOC_COUNT, c->clauses + 1, sizeof(size_t));
+  if (!c->occurrences || !c->binaries || !placed || !c->satisfied || !c->unassigned
+      || !c->clause_stamps) {
+    alloc_free(placed);
+    return -1;
+  }
+
+  size_t *binaries_placed = placed + litts_length;
+  memcpy(placed, c->occurrences_starts, sizeof(size_t) * litts_length);
+  memcpy(binaries_placed, c->binaries_starts, sizeof(size_t) * litts_length);
+  for (size_t clause = 0; clause < c->clauses; clause++) {
+    int *litts = c->litts + c->starts[clause];
+    c->unassigned[clause] = c->starts[clause + 1] - c->starts[clause];
+
+    if (c->unassigned[clause] == 2) {
+      c->binaries[binaries_placed[util_litt_index(litts[0])]++] = litts[1];
+      c->binaries[binaries_placed[util_litt_index(litts[1])]++] = litts[0];
+      continue;
+    }
+    for (size_t l = 0; l < c->unassigned[clause]; l++)
+      c->occurrences[placed[util_litt_index(litts[l])]++] = clause;
+  }
+  alloc_free(placed);
+
+  c->stats.vars = c->vars;
+  c->stats.clauses = c->clauses;
+  return empty;
+}
+
+// Assigns litt, its clauses are updated when it is propagated
+void count_assign(struct count *c, int litt) {
+  c->values[abs(litt)] = litt > 0 ? 1 : -1;
+  c->trail[c->trail_length++] = litt;
+}
+
+/* Propagates the litterals of the trail from qhead, assigning the last
+ * litterals of the clauses left without any true one
+ *
+ * Returns 0 on success and -1 when a clause is false
+ */
+int count_propagate(struct count *c) {
+  int conflict = 0;
+
+  while (c->qhead < c->trail_length && !conflict) {
+    int litt = c->trail[c->qhead++];
+
+    size_t index = util_litt_index(litt);
+    for (size_t k = c->occurrences_starts[index]; k < c->occurrences_starts[index + 1]; k++)
+      c->satisfied[c->occurrences[k]]++;
+
+    // The clauses of the opposite litterals are all updated even on a
+    // conflict so that count_backtrack can undo the propagation
+    index = util_litt_index(-litt);
+    for (size_t k = c->binaries_starts[index]; k < c->binaries_starts[index + 1]; k++) {
+      int other = c->binaries[k];
+      signed char value = c->values[abs(other)];
+      if (value == 0)
+        count_assign(c, other);
+      else if (value != (other > 0 ? 1 : -1))
+        conflict = -1;
+    }
+
+    for (size_t k = c->occurrences_starts[index]; k < c->occurrences_starts[index + 1]; k++) {
+      size_t clause = c->occurrences[k];
+      c->unassigned[clause]--;
+      if (conflict || c->satisfied[clause] > 0) continue;
+
+      if (c->unassigned[clause] == 0) {
+        conflict = -1;
+      } else if (c->unassigned[clause] == 1) {
+        // The litterals assigned but not propagated yet are not counted
+        for (size_t l = c->starts[clause]; l < c->starts[clause + 1]; l++) {
+          if (c->values[abs(c->litts[l])] == 0) {
+            count_assign(c, c->litts[l]);
+            break;
+          }
+        }
+      }
+    }
+  }
+
+  return conflict;
+}
+
+// Unassigns the litterals of the trail from length, undoing the propagated ones
+void count_backtrack(struct count *c, size_t length) {
+  while (c->trail_length > length) {
+    int litt = c->trail[--c->trail_length];
+    c->values[abs(litt)] = 0;
+    if (c->trail_length >= c->qhead) continue;
+
+    size_t index = util_litt_index(litt);
+    for (size_t k = c->occurrences_starts[index]; k < c->occurrences_starts[index + 1]; k++)
+      c->satisfied[c->occurrences[k]]--;
+
+    index = util_litt_index(-litt);
+    for (size_t k = c->occurrences_starts[index]; k < c->occurrences_starts[index + 1]; k++)
+      c->unassigned[c->occurrences[k]]++;
+  }
+  c->qhead = c->trail_length;
+}
+
+/* Splits the unassigned variables among the vars ones at start of the stack,
+ * sorted, into components connected by the clauses without any true litteral, each
+ * pushed on the stack with its key (see count_entry)
+ *
+ * Returns the number of components pushed and -1 on failure
+ */
+long count_split(struct count *c, size_t start, size_t vars) {
+  long found = 0;
+  size_t split = c->stamp + 1;
+
+  for (size_t k = 0; k < vars; k++) {
+    int root = c->stack[start + k];
+    if (c->values[root] != 0 || c->var_stamps[root] >= split) continue;
+    c->stamp++;
+
+    // Variables of the component, found in breadth first order
+    size_t first = c->stack_length;
+    if (util_grow(ALLOC_COUNT, (void **) &c->stack, &c->stack_capacity, first + 1,
+                  sizeof(int)) == -1)
+      return -1;
+    c->stack[c->stack_length++] = root;
+    c->var_stamps[root] = c->stamp;
+    c->scores[root] = 0;
+    size_t clauses = 0;
+    size_t shortened = 0;
+    size_t shortest = SIZE_MAX;
+
+    for (size_t q = first; q < c->stack_length; q++) {
+      int var = c->stack[q];
+
+      for (int sign = -1; sign <= 1; sign += 2) {
+        size_t index = util_litt_index(sign * var);
+        for (size_t o = c->binaries_starts[index]; o < c->binaries_starts[index + 1]; o++) {
+          int other = abs(c->binaries[o]);
+          if (c->values[other] != 0) continue;
+
+          // Counted from both of its variables
+          clauses++;
+          c->scores[var]++;
+          if (c->var_stamps[other] != c->stamp) {
+            if (util_grow(ALLOC_COUNT, (void **) &c->stack, &c->stack_capacity,
+                          c->stack_length + 1, sizeof(int)) == -1)
+              return -1;
+            c->var_stamps[other] = c->stamp;
+            c->scores[other] = 0;
+            c->stack[c->stack_length++] = other;
+          }
+        }
+
+        for (size_t o = c->occurrences_starts[index]; o < c->occurrences_starts[index + 1]; o++) {
+          size_t clause = c->occurrences[o];
+          if (c->satisfied[clause] > 0 || c->clause_stamps[clause] == c->stamp) continue;
+          c->clause_stamps[clause] = c->stamp;
+          clauses++;
+
+          size_t size = c->starts[clause + 1] - c->starts[clause];
+          if (util_grow(ALLOC_COUNT, (void **) &c->stack, &c->stack_capacity,
+                        c->stack_length + size, sizeof(int)) == -1
+              || util_grow(ALLOC_COUNT, (void **) &c->shortened, &c->shortened_capacity,
+                           shortened + 1, sizeof(size_t)) == -1)
+            return -1;
+
+          if (c->unassigned[clause] < size) {
+            c->shortened[shortened++] = clause;
+            if (shortest == SIZE_MAX || c->unassigned[clause] < c->unassigned[shortest])
+              shortest = clause;
+          }
+
+          for (size_t l = c->starts[clause]; l < c->starts[clause + 1]; l++) {
+            int other = abs(c->litts[l]);
+            if (c->values[other] != 0) continue;
+            if (c->var_stamps[other] != c->stamp) {
+              c->var_stamps[other] = c->stamp;
+              c->scores[other] = 0;
+              c->stack[c->stack_length++] = other;
+            }
+            c->scores[other]++;
+          }
+        }
+      }
+    }
+
+    // Branch in the shortest clause which lost a litteral, on its variable in
+    // the most clauses, or on the variable in the most clauses
+    struct count_component component = {first, c->stack_length - first, 0, root};
+    if (shortest != SIZE_MAX) {
+      component.branch = 0;
+      for (size_t l = c->starts[shortest]; l < c->starts[shortest + 1]; l++) {
+        int var = abs(c->litts[l]);
+        if (c->values[var] == 0
+            && (!component.branch || c->scores[var] > c->scores[component.branch]))
+          component.branch = var;
+      }
+    } else {
+      for (size_t q = first; q < c->stack_length; q++)
+        if (c->scores[c->stack[q]] > c->scores[component.branch])
+          component.branch = c->stack[q];
+    }
+
+    // A variable in no clause left doubles the count, it needs no key
+    if (clauses > 0) {
+      if (util_grow(ALLOC_COUNT, (void **) &c->stack, &c->stack_capacity,
+                    c->stack_length + shortened + 1, sizeof(int)) == -1)
+        return -1;
+
+      // The variables at start are sorted, the ones of a large component are
+      // sorted faster by picking them from there
+      if (component.vars * 8 < vars) {
+        qsort(c->stack + first, component.vars, sizeof(int), util_compare_ints);
+      } else {
+        size_t sorted = first;
+        for (size_t l = start; l < start + vars; l++)
+          if (c->var_stamps[c->stack[l]] == c->stamp) c->stack[sorted++] = c->stack[l];
+      }
+      c->stack[c->stack_length++] = 0;
+      for (size_t l = 0; l < shortened; l++)
+        c->stack[c->stack_length++] = c->shortened[l];
+      qsort(c->stack + c->stack_length - shortened, shortened, sizeof(int), util_compare_ints);
+
+      component.length = c->stack_length - first;
+    }
+
+    if (util_grow(ALLOC_COUNT, (void **) &c->components, &c->components_capacity,
+                  c->components_length + 1, sizeof(struct count_component)) == -1)
+      return -1;
+    c->components[c->components_length++] = component;
+    found++;
+  }
+
+  return found;
+}
+
+/* Packs the key of component in c->packed: both sorted parts are written as
+ * the differences between their successive numbers, 7 bits per byte, so the
+ * keys of the cache are several times smaller than the arrays of numbers
+ *
+ * Returns the length of the packed key and 0 on failure
+ */
+size_t count_pack(struct count *c, struct count_component *component) {
+  if (util_grow(ALLOC_COUNT, (void **) &c->packed, &c->packed_capacity,
+                5 * component->length, 1) == -1)
+    return 0;
+
+  size_t length = 0;
+  long previous = 0;
+  for (size_t k = component->start; k < component->start + component->length; k++) {
+    // The variables are > 0 and the clauses >= 0, so the differences are > 0
+    // and the only 0 byte is the separator
+    if (k == component->start + component->vars) {
+      c->packed[length++] = 0;
+      previous = -1;
+      continue;
+    }
+
+    unsigned long delta = c->stack[k] - previous;
+    previous = c->stack[k];
+    while (delta >= 0x80) {
+      c->packed[length++] = (delta & 0x7f) | 0x80;
+      delta >>= 7;
+    }
+    c->packed[length++] = delta;
+  }
+
+  return length;
+}
+
+// Adds entry to the cache, emptying it first when it is full
+void count_cache(struct count *c, struct count_entry *entry, size_t length) {
+  size_t bytes = sizeof(struct count_entry) + length;
+  if (c->cache_bytes + bytes > COUNT_CACHE_BYTES) {
+    struct count_entry *cached, *tmp;
+    HASH_ITER(hh, c->cache, cached, tmp) {
+      HASH_DEL(c->cache, cached);
+      alloc_free(cached);
+    }
+    c->cache_bytes = 0;
+    c->stats.cache_flushes++;
+  }
+
+  HASH_ADD_KEYPTR(hh, c->cache, entry->key, length, entry);
+  c->cache_bytes += bytes;
+}
+
+count_number count_vars(struct count *c, size_t start, size_t vars);
+
+/* Counts the models of the component of index component, branching on its
+ * variable in the most clauses
+ */
+count_number count_component(struct count *c, size_t component) {
+  struct count_component comp = c->components[component];
+  c->stats.components++;
+
+  size_t length = count_pack(c, &comp);
+  if (length == 0) {
+    c->failed = true;
+    return 0;
+  }
+
+  struct count_entry *entry;
+  HASH_FIND(hh, c->cache, c->packed, length, entry);
+  if (entry) {
+    c->stats.cache_hits++;
+    return entry->count;
+  }
+
+  // The key is kept before c->packed is used by the components below
+  entry = alloc_malloc(ALLOC_COUNT, sizeof(struct count_entry) + length);
+  if (!entry) {
+    c->failed = true;
+    return 0;
+  }
+  memcpy(entry->key, c->packed, length);
+
+  count_number count = 0;
+  for (int sign = 1; sign >= -1 && !c->failed; sign -= 2) {
+    size_t trail_length = c->trail_length;
+    c->stats.decisions++;
+    count_assign(c, sign * comp.branch);
+
+    if (count_propagate(c) == -1)
+      c->stats.conflicts++;
+    else
+      count = count_add(c, count, count_vars(c, comp.start, comp.vars));
+
+    count_backtrack(c, trail_length);
+  }
+
+  if (c->failed) {
+    alloc_free(entry);
+    return 0;
+  }
+
+  entry->count = count;
+  count_cache(c, entry, length);
+  return count;
+}
+
+/* Counts the models of the unassigned variables among the vars ones at start
+ * of the stack, as the product of the counts of their components
+ */
+count_number count_vars(struct count *c, size_t start, size_t vars) {
+  size_t stack_length = c->stack_length;
+  size_t components_length = c->components_length;
+
+  count_number count = 1;
+  long found = count_split(c, start, vars);
+  if (found == -1) c->failed = true;
+
+  for (size_t k = components_length; k < c->components_length && count && !c->failed; k++) {
+    if (c->components[k].length == 0)
+      count = count_multiply(c, count, 2);
+    else
+      count = count_multiply(c, count, count_component(c, k));
+  }
+
+  c->stack_length = stack_length;
+  c->components_length = components_length;
+  return c->failed ? 0 : count;
+}
+
+// ===================
+
+
+// ===== BASE FUNCTIONS =====
+
+int count_models(s_cnf cn, count_number *count, count_stats *stats) {
+  if (!cn || !count) return -1;
+
+  double start = util_now();
+  struct count c;
+  memset(&c, 0, sizeof(c));
+
+  int empty = count_load(&c, cn);
+  if (empty == -1) c.failed = true;
+
+  *count = 0;
+  if (empty == 0) {
+    // The unit clauses are propagated first, then every variable starts on
+    // the stack and they are all split at once
+    for (size_t clause = 0; clause < c.clauses && !empty; clause++) {
+      if (c.starts[clause + 1] - c.starts[clause] != 1) continue;
+
+      int litt = c.litts[c.starts[clause]];
+      signed char value = c.values[abs(litt)];
+      if (value == 0)
+        count_assign(&c, litt);
+      else if (value != (litt > 0 ? 1 : -1))
+        empty = 1;
+    }
+  }
+
+  if (empty == 0 && count_propagate(&c) == 0) {
+    if (util_grow(ALLOC_COUNT, (void **) &c.stack, &c.stack_capacity, c.vars, sizeof(int)) == -1) {
+      c.failed = true;
+    } else {
+      for (size_t var = 1; var <= c.vars; var++)
+        c.stack[c.stack_length++] = var;
+      *count = count_vars(&c, 0, c.vars);
+    }
+  }
+
+  c.stats.cache_entries = HASH_COUNT(c.cache);
+  c.stats.seconds = util_now() - start;
+  if (stats) *stats = c.stats;
+
+  count_free(&c);
+  return c.failed ? -1 : 0;
+}
+
+size_t count_render(count_number count, char *buffer, size_t size) {
+  char digits[COUNT_DIGITS];
+  size_t length = 0;
+
+  do {
+    digits[length++] = '0' + (int) (count % 10);
+    count /= 10;
+  } while (count > 0);
+
+  if (!buffer || size <= length) return 0;
+
+  for (size_t k = 0; k < length; k++)
+    buffer[k] = digits[length - 1 - k];
+  buffer[length] = '\0';
+  return length;
+}
+
+// ==========================
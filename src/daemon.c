@@ -0,0 +1,370 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <sys/un.h>
+
+#include "sudoku.h"
+#include "sudoku_cnf.h"
+#include "daemon.h"
+#include "alloc.h"
+
+
+// ===== STRUCTS =====
+
+// Connection of a client of the socket
+struct daemon_client {
+  int fd;
+
+  // Requests received but not answered yet
+  char in[DAEMON_MAX_REQUEST + 1];
+  size_t in_length;
+  bool discarding;    // The current request is too long and is skipped
+
+  // Answers not sent yet
+  char *out;
+  size_t out_length;
+  size_t out_capacity;
+
+  bool closing;       // The client closed its side of the connection
+};
+
+// ===================
+
+
+// ===== PRIVATE =====
+
+// Set by daemon_stop
+static volatile sig_atomic_t daemon_stopped = 0;
+
+// Delay in ms between two checks of daemon_stopped
+#define DAEMON_POLL_TIMEOUT 100
+
+void daemon_signal_handler(int signum) {
+  daemon_stop();
+}
+
+/* Returns whether the request line only contains blanks
+ */
+bool daemon_request_empty(const char *line, size_t length) {
+  for (size_t k = 0; k < length; k++)
+    if (line[k] != ' ' && line[k] != '\t' && line[k] != '\r') return false;
+  return true;
+}
+
+/* Makes sure there is room for an answer at the end of the output of client
+ *
+ * Returns a pointer to the end of the output or NULL on failure
+ */
+char *daemon_client_reserve(struct daemon_client *client) {
+  if (client->out_length + DAEMON_MAX_REQUEST + 1 > client->out_capacity) {
+    size_t capacity = client->out_capacity * 2 + DAEMON_MAX_REQUEST + 1;
+    char *out = alloc_realloc(ALLOC_RUNTIME, client->out, capacity);
+    if (!out) return NULL;
+
+    client->out = out;
+    client->out_capacity = capacity;
+  }
+
+  return client->out + client->out_length;
+}
+
+/* Appends the answer to a request line at the end of the output of client
+ * (nothing for empty requests)
+ *
+ * Returns 0 on success and -1 on failure
+ */
+int daemon_client_answer(struct daemon_client *client, s_sudoku_solver sv,
+                         const char *line, size_t length) {
+  if (daemon_request_empty(line, length)) return 0;
+
+  char *answer = daemon_client_reserve(client);
+  if (!answer) return -1;
+
+  client->out_length += daemon_answer(sv, line, length, answer);
+  return 0;
+}
+
+/* Reads what the client sent and answers every complete request
+ *
+ * Returns 0 on success and -1 if the client must be disconnected
+ */
+int daemon_client_read(struct daemon_client *client, s_sudoku_solver sv) {
+  ssize_t r = read(client->fd, client->in + client->in_length,
+                   sizeof(client->in) - client->in_length);
+
+  if (r == 0) {
+    client->closing = true;
+
+    // The last request may not end with a new line
+    if (!client->discarding && client->in_length > 0) {
+      size_t length = client->in_length;
+      client->in_length = 0;
+      return daemon_client_answer(client, sv, client->in, length);
+    }
+    return 0;
+  }
+  if (r == -1) return errno == EAGAIN || errno == EINTR ? 0 : -1;
+
+  client->in_length += r;
+
+  // Answer every complete request
+  size_t start = 0;
+  char *end;
+  while ((end = memchr(client->in + start, '\n', client->in_length - start))) {
+    size_t length = end - (client->in + start);
+
+    if (!client->discarding
+        && daemon_client_answer(client, sv, client->in + start, length) == -1)
+      return -1;
+
+    client->discarding = false;
+    start += length + 1;
+  }
+
+  // Keep the incomplete request for later
+  memmove(client->in, client->in + start, client->in_length - start);
+  client->in_length -= start;
+
+  // A request that does not fit in the buffer is too long
+  if (client->in_length == sizeof(client->in)) {
+    if (!client->discarding) {
+      char *answer = daemon_client_reserve(client);
+      if (!answer) return -1;
+
+      char invalid[] = "invalid\n";
+      memcpy(answer, invalid, strlen(invalid));
+      client->out_length += strlen(invalid);
+    }
+    client->discarding = true;
+    client->in_length = 0;
+  }
+
+  return 0;
+}
+
+/* Sends as much of the pending answers of the client as possible
+ *
+ * Returns 0 on success and -1 if the client must be disconnected
+ */
+int daemon_client_write(struct daemon_client *client) {
+  if (client->out_length == 0) return 0;
+
+  ssize_t r = write(client->fd, client->out, client->out_length);
+  if (r == -1) return errno == EAGAIN || errno == EINTR ? 0 : -1;
+
+  memmove(client->out, client->out + r, client->out_length - r);
+  client->out_length -= r;
+  return 0;
+}
+
+void daemon_client_free(struct daemon_client *client) {
+  close(client->fd);
+  alloc_free(client->out);
+  alloc_free(client);
+}
+
+/* Creates the listening socket path
+ *
+ * Returns its file descriptor or -1 on failure
+ */
+int daemon_listen(char *path) {
+  struct sockaddr_un addr;
+  if (strlen(path) >= sizeof(addr.sun_path)) return -1;
+
+  memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  strcpy(addr.sun_path, path);
+
+  int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (fd == -1) return -1;
+
+  unlink(path);
+  if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) == -1
+      || listen(fd, SOMAXCONN) == -1) {
+    close(fd);
+    return -1;
+  }
+
+  return fd;
+}
+
+// ===================
+
+
+// ===== BASE FUNCTIONS =====
+
+size_t daemon_answer(s_sudoku_solver sv, const char *line, size_t length,
+                     char *answer) {
+  char *text = "invalid\n";
+
+  s_sudoku g = length <= DAEMON_MAX_REQUEST ? s_sudoku_create_from_line(line, length)
+                                            : NULL;
+  if (g) {
+    int solved = s_sudoku_solver_solve(sv, g);
+
+    if (solved == 1) {
+      size_t size = s_sudoku_render_size(s_sudoku_size(g), SUDOKU_FORMAT_LINE);
+      size_t r = s_sudoku_render(g, SUDOKU_FORMAT_LINE, answer, size);
+      s_sudoku_free(g);
+      return r;
+    }
+
+    if (solved == 0) text = "unsolvable\n";
+    s_sudoku_free(g);
+  }
+
+  size_t r = strlen(text);
+  memcpy(answer, text, r);
+  return r;
+}
+
+int daemon_run_stream(FILE *in, FILE *out) {
+  if (!in || !out) return -1;
+
+  s_sudoku_solver sv = s_sudoku_solver_create();
+  char *answer = alloc_malloc(ALLOC_RUNTIME, DAEMON_MAX_REQUEST + 1);
+  if (!sv || !answer) {
+    if (sv) s_sudoku_solver_free(sv);
+    alloc_free(answer);
+    return -1;
+  }
+
+  char *line = NULL;
+  size_t line_capacity = 0;
+  ssize_t r = 0;
+  int status = 0;
+
+  while ((r = getline(&line, &line_capacity, in)) != -1) {
+    if (r > 0 && line[r - 1] == '\n') r--;
+    if (daemon_request_empty(line, r)) continue;
+
+    size_t length = daemon_answer(sv, line, r, answer);
+    if (fwrite(answer, 1, length, out) != length || fflush(out) != 0) {
+      status = -1;
+      break;
+    }
+  }
+
+  free(line);           // Allocated by getline
+  alloc_free(answer);
+  s_sudoku_solver_free(sv);
+  return status;
+}
+
+int daemon_run_socket(char *path) {
+  if (!path) return -1;
+
+  daemon_stopped = 0;
+
+  // Stop on SIGINT and SIGTERM, without restarting poll
+  struct sigaction sa;
+  memset(&sa, 0, sizeof(sa));
+  sa.sa_handler = daemon_signal_handler;
+  sigemptyset(&sa.sa_mask);
+  sigaction(SIGINT, &sa, NULL);
+  sigaction(SIGTERM, &sa, NULL);
+
+  // A client leaving early must not kill the daemon
+  signal(SIGPIPE, SIG_IGN);
+
+  int listener = daemon_listen(path);
+  if (listener == -1) return -1;
+
+  s_sudoku_solver sv = s_sudoku_solver_create();
+  if (!sv) {
+    close(listener);
+    unlink(path);
+    return -1;
+  }
+
+  struct daemon_client **clients = NULL;
+  struct pollfd *fds = alloc_malloc(ALLOC_RUNTIME, sizeof(struct pollfd));
+  size_t nb_clients = 0;
+  int status = fds ? 0 : -1;
+
+  while (status == 0 && !daemon_stopped) {
+    fds[0].fd = listener;
+    fds[0].events = POLLIN;
+
+    // A client which doesn't read its answers is not read either, so that
+    // they can't pile up
+    for (size_t k = 0; k < nb_clients; k++) {
+      bool reading = clients[k]->out_length < DAEMON_MAX_PENDING;
+      fds[k + 1].fd = clients[k]->fd;
+      fds[k + 1].events = (reading ? POLLIN : 0) | (clients[k]->out_length > 0 ? POLLOUT : 0);
+      fds[k + 1].revents = 0;
+    }
+
+    int r = poll(fds, nb_clients + 1, DAEMON_POLL_TIMEOUT);
+    if (r == -1 && errno != EINTR) status = -1;
+    if (r <= 0) continue;
+
+    // Serve the clients (in reverse order so they can be removed)
+    for (size_t k = nb_clients; k-- > 0;) {
+      struct daemon_client *client = clients[k];
+      short revents = fds[k + 1].revents;
+
+      bool failed = false;
+      if (revents & (POLLIN | POLLHUP) && client->out_length < DAEMON_MAX_PENDING)
+        failed = daemon_client_read(client, sv) == -1;
+      if (!failed && (revents & POLLOUT || client->out_length > 0))
+        failed = daemon_client_write(client) == -1;
+      if (revents & POLLERR) failed = true;
+
+      if (failed || (client->closing && client->out_length == 0)) {
+        daemon_client_free(client);
+        clients[k] = clients[--nb_clients];
+      }
+    }
+
+    // New client
+    if (fds[0].revents & POLLIN) {
+      int fd = accept(listener, NULL, NULL);
+      if (fd == -1) continue;
+
+      struct daemon_client *client = alloc_calloc(ALLOC_RUNTIME, 1, sizeof(struct daemon_client));
+      struct daemon_client **new_clients =
+        alloc_realloc(ALLOC_RUNTIME, clients, sizeof(struct daemon_client *) * (nb_clients + 1));
+      struct pollfd *new_fds = alloc_realloc(ALLOC_RUNTIME, fds, sizeof(struct pollfd) * (nb_clients + 2));
+      if (new_clients) clients = new_clients;
+      if (new_fds) fds = new_fds;
+
+      if (!client || !new_clients || !new_fds) {
+        alloc_free(client);
+        close(fd);
+        continue;
+      }
+
+      fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+      client->fd = fd;
+      clients[nb_clients++] = client;
+    }
+  }
+
+  for (size_t k = 0; k < nb_clients; k++)
+    daemon_client_free(clients[k]);
+  alloc_free(clients);
+  alloc_free(fds);
+
+  s_sudoku_solver_free(sv);
+  close(listener);
+  unlink(path);
+  return status;
+}
+
+void daemon_stop() {
+  daemon_stopped = 1;
+}
+
+// ==========================
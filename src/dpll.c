@@ -1,7 +1,149 @@
+#define _POSIX_C_SOURCE 200809L
+
 #include <stdio.h>
 #include <stdbool.h>
 
+#include <stdint.h>
+#include <limits.h>
+#include <math.h>
+#include <string.h>
+
 #include "cnf.h"
+#include "dpll.h"
+#include "trace.h"
+#include "alloc.h"
+#include "util.h"
+
+
+// ===== USEFULL DEFINES =====
+
+// Reason of the decisions and of the litterals assigned at level 0
+#define DPLL_NO_REASON SIZE_MAX
+
+// A clause of the arena is its size, its flags and then its litterals
+#define DPLL_HEADER 2
+#define DPLL_LEARNT 1
+#define DPLL_DELETED 2
+#define DPLL_LBD_SHIFT 2
+
+// Literal block distance above which learnt clauses are all alike
+#define DPLL_MAX_LBD 32
+
+// Activities of the variables are divided by DPLL_VAR_DECAY at each conflict
+// (default of dpll_options)
+#define DPLL_VAR_DECAY 0.95
+
+// Conflicts between two restarts, times the luby sequence (default of
+// dpll_options)
+#define DPLL_RESTART_BASE 100
+
+// Learnt clauses kept before the first reduction, on top of clauses / 3
+#define DPLL_LEARNTS_MIN 1000
+
+// Variables propagated both ways by a lookahead, see s_dpll_lookahead
+#define DPLL_LOOKAHEAD_VARS 32
+
+// ===========================
+
+
+// ===== STRUCTS =====
+
+// Clause watching a litteral, blocker is another litteral of the clause
+// which, when true, saves a visit of the clause
+struct dpll_watch {
+  size_t clause;
+  int blocker;
+};
+
+struct dpll_watches {
+  struct dpll_watch *items;
+  size_t length;
+  size_t capacity;
+};
+
+/* Conflict driven clause learning solver with two watched litterals, VSIDS
+ * decisions, phase saving and luby restarts
+ *
+ * Every array is grown when needed and never shrunk, so a solver reset and
+ * loaded with a formula it has already seen does not allocate.
+ */
+typedef struct dpll {
+  size_t vars;              // Variables 1 to vars are used
+  size_t vars_capacity;
+
+  // Clauses one after the other, see DPLL_HEADER
+  int *arena;
+  size_t arena_length;
+  size_t arena_capacity;
+  size_t wasted;            // Size of the deleted clauses still in the arena
+  size_t clauses;           // Clauses and litterals given by the user
+  size_t litts;
+
+  size_t *learnts;          // Offsets of the learnt clauses in the arena
+  size_t learnts_length;
+  size_t learnts_capacity;
+  size_t max_learnts;       // Learnt clauses kept until the next reduction
+
+  // Indexed by variable
+  signed char *values;      // 1 true, -1 false, 0 unassigned
+  signed char *phases;      // Last value of the variable, tried first
+  char *seen;               // Marks of the conflict analysis
+  size_t *levels;
+  size_t *reasons;          // Clause which implied the variable
+  double *activities;
+  long *heap_index;         // Position in the heap, -1 when not in it
+
+  // Indexed by litteral (see util_litt_index)
+  struct dpll_watches *watches;
+
+  int *trail;               // Assigned litterals in order
+  size_t trail_length;
+  size_t qhead;             // Next litteral of the trail to propagate
+  size_t *trail_lims;       // Start of each decision level in the trail
+  size_t level;
+  char *flips;              // Indexed by level, its decision is flipped
+  size_t flipped;           // Highest flipped level, see dpll_flip
+
+  int *heap;                // Variables by decreasing activity
+  size_t heap_length;
+  double var_inc;
+
+  int *learnt;              // Clause being learnt (or added)
+  size_t learnt_length;
+  size_t *level_stamps;     // Marks of the levels to compute the lbd
+  size_t stamp;
+
+  // Assumptions of the current solve, the assumed first ones are true
+  const int *assumptions;
+  size_t assumptions_length;
+  size_t assumed;
+  int *core;                // Failed assumptions of the last solve
+  size_t core_length;
+  int activation;           // Assumed first when counting, see dpll_block
+  size_t blocked;           // Offset of the first clause of the count
+
+  // Formula saved by s_dpll_checkpoint, restored by s_dpll_rollback
+  bool checkpoint;
+  int *base_arena;
+  size_t base_arena_length;
+  size_t base_arena_capacity;
+  size_t base_clauses;
+  size_t base_litts;
+  size_t base_vars;
+  size_t base_trail_length;
+  bool base_unsat;
+
+  dpll_options options;     // See s_dpll_set_options
+  uint64_t random;          // State of the random choices
+
+  bool unsat;               // The empty clause was derived
+  signed char *model;       // Values of the last model found
+  bool modeled;             // model holds a model of the formula
+  bool failed;              // An allocation failed during the search
+  dpll_stats stats;         // Statistics of the last solve
+} *s_dpll;
+
+// ===================
 
 
 // ===== UTILITY FUNCTIONS =====
@@ -25,13 +167,13 @@ int get_unit_clause_litt(s_cnf cn) {
       // Get the litteral of the unit clause
       int litt = litts[0];
 
-      free(litts);
-      free(clauses);
+      alloc_free(litts);
+      alloc_free(clauses);
       return litt;
     }
   }
 
-  free(clauses);
+  alloc_free(clauses);
   return 0;
 }
 
@@ -66,18 +208,18 @@ int get_pure_litteral(s_cnf cn) {
         // If we checked every clauses then the litteral is pure
         bool is_last_clause = k == number_clauses - 1;
         if (is_last_clause) {
-          free(litts);
-          free(clauses);
+          alloc_free(litts);
+          alloc_free(clauses);
           return current_litt;
         }
       }
 
     }
 
-    free(litts);
+    alloc_free(litts);
   }
 
-  free(clauses);
+  alloc_free(clauses);
   return 0;
 }
 
@@ -87,7 +229,7 @@ bool cnf_is_empty(s_cnf cn) {
   size_t number_clauses = 0;
   size_t *clauses = s_cnf_get_clauses_ids(cn, &number_clauses);
 
-  free(clauses);
+  alloc_free(clauses);
   return number_clauses == 0;
 }
 
@@ -102,12 +244,12 @@ bool cnf_contains_empty_clause(s_cnf cn) {
     size_t clause = clauses[i];
 
     if (s_cnf_clause_empty(cn, clause)) {
-      free(clauses);
+      alloc_free(clauses);
       return true;
     }
   }
 
-  free(clauses);
+  alloc_free(clauses);
   return false;
 }
 
@@ -124,8 +266,8 @@ int cnf_choose_litteral(s_cnf cn) {
 
   int litt = litts[0];
 
-  free(litts);
-  free(clauses);
+  alloc_free(litts);
+  alloc_free(clauses);
   return litt;
 }
 
@@ -152,6 +294,8 @@ void unit_propagate(s_cnf cn, int litt) {
       s_cnf_clause_remove_litt(cn, clause, litt * -1);
     }
   }
+
+  alloc_free(clauses);
 }
 
 void pure_litteral_assign(s_cnf cn, int litt) {
@@ -167,10 +311,12 @@ void pure_litteral_assign(s_cnf cn, int litt) {
       s_cnf_remove_clause(cn, clause);
     }
   }
+
+  alloc_free(clauses);
 }
 
 void append_valuation(int **valuations, size_t *valuations_length, int litt) {
-  *valuations = realloc(*valuations, sizeof(int) * ++(*valuations_length));
+  *valuations = alloc_realloc(ALLOC_DPLL, *valuations, sizeof(int) * ++(*valuations_length));
   (*valuations)[*valuations_length - 1] = litt;
 }
 
@@ -179,25 +325,37 @@ void append_valuation(int **valuations, size_t *valuations_length, int litt) {
 
 // ===== MAIN FUNCTIONS =====
 
-bool dpll_internal(s_cnf cn) {
+bool dpll_internal(s_cnf cn, dpll_stats *stats, size_t depth) {
+  if (depth > stats->max_depth) stats->max_depth = depth;
+
+  TRACE_BEGIN("dpll", "propagate");
+
   // Unit propagation
   int unit_litt = 0;
   while ((unit_litt = get_unit_clause_litt(cn)) != 0) {
+    stats->propagations++;
     unit_propagate(cn, unit_litt);
   }
   // Pure literal elimination
   int pure_litt = 0;
   while ((pure_litt = get_pure_litteral(cn))) {
+    stats->pure_litterals++;
     pure_litteral_assign(cn, pure_litt);
   }
+  TRACE_END("dpll", "propagate");
+
   // Stopping conditions
   if (cnf_is_empty(cn)) {
     return true;
   }
   if (cnf_contains_empty_clause(cn)) {
+    TRACE_INSTANT("dpll", "conflict");
+    stats->conflicts++;
     return false;
   }
   // DPLL procedure
+  TRACE_INSTANT("dpll", "decide");
+  stats->decisions++;
   int litt = cnf_choose_litteral(cn);
   s_cnf cn_2 = s_cnf_copy(cn);
 
@@ -207,17 +365,28 @@ bool dpll_internal(s_cnf cn) {
   s_cnf_add_clause(cn, &litt1, 1);
   s_cnf_add_clause(cn_2, &litt2, 1);
 
-  bool result = dpll_internal(cn) || dpll_internal(cn_2);
+  bool result = dpll_internal(cn, stats, depth + 1);
+  if (!result) {
+    TRACE_INSTANT("dpll", "backtrack");
+    stats->backtracks++;
+    result = dpll_internal(cn_2, stats, depth + 1);
+  }
 
   s_cnf_free(cn_2);
 
   return result;
 }
 
-bool dpll_valuations_internal(s_cnf cn, int **valuations, size_t *valuations_length) {
+bool dpll_valuations_internal(s_cnf cn, int **valuations, size_t *valuations_length,
+                              dpll_stats *stats, size_t depth) {
+  if (depth > stats->max_depth) stats->max_depth = depth;
+
+  TRACE_BEGIN("dpll", "propagate");
+
   // Unit propagation
   int unit_litt = 0;
   while ((unit_litt = get_unit_clause_litt(cn)) != 0) {
+    stats->propagations++;
     if (unit_litt > 0)
       append_valuation(valuations, valuations_length, unit_litt);
     unit_propagate(cn, unit_litt);
@@ -225,18 +394,25 @@ bool dpll_valuations_internal(s_cnf cn, int **valuations, size_t *valuations_len
   // Pure literal elimination
   int pure_litt = 0;
   while ((pure_litt = get_pure_litteral(cn))) {
+    stats->pure_litterals++;
     if (pure_litt > 0)
       append_valuation(valuations, valuations_length, pure_litt);
     pure_litteral_assign(cn, pure_litt);
   }
+  TRACE_END("dpll", "propagate");
+
   // Stopping conditions
   if (cnf_is_empty(cn)) {
     return true;
   }
   if (cnf_contains_empty_clause(cn)) {
+    TRACE_INSTANT("dpll", "conflict");
+    stats->conflicts++;
     return false;
   }
   // DPLL procedure
+  TRACE_INSTANT("dpll", "decide");
+  stats->decisions++;
   int litt = cnf_choose_litteral(cn);
   s_cnf cn_2 = s_cnf_copy(cn);
 
@@ -246,8 +422,14 @@ bool dpll_valuations_internal(s_cnf cn, int **valuations, size_t *valuations_len
   s_cnf_add_clause(cn, &litt1, 1);
   s_cnf_add_clause(cn_2, &litt2, 1);
 
-  bool result = dpll_valuations_internal(cn, valuations, valuations_length)
-                || dpll_valuations_internal(cn_2, valuations, valuations_length);
+  bool result = dpll_valuations_internal(cn, valuations, valuations_length, stats,
+                                         depth + 1);
+  if (!result) {
+    TRACE_INSTANT("dpll", "backtrack");
+    stats->backtracks++;
+    result = dpll_valuations_internal(cn_2, valuations, valuations_length, stats,
+                                      depth + 1);
+  }
 
   s_cnf_free(cn_2);
 
@@ -260,8 +442,11 @@ bool dpll_valuations_internal(s_cnf cn, int **valuations, size_t *valuations_len
 // ==== BASE FUNCTIONS =====
 
 bool dpll(s_cnf cn) {
+  dpll_stats stats;
+  memset(&stats, 0, sizeof(stats));
+
   s_cnf cn_copy = s_cnf_copy(cn);
-  bool result = dpll_internal(cn_copy);
+  bool result = dpll_internal(cn_copy, &stats, 0);
 
   s_cnf_free(cn_copy);
 
@@ -269,12 +454,1444 @@ bool dpll(s_cnf cn) {
 }
 
 bool dpll_valuations(s_cnf cn, int **valuations, size_t *valuations_length) {
+  return dpll_valuations_stats(cn, valuations, valuations_length, NULL);
+}
+
+bool dpll_valuations_stats(s_cnf cn, int **valuations, size_t *valuations_length,
+                           dpll_stats *stats) {
+  dpll_stats local;
+  if (!stats) stats = &local;
+  memset(stats, 0, sizeof(dpll_stats));
+
+  double start = util_now();
+
+  stats->clauses = s_cnf_get_clauses_count(cn);
+  stats->litts = s_cnf_get_litts_count(cn);
+  stats->vars = s_cnf_get_vars_count(cn);
+
   s_cnf cn_copy = s_cnf_copy(cn);
-  bool result = dpll_valuations_internal(cn_copy, valuations, valuations_length);
+  bool result = dpll_valuations_internal(cn_copy, valuations, valuations_length, stats, 0);
 
   s_cnf_free(cn_copy);
 
+  stats->seconds = util_now() - start;
+
   return result;
 }
 
+void dpll_stats_add(dpll_stats *total, const dpll_stats *stats) {
+  if (!total || !stats) return;
+
+  total->decisions += stats->decisions;
+  total->propagations += stats->propagations;
+  total->pure_litterals += stats->pure_litterals;
+  total->conflicts += stats->conflicts;
+  total->backtracks += stats->backtracks;
+  if (stats->max_depth > total->max_depth) total->max_depth = stats->max_depth;
+  total->clauses += stats->clauses;
+  total->litts += stats->litts;
+  total->vars += stats->vars;
+  total->exported += stats->exported;
+  total->imported += stats->imported;
+  total->seconds += stats->seconds;
+}
+
 // =========================
+
+
+// ===== SOLVER UTILITY FUNCTIONS =====
+
+// Returns 1 if litt is true, -1 if it is false and 0 if it is unassigned
+signed char dpll_litt_value(s_dpll s, int litt) {
+  signed char value = s->values[abs(litt)];
+  return litt < 0 ? -value : value;
+}
+
+// Returns the next random number of s (xorshift64*)
+uint64_t dpll_random(s_dpll s) {
+  s->random ^= s->random >> 12;
+  s->random ^= s->random << 25;
+  s->random ^= s->random >> 27;
+  return s->random * 2685821657736338717ULL;
+}
+
+// Returns the first value tried for a new variable
+signed char dpll_initial_phase(s_dpll s) {
+  if (s->options.phase != 0) return s->options.phase;
+  return dpll_random(s) & 1 ? 1 : -1;
+}
+
+// Returns the activity of a new variable, the seed breaks the ties
+double dpll_initial_activity(s_dpll s) {
+  if (!s->options.seed) return 0;
+  return (dpll_random(s) >> 11) * 0x1p-53 * 1e-5;
+}
+
+void dpll_heap_up(s_dpll s, size_t pos) {
+  int var = s->heap[pos];
+  while (pos > 0) {
+    size_t parent = (pos - 1) / 2;
+    if (s->activities[s->heap[parent]] >= s->activities[var]) break;
+    s->heap[pos] = s->heap[parent];
+    s->heap_index[s->heap[pos]] = pos;
+    pos = parent;
+  }
+  s->heap[pos] = var;
+  s->heap_index[var] = pos;
+}
+
+void dpll_heap_down(s_dpll s, size_t pos) {
+  int var = s->heap[pos];
+  for (;;) {
+    size_t child = 2 * pos + 1;
+    if (child >= s->heap_length) break;
+    if (child + 1 < s->heap_length
+        && s->activities[s->heap[child + 1]] > s->activities[s->heap[child]])
+      child++;
+    if (s->activities[s->heap[child]] <= s->activities[var]) break;
+    s->heap[pos] = s->heap[child];
+    s->heap_index[s->heap[pos]] = pos;
+    pos = child;
+  }
+  s->heap[pos] = var;
+  s->heap_index[var] = pos;
+}
+
+void dpll_heap_insert(s_dpll s, int var) {
+  if (s->heap_index[var] != -1) return;
+  s->heap[s->heap_length] = var;
+  s->heap_index[var] = s->heap_length;
+  dpll_heap_up(s, s->heap_length++);
+}
+
+int dpll_heap_pop(s_dpll s) {
+  int var = s->heap[0];
+  s->heap_index[var] = -1;
+  if (--s->heap_length > 0) {
+    s->heap[0] = s->heap[s->heap_length];
+    s->heap_index[s->heap[0]] = 0;
+    dpll_heap_down(s, 0);
+  }
+  return var;
+}
+
+void dpll_heap_remove(s_dpll s, int var) {
+  long pos = s->heap_index[var];
+  if (pos == -1) return;
+
+  s->heap_index[var] = -1;
+  if ((size_t) pos == --s->heap_length) return;
+
+  int last = s->heap[s->heap_length];
+  s->heap[pos] = last;
+  s->heap_index[last] = pos;
+  dpll_heap_up(s, pos);
+  dpll_heap_down(s, s->heap_index[last]);
+}
+
+void dpll_bump(s_dpll s, int var) {
+  if ((s->activities[var] += s->var_inc) > 1e100) {
+    for (size_t v = 1; v <= s->vars; v++)
+      s->activities[v] *= 1e-100;
+    s->var_inc *= 1e-100;
+  }
+  if (s->heap_index[var] != -1) dpll_heap_up(s, s->heap_index[var]);
+}
+
+/* Makes room for the variables up to vars, the new ones are unassigned
+ *
+ * Returns 0 on success and -1 on failure
+ */
+int dpll_ensure_vars(s_dpll s, size_t vars) {
+  if (vars <= s->vars) return 0;
+
+  if (vars > s->vars_capacity) {
+    size_t capacity = s->vars_capacity ? s->vars_capacity : 16;
+    while (capacity < vars) capacity *= 2;
+
+    // One more slot as the variables start at 1
+    size_t n = capacity + 1;
+    void *arrays[] = {
+      alloc_realloc(ALLOC_DPLL, s->values, n),
+      alloc_realloc(ALLOC_DPLL, s->phases, n),
+      alloc_realloc(ALLOC_DPLL, s->seen, n),
+      alloc_realloc(ALLOC_DPLL, s->levels, n * sizeof(size_t)),
+      alloc_realloc(ALLOC_DPLL, s->reasons, n * sizeof(size_t)),
+      alloc_realloc(ALLOC_DPLL, s->activities, n * sizeof(double)),
+      alloc_realloc(ALLOC_DPLL, s->heap_index, n * sizeof(long)),
+      alloc_realloc(ALLOC_DPLL, s->watches, 2 * n * sizeof(struct dpll_watches)),
+      alloc_realloc(ALLOC_DPLL, s->trail, n * sizeof(int)),
+      alloc_realloc(ALLOC_DPLL, s->trail_lims, n * sizeof(size_t)),
+      alloc_realloc(ALLOC_DPLL, s->heap, n * sizeof(int)),
+      alloc_realloc(ALLOC_DPLL, s->learnt, n * sizeof(int)),
+      alloc_realloc(ALLOC_DPLL, s->level_stamps, n * sizeof(size_t)),
+      alloc_realloc(ALLOC_DPLL, s->core, n * sizeof(int)),
+      alloc_realloc(ALLOC_DPLL, s->model, n),
+      alloc_realloc(ALLOC_DPLL, s->flips, n),
+    };
+
+    // The arrays which could be grown are kept even on failure
+    if (arrays[0]) s->values = arrays[0];
+    if (arrays[1]) s->phases = arrays[1];
+    if (arrays[2]) s->seen = arrays[2];
+    if (arrays[3]) s->levels = arrays[3];
+    if (arrays[4]) s->reasons = arrays[4];
+    if (arrays[5]) s->activities = arrays[5];
+    if (arrays[6]) s->heap_index = arrays[6];
+    if (arrays[7]) s->watches = arrays[7];
+    if (arrays[8]) s->trail = arrays[8];
+    if (arrays[9]) s->trail_lims = arrays[9];
+    if (arrays[10]) s->heap = arrays[10];
+    if (arrays[11]) s->learnt = arrays[11];
+    if (arrays[12]) s->level_stamps = arrays[12];
+    if (arrays[13]) s->core = arrays[13];
+    if (arrays[14]) s->model = arrays[14];
+    if (arrays[15]) s->flips = arrays[15];
+
+    for (size_t k = 0; k < sizeof(arrays) / sizeof(arrays[0]); k++)
+      if (!arrays[k]) return -1;
+
+    // The watch lists keep their items from a formula to the next
+    size_t old = s->vars_capacity ? s->vars_capacity + 1 : 0;
+    memset(s->watches + 2 * old, 0, 2 * (n - old) * sizeof(struct dpll_watches));
+    memset(s->level_stamps + old, 0, (n - old) * sizeof(size_t));
+    s->vars_capacity = capacity;
+  }
+
+  for (size_t var = s->vars + 1; var <= vars; var++) {
+    s->values[var] = 0;
+    s->phases[var] = dpll_initial_phase(s);
+    s->seen[var] = 0;
+    s->levels[var] = 0;
+    s->reasons[var] = DPLL_NO_REASON;
+    s->activities[var] = dpll_initial_activity(s);
+    s->heap_index[var] = -1;
+    s->watches[2 * var].length = 0;
+    s->watches[2 * var + 1].length = 0;
+    dpll_heap_insert(s, var);
+  }
+
+  s->vars = vars;
+  return 0;
+}
+
+/* Checks that the length litterals litts are non zero and makes room for
+ * their variables
+ *
+ * Returns 0 on success and -1 on failure
+ */
+int dpll_ensure_litts(s_dpll s, const int *litts, size_t length) {
+  size_t vars = 0;
+  for (size_t k = 0; k < length; k++) {
+    if (litts[k] == 0 || litts[k] == INT_MIN) return -1;
+    if ((size_t) abs(litts[k]) > vars) vars = abs(litts[k]);
+  }
+  return dpll_ensure_vars(s, vars);
+}
+
+void dpll_assign(s_dpll s, int litt, size_t reason) {
+  int var = abs(litt);
+  s->values[var] = litt > 0 ? 1 : -1;
+  s->levels[var] = s->level;
+  s->reasons[var] = reason;
+  s->trail[s->trail_length++] = litt;
+}
+
+/* Unassigns every litteral above the decision level level
+ */
+void dpll_backtrack(s_dpll s, size_t level) {
+  if (s->level <= level) return;
+
+  for (size_t k = s->trail_length; k-- > s->trail_lims[level];) {
+    int var = abs(s->trail[k]);
+    s->phases[var] = s->values[var];
+    s->values[var] = 0;
+    s->reasons[var] = DPLL_NO_REASON;
+    dpll_heap_insert(s, var);
+  }
+
+  s->trail_length = s->trail_lims[level];
+  s->qhead = s->trail_length;
+  s->level = level;
+  s->assumed = 0;
+}
+
+void dpll_watch(s_dpll s, int litt, size_t clause, int blocker) {
+  struct dpll_watches *ws = &s->watches[util_litt_index(litt)];
+  if (util_grow(ALLOC_DPLL, (void **) &ws->items, &ws->capacity, ws->length + 1,
+                sizeof(struct dpll_watch)) == -1) {
+    s->failed = true;
+    return;
+  }
+  ws->items[ws->length].clause = clause;
+  ws->items[ws->length++].blocker = blocker;
+}
+
+/* Stores the clause of length litterals in the arena and watches its first
+ * two litterals, which must not be false
+ *
+ * Returns the offset of the clause and DPLL_NO_REASON on failure
+ */
+size_t dpll_new_clause(s_dpll s, const int *litts, size_t length, int flags) {
+  if (util_grow(ALLOC_DPLL, (void **) &s->arena, &s->arena_capacity,
+                s->arena_length + DPLL_HEADER + length, sizeof(int)) == -1)
+    return DPLL_NO_REASON;
+
+  size_t clause = s->arena_length;
+  s->arena[clause] = length;
+  s->arena[clause + 1] = flags;
+  memcpy(s->arena + clause + DPLL_HEADER, litts, length * sizeof(int));
+  s->arena_length += DPLL_HEADER + length;
+
+  dpll_watch(s, litts[0], clause, litts[1]);
+  dpll_watch(s, litts[1], clause, litts[0]);
+  return s->failed ? DPLL_NO_REASON : clause;
+}
+
+/* Propagates the litterals of the trail not propagated yet
+ *
+ * Returns the offset of a clause whose litterals are all false, or
+ * DPLL_NO_REASON when there is no conflict
+ */
+size_t dpll_propagate(s_dpll s) {
+  while (s->qhead < s->trail_length) {
+    int false_litt = -s->trail[s->qhead++];
+    struct dpll_watches *ws = &s->watches[util_litt_index(false_litt)];
+    struct dpll_watch *items = ws->items;
+    size_t i = 0, j = 0;
+
+    while (i < ws->length) {
+      struct dpll_watch w = items[i++];
+      if (dpll_litt_value(s, w.blocker) == 1) {
+        items[j++] = w;
+        continue;
+      }
+
+      // The false litteral is kept second
+      int *c = s->arena + w.clause + DPLL_HEADER;
+      if (c[0] == false_litt) {
+        c[0] = c[1];
+        c[1] = false_litt;
+      }
+
+      int blocker = w.blocker;
+      w.blocker = c[0];
+      if (c[0] != blocker && dpll_litt_value(s, c[0]) == 1) {
+        items[j++] = w;
+        continue;
+      }
+
+      // Look for another litteral to watch
+      size_t size = s->arena[w.clause];
+      bool moved = false;
+      for (size_t k = 2; k < size; k++) {
+        if (dpll_litt_value(s, c[k]) != -1) {
+          c[1] = c[k];
+          c[k] = false_litt;
+          dpll_watch(s, c[1], w.clause, c[0]);
+          moved = true;
+          break;
+        }
+      }
+      if (moved) continue;
+
+      // The clause is unit or false
+      items[j++] = w;
+      if (dpll_litt_value(s, c[0]) == -1) {
+        while (i < ws->length) items[j++] = items[i++];
+        ws->length = j;
+        s->qhead = s->trail_length;
+        return w.clause;
+      }
+
+      s->stats.propagations++;
+      dpll_assign(s, c[0], w.clause);
+    }
+
+    ws->length = j;
+  }
+
+  return DPLL_NO_REASON;
+}
+
+/* Learns from the conflict the first unique implication point clause, in
+ * s->learnt with its asserting litteral first and a litteral of the
+ * backtrack level second
+ *
+ * Returns the level to backtrack to
+ */
+size_t dpll_analyze(s_dpll s, size_t conflict) {
+  size_t paths = 0;
+  size_t index = s->trail_length;
+  size_t clause = conflict;
+  int p = 0;
+  s->learnt_length = 1;
+
+  do {
+    int *c = s->arena + clause + DPLL_HEADER;
+    size_t size = s->arena[clause];
+
+    // The first litteral of a reason is the one it implied
+    for (size_t k = p == 0 ? 0 : 1; k < size; k++) {
+      int var = abs(c[k]);
+      if (s->seen[var] || s->levels[var] == 0) continue;
+
+      s->seen[var] = 1;
+      dpll_bump(s, var);
+      if (s->levels[var] >= s->level) paths++;
+      else s->learnt[s->learnt_length++] = c[k];
+    }
+
+    while (!s->seen[abs(s->trail[--index])]);
+    p = s->trail[index];
+    clause = s->reasons[abs(p)];
+    s->seen[abs(p)] = 0;
+    paths--;
+  } while (paths > 0);
+
+  s->learnt[0] = -p;
+
+  // Drops the litterals implied by the other ones of the clause
+  for (size_t k = 1; k < s->learnt_length; k++) {
+    size_t reason = s->reasons[abs(s->learnt[k])];
+    if (reason == DPLL_NO_REASON) continue;
+
+    int *c = s->arena + reason + DPLL_HEADER;
+    size_t size = s->arena[reason];
+    bool redundant = true;
+    for (size_t l = 1; l < size && redundant; l++)
+      redundant = s->seen[abs(c[l])] || s->levels[abs(c[l])] == 0;
+    if (redundant) s->seen[abs(s->learnt[k])] = 2;
+  }
+
+  size_t length = 1;
+  for (size_t k = 1; k < s->learnt_length; k++) {
+    int var = abs(s->learnt[k]);
+    if (s->seen[var] == 1) s->learnt[length++] = s->learnt[k];
+    s->seen[var] = 0;
+  }
+  s->learnt_length = length;
+
+  if (length == 1) return 0;
+
+  // A litteral of the highest level is watched second
+  size_t max = 1;
+  for (size_t k = 2; k < length; k++)
+    if (s->levels[abs(s->learnt[k])] > s->levels[abs(s->learnt[max])]) max = k;
+
+  int tmp = s->learnt[1];
+  s->learnt[1] = s->learnt[max];
+  s->learnt[max] = tmp;
+  return s->levels[abs(s->learnt[1])];
+}
+
+// Returns the number of different levels of the litterals of s->learnt
+size_t dpll_learnt_lbd(s_dpll s) {
+  size_t lbd = 0;
+  s->stamp++;
+  for (size_t k = 0; k < s->learnt_length; k++) {
+    size_t level = s->levels[abs(s->learnt[k])];
+    if (s->level_stamps[level] != s->stamp) {
+      s->level_stamps[level] = s->stamp;
+      lbd++;
+    }
+  }
+  return lbd;
+}
+
+// Returns whether clause is the reason of the assignment of a variable
+bool dpll_locked(s_dpll s, size_t clause) {
+  int var = abs(s->arena[clause + DPLL_HEADER]);
+  return s->values[var] != 0 && s->reasons[var] == clause;
+}
+
+// Forgets the watches of the deleted clauses
+void dpll_unwatch_deleted(s_dpll s) {
+  for (size_t index = 2; index < 2 * (s->vars + 1); index++) {
+    struct dpll_watches *ws = &s->watches[index];
+    size_t j = 0;
+    for (size_t i = 0; i < ws->length; i++)
+      if (!(s->arena[ws->items[i].clause + 1] & DPLL_DELETED)) ws->items[j++] = ws->items[i];
+    ws->length = j;
+  }
+}
+
+/* Deletes about half of the learnt clauses, the ones with the highest
+ * literal block distance, except the binary ones and the reasons
+ */
+void dpll_reduce(s_dpll s) {
+  size_t counts[DPLL_MAX_LBD + 1] = {0};
+  for (size_t k = 0; k < s->learnts_length; k++)
+    counts[s->arena[s->learnts[k] + 1] >> DPLL_LBD_SHIFT]++;
+
+  // Every clause above threshold is deleted and quota of the clauses at
+  // threshold, the glue clauses (lbd <= 2) are kept
+  size_t target = s->learnts_length / 2, deleted = 0, threshold = DPLL_MAX_LBD;
+  while (threshold > 2 && deleted + counts[threshold] <= target)
+    deleted += counts[threshold--];
+  size_t quota = threshold > 2 ? target - deleted : 0;
+
+  size_t length = 0;
+  for (size_t k = 0; k < s->learnts_length; k++) {
+    size_t clause = s->learnts[k];
+    size_t lbd = s->arena[clause + 1] >> DPLL_LBD_SHIFT;
+    bool candidate = lbd > threshold || (lbd == threshold && quota > 0);
+
+    if (candidate && s->arena[clause] > 2 && !dpll_locked(s, clause)) {
+      if (lbd == threshold) quota--;
+      s->arena[clause + 1] |= DPLL_DELETED;
+      s->wasted += DPLL_HEADER + s->arena[clause];
+    } else {
+      s->learnts[length++] = clause;
+    }
+  }
+  s->learnts_length = length;
+
+  dpll_unwatch_deleted(s);
+  s->max_learnts += s->max_learnts / 10;
+}
+
+/* Watches again the first two litterals of every clause of the arena which
+ * is not deleted, and lists its learnt clauses
+ */
+void dpll_watch_all(s_dpll s) {
+  for (size_t index = 2; index < 2 * (s->vars + 1); index++)
+    s->watches[index].length = 0;
+
+  s->learnts_length = 0;
+  for (size_t clause = 0; clause < s->arena_length; clause += DPLL_HEADER + s->arena[clause]) {
+    if (s->arena[clause + 1] & DPLL_DELETED) continue;
+
+    int *c = s->arena + clause + DPLL_HEADER;
+    dpll_watch(s, c[0], clause, c[1]);
+    dpll_watch(s, c[1], clause, c[0]);
+    if (s->arena[clause + 1] & DPLL_LEARNT) s->learnts[s->learnts_length++] = clause;
+  }
+}
+
+// Returns the value of litt if it is assigned at level 0, 0 otherwise
+signed char dpll_root_value(s_dpll s, int litt) {
+  return s->levels[abs(litt)] == 0 ? dpll_litt_value(s, litt) : 0;
+}
+
+/* Compacts the arena once the propagation is done. The clauses satisfied at
+ * level 0 are deleted too and the litterals false at level 0 removed from
+ * the others. Above level 0 the reasons follow their clauses.
+ */
+void dpll_collect(s_dpll s) {
+  size_t from = 0, to = 0, blocked = s->blocked;
+
+  while (from < s->arena_length) {
+    if (from == s->blocked) blocked = to;
+    size_t clause = from, size = s->arena[from];
+    int flags = s->arena[from + 1];
+    int *c = s->arena + from + DPLL_HEADER;
+    from += DPLL_HEADER + size;
+    if (flags & DPLL_DELETED) continue;
+
+    size_t length = 0;
+    bool satisfied = false;
+    for (size_t k = 0; k < size && !satisfied; k++) {
+      signed char value = dpll_root_value(s, c[k]);
+      if (value == 1) satisfied = true;
+      else if (value == 0) length++;
+    }
+    if (satisfied) continue;
+
+    // Every clause not satisfied keeps at least two litterals, except the
+    // reasons of litterals assigned above the level of their clause (see
+    // dpll_flip) which are kept whole
+    if (length >= 2) {
+      length = 0;
+      for (size_t k = 0; k < size; k++)
+        if (dpll_root_value(s, c[k]) == 0) c[length++] = c[k];
+    } else {
+      length = size;
+    }
+
+    int var = abs(c[0]);
+    if (s->values[var] && s->levels[var] > 0 && s->reasons[var] == clause) s->reasons[var] = to;
+
+    memmove(s->arena + to + DPLL_HEADER, c, length * sizeof(int));
+    s->arena[to] = length;
+    s->arena[to + 1] = flags;
+    to += DPLL_HEADER + length;
+  }
+
+  if (s->blocked >= s->arena_length) blocked = to;
+  s->arena_length = to;
+  s->blocked = blocked;
+  s->wasted = 0;
+
+  size_t root = s->level > 0 ? s->trail_lims[0] : s->trail_length;
+  for (size_t k = 0; k < root; k++)
+    s->reasons[abs(s->trail[k])] = DPLL_NO_REASON;
+
+  dpll_watch_all(s);
+}
+
+/* Stores in s->core the assumptions which imply that the assumption litt
+ * is false, and litt itself
+ */
+void dpll_analyze_final(s_dpll s, int litt) {
+  s->core[0] = litt;
+  s->core_length = 1;
+  if (s->level == 0) return;
+
+  // Every decision is an assumption as they are decided first
+  s->seen[abs(litt)] = 1;
+  for (size_t k = s->trail_length; k-- > s->trail_lims[0];) {
+    int var = abs(s->trail[k]);
+    if (!s->seen[var]) continue;
+
+    size_t reason = s->reasons[var];
+    if (reason == DPLL_NO_REASON) {
+      s->core[s->core_length++] = s->trail[k];
+    } else {
+      int *c = s->arena + reason + DPLL_HEADER;
+      for (size_t l = 1; l < (size_t) s->arena[reason]; l++)
+        if (s->levels[abs(c[l])] > 0) s->seen[abs(c[l])] = 1;
+    }
+    s->seen[var] = 0;
+  }
+  s->seen[abs(litt)] = 0;
+}
+
+// Returns the x-th term of the luby sequence (1 1 2 1 1 2 4 1 ...)
+size_t dpll_luby(size_t x) {
+  size_t size = 1, seq = 0;
+  while (size < x + 1) {
+    seq++;
+    size = 2 * size + 1;
+  }
+  while (size - 1 != x) {
+    size = (size - 1) >> 1;
+    seq--;
+    x = x % size;
+  }
+  return (size_t) 1 << seq;
+}
+
+/* Adds s->learnt to the formula and asserts its first litteral
+ *
+ * Returns 0 on success and -1 on failure
+ */
+int dpll_learn(s_dpll s) {
+  size_t lbd = s->learnt_length == 1 ? 1 : dpll_learnt_lbd(s);
+  if (lbd > DPLL_MAX_LBD) lbd = DPLL_MAX_LBD;
+
+  // The clauses learnt from the blocking ones don't hold without them
+  if (s->options.export_clause && !s->activation) {
+    s->options.export_clause(s->learnt, s->learnt_length, lbd, s->options.sharing);
+    s->stats.exported++;
+  }
+
+  if (s->learnt_length == 1) {
+    dpll_assign(s, s->learnt[0], DPLL_NO_REASON);
+    return 0;
+  }
+
+  if (util_grow(ALLOC_DPLL, (void **) &s->learnts, &s->learnts_capacity, s->learnts_length + 1,
+                sizeof(size_t)) == -1)
+    return -1;
+
+  size_t clause = dpll_new_clause(s, s->learnt, s->learnt_length,
+                                  DPLL_LEARNT | lbd << DPLL_LBD_SHIFT);
+  if (clause == DPLL_NO_REASON) return -1;
+
+  s->learnts[s->learnts_length++] = clause;
+  dpll_assign(s, s->learnt[0], clause);
+  return 0;
+}
+
+/* Blocks the model of the trail with the clause of the negations of its
+ * decisions which are not assumptions, and of s->activation so the clause
+ * only holds while counting. The search goes on from the level of the
+ * second last decision, where the clause asserts the negation of the last.
+ *
+ * The clause is listed with the learnt ones with a lbd of 0, so it is never
+ * reduced, until dpll_unblock.
+ *
+ * Returns 1 when the model is blocked, 0 when the assumptions imply it so
+ * there is no other model and -1 on failure
+ */
+int dpll_block(s_dpll s) {
+  for (size_t k = 0; k < s->assumptions_length; k++)
+    s->seen[abs(s->assumptions[k])] = 1;
+  s->seen[s->activation] = 1;
+
+  // The assumptions are decided first so the other decisions are the last
+  s->learnt_length = 0;
+  for (size_t level = s->level; level > 0; level--) {
+    int decision = s->trail[s->trail_lims[level - 1]];
+    if (s->seen[abs(decision)]) break;
+    s->learnt[s->learnt_length++] = -decision;
+  }
+
+  for (size_t k = 0; k < s->assumptions_length; k++)
+    s->seen[abs(s->assumptions[k])] = 0;
+  s->seen[s->activation] = 0;
+
+  if (s->learnt_length == 0) return 0;
+
+  s->learnt[s->learnt_length++] = -s->activation;
+  dpll_backtrack(s, s->levels[abs(s->learnt[1])]);
+
+  if (util_grow(ALLOC_DPLL, (void **) &s->learnts, &s->learnts_capacity, s->learnts_length + 1,
+                sizeof(size_t)) == -1)
+    return -1;
+
+  size_t clause = dpll_new_clause(s, s->learnt, s->learnt_length, DPLL_LEARNT);
+  if (clause == DPLL_NO_REASON) return -1;
+
+  s->learnts[s->learnts_length++] = clause;
+  dpll_assign(s, s->learnt[0], clause);
+  return 1;
+}
+
+/* Deletes at level 0 the blocking clauses (see dpll_block) and the learnt
+ * ones which depend on them, which all contain the negation of
+ * s->activation and were stored since the start of the count, then the
+ * activation variable itself
+ */
+void dpll_unblock(s_dpll s) {
+  int activation = s->activation;
+
+  size_t length = 0;
+  for (size_t k = 0; k < s->learnts_length; k++) {
+    size_t clause = s->learnts[k];
+    int *c = s->arena + clause + DPLL_HEADER;
+    bool blocking = false;
+    for (size_t l = 0; l < (size_t) s->arena[clause] && !blocking && clause >= s->blocked; l++)
+      blocking = c[l] == -activation;
+
+    if (!blocking) {
+      s->learnts[length++] = clause;
+      continue;
+    }
+
+    s->arena[clause + 1] |= DPLL_DELETED;
+    s->wasted += DPLL_HEADER + s->arena[clause];
+
+    // Only the watches of the two first litterals are on the clause
+    for (size_t l = 0; l < 2; l++) {
+      struct dpll_watches *ws = &s->watches[util_litt_index(c[l])];
+      size_t j = 0;
+      for (size_t i = 0; i < ws->length; i++)
+        if (ws->items[i].clause != clause) ws->items[j++] = ws->items[i];
+      ws->length = j;
+    }
+  }
+  s->learnts_length = length;
+
+  // The activation only appears negated so, when it was learnt false, it
+  // implied nothing else
+  if (s->values[activation]) {
+    size_t k = 0;
+    while (abs(s->trail[k]) != activation) k++;
+    memmove(s->trail + k, s->trail + k + 1, (s->trail_length - k - 1) * sizeof(int));
+    s->trail_length--;
+    if (s->qhead > k) s->qhead--;
+    s->values[activation] = 0;
+  }
+
+  dpll_heap_remove(s, activation);
+  s->vars--;
+  s->activation = 0;
+}
+
+/* Goes to the next branch of an enumeration: the decision of the highest
+ * level which is neither flipped nor an assumption is replaced by its
+ * negation, the levels above it are dropped. The search never backtracks
+ * below the flipped level so the branches already explored are not
+ * explored again, without any clause blocking their models.
+ *
+ * Returns 1 when a decision is flipped and 0 when every decision is, so
+ * every model was found
+ */
+int dpll_flip(s_dpll s) {
+  for (size_t k = 0; k < s->assumptions_length; k++)
+    s->seen[abs(s->assumptions[k])] = 1;
+
+  size_t level = s->level;
+  while (level > 0 && s->flips[level] && !s->seen[abs(s->trail[s->trail_lims[level - 1]])])
+    level--;
+  int decision = level > 0 ? s->trail[s->trail_lims[level - 1]] : 0;
+  if (decision && s->seen[abs(decision)]) decision = 0;
+
+  for (size_t k = 0; k < s->assumptions_length; k++)
+    s->seen[abs(s->assumptions[k])] = 0;
+
+  if (!decision) return 0;
+
+  dpll_backtrack(s, level - 1);
+  s->trail_lims[s->level++] = s->trail_length;
+  s->flips[s->level] = 1;
+  s->flipped = s->level;
+  dpll_assign(s, -decision, DPLL_NO_REASON);
+  return 1;
+}
+
+/* Adds at level 0 the clauses given by the import callback of s (see
+ * dpll_options), as learnt clauses without their false litterals
+ *
+ * Returns 1 on success, 0 if the formula is found unsatisfiable and -1 on
+ * failure
+ */
+int dpll_import(s_dpll s) {
+  if (!s->options.import_clause || s->activation) return 1;
+
+  size_t length;
+  while ((length = s->options.import_clause(s->learnt, s->vars, s->options.sharing)) > 0) {
+    size_t kept = 0;
+    bool skipped = false;
+    for (size_t k = 0; k < length && !skipped; k++) {
+      int litt = s->learnt[k];
+      if (litt == 0 || litt == INT_MIN || (size_t) abs(litt) > s->vars) skipped = true;
+      else if (dpll_litt_value(s, litt) == 1) skipped = true;
+      else if (dpll_litt_value(s, litt) == 0) s->learnt[kept++] = litt;
+    }
+    if (skipped) continue;
+
+    s->stats.imported++;
+    if (kept == 0) {
+      s->unsat = true;
+      return 0;
+    }
+    if (kept == 1) {
+      dpll_assign(s, s->learnt[0], DPLL_NO_REASON);
+      continue;
+    }
+
+    if (util_grow(ALLOC_DPLL, (void **) &s->learnts, &s->learnts_capacity, s->learnts_length + 1,
+                  sizeof(size_t)) == -1)
+      return -1;
+
+    int lbd = kept < DPLL_MAX_LBD ? kept : DPLL_MAX_LBD;
+    size_t clause = dpll_new_clause(s, s->learnt, kept, DPLL_LEARNT | lbd << DPLL_LBD_SHIFT);
+    if (clause == DPLL_NO_REASON) return -1;
+    s->learnts[s->learnts_length++] = clause;
+  }
+
+  return 1;
+}
+
+// Returns the conflicts between the restart number restarts and the next one
+size_t dpll_restart_limit(s_dpll s, size_t restarts) {
+  if (s->options.restarts == DPLL_RESTARTS_NONE) return SIZE_MAX;
+  if (s->options.restarts == DPLL_RESTARTS_LUBY)
+    return dpll_luby(restarts) * s->options.restart_base;
+
+  double limit = s->options.restart_base * pow(1.5, restarts);
+  return limit < (double) SIZE_MAX / 2 ? (size_t) limit : SIZE_MAX;
+}
+
+// Returns whether the resolution of s was cancelled by another thread
+bool dpll_cancelled(s_dpll s) {
+  return s->options.cancel && __atomic_load_n(s->options.cancel, __ATOMIC_RELAXED);
+}
+
+/* Searches a model from level 0 until the formula is proven satisfiable or
+ * not
+ *
+ * Returns 1 if the formula is satisfiable, 0 if it is not and -1 on failure
+ */
+int dpll_search(s_dpll s) {
+  size_t restarts = 0, conflicts = 0;
+  size_t restart_limit = dpll_restart_limit(s, restarts);
+
+  int imported = s->level == 0 ? dpll_import(s) : 1;
+  if (imported != 1) return imported;
+
+  for (;;) {
+    size_t conflict = dpll_propagate(s);
+    if (s->failed) return -1;
+
+    if (conflict != DPLL_NO_REASON) {
+      TRACE_INSTANT("dpll", "conflict");
+      s->stats.conflicts++;
+      conflicts++;
+      if (s->level == 0) {
+        s->unsat = true;
+        return 0;
+      }
+      // Back to level 0, where every litteral of the trail is propagated
+      if (dpll_cancelled(s)) {
+        dpll_backtrack(s, 0);
+        return -1;
+      }
+
+      // Every model below the flipped decision of this level was found
+      if (s->level == s->flipped) {
+        if (dpll_flip(s) == 0) return 0;
+        continue;
+      }
+
+      // The litteral asserted by the clause learnt may be assigned above
+      // its level, to stay below the flipped decisions
+      size_t level = dpll_analyze(s, conflict);
+      TRACE_INSTANT("dpll", "backtrack");
+      s->stats.backtracks++;
+      dpll_backtrack(s, level < s->flipped ? s->flipped : level);
+      if (dpll_learn(s) == -1) return -1;
+
+      s->var_inc /= s->options.var_decay;
+      continue;
+    }
+
+    if (conflicts >= restart_limit && !s->flipped) {
+      dpll_backtrack(s, 0);
+      conflicts = 0;
+      restart_limit = dpll_restart_limit(s, ++restarts);
+      if (s->wasted > s->arena_length / 2) dpll_collect(s);
+      imported = dpll_import(s);
+      if (imported != 1) return imported;
+      continue;
+    }
+
+    if (s->learnts_length >= s->max_learnts) {
+      dpll_reduce(s);
+      if (s->flipped && s->wasted > s->arena_length / 2) dpll_collect(s);
+    }
+
+    // The activation of the blocking clauses and the assumptions are
+    // decided first, in order
+    int litt = 0;
+    if (s->activation) {
+      signed char value = s->values[s->activation];
+      if (value == -1) return 0;      // Every other model is blocked
+      if (value == 0) litt = s->activation;
+    }
+    while (s->assumed < s->assumptions_length && !litt) {
+      int assumption = s->assumptions[s->assumed];
+      signed char value = dpll_litt_value(s, assumption);
+      if (value == -1) {
+        s->stats.conflicts++;
+        dpll_analyze_final(s, assumption);
+        return 0;
+      }
+
+      if (value == 0) litt = assumption;
+      else s->assumed++;
+    }
+
+    // Every variable is assigned, the values are a model. The assigned
+    // variables are left in the heap, they are popped by the next decisions.
+    if (!litt && s->trail_length == s->vars) return 1;
+    if (!litt && s->options.random_decisions > 0 && s->heap_length > 0
+        && (dpll_random(s) >> 11) * 0x1p-53 < s->options.random_decisions) {
+      int var = s->heap[dpll_random(s) % s->heap_length];
+      if (!s->values[var]) litt = s->phases[var] > 0 ? var : -var;
+    }
+    while (s->heap_length > 0 && !litt) {
+      int var = dpll_heap_pop(s);
+      if (!s->values[var]) litt = s->phases[var] > 0 ? var : -var;
+    }
+    if (!litt) return 1;
+
+    TRACE_INSTANT("dpll", "decide");
+    s->stats.decisions++;
+    s->trail_lims[s->level++] = s->trail_length;
+    s->flips[s->level] = 0;
+    if (s->level > s->stats.max_depth) s->stats.max_depth = s->level;
+    dpll_assign(s, litt, DPLL_NO_REASON);
+  }
+}
+
+/* Starts a resolution of the formula of s under the assumptions
+ *
+ * Returns 0 on success and -1 on failure
+ */
+int dpll_begin(s_dpll s, const int *assumptions, size_t length) {
+  if (!s || (!assumptions && length > 0)) return -1;
+  if (dpll_ensure_litts(s, assumptions, length) == -1) return -1;
+
+  // The start of the resolution until dpll_end
+  memset(&s->stats, 0, sizeof(dpll_stats));
+  s->stats.seconds = util_now();
+  s->stats.clauses = s->clauses;
+  s->stats.litts = s->litts;
+  s->stats.vars = s->vars;
+
+  dpll_backtrack(s, 0);
+  s->modeled = false;
+  s->max_learnts = s->clauses / 3 + DPLL_LEARNTS_MIN;
+
+  s->assumptions = assumptions;
+  s->assumptions_length = length;
+  s->assumed = 0;
+  s->core_length = 0;
+  return 0;
+}
+
+/* Ends the resolution started by dpll_begin, with result 1 if a model was
+ * found, 0 if not and -1 on failure
+ */
+void dpll_end(s_dpll s, int result) {
+  s->modeled = result == 1;
+  s->assumptions = NULL;
+  s->assumptions_length = 0;
+  if (result == 0) s->stats.conflicts += s->stats.conflicts == 0;
+
+  s->stats.seconds = util_now() - s->stats.seconds;
+}
+
+// Keeps the values of the trail, a model, for s_dpll_value
+void dpll_save_model(s_dpll s) {
+  memcpy(s->model + 1, s->values + 1, s->vars);
+}
+
+/* Marks in seen the unassigned variables of the shortest clauses of the
+ * formula (not learnt) which are not satisfied, at most DPLL_LOOKAHEAD_VARS
+ * of them, and stores them in s->learnt
+ *
+ * Returns the number of variables marked
+ */
+size_t dpll_lookahead_candidates(s_dpll s) {
+  size_t shortest = SIZE_MAX, candidates = 0;
+
+  for (size_t clause = 0; clause < s->arena_length;) {
+    size_t size = s->arena[clause];
+    int flags = s->arena[clause + 1];
+    int *c = s->arena + clause + DPLL_HEADER;
+    clause += DPLL_HEADER + size;
+    if (flags & (DPLL_LEARNT | DPLL_DELETED)) continue;
+
+    size_t unassigned = 0;
+    bool satisfied = false;
+    for (size_t k = 0; k < size && !satisfied; k++) {
+      signed char value = dpll_litt_value(s, c[k]);
+      if (value == 1) satisfied = true;
+      else if (value == 0) unassigned++;
+    }
+    if (satisfied || unassigned < 2 || unassigned > shortest) continue;
+
+    // A shorter clause replaces the candidates found so far
+    if (unassigned < shortest) {
+      for (size_t k = 0; k < candidates; k++) s->seen[s->learnt[k]] = 0;
+      candidates = 0;
+      shortest = unassigned;
+    }
+
+    for (size_t k = 0; k < size && candidates < DPLL_LOOKAHEAD_VARS; k++) {
+      int var = abs(c[k]);
+      if (s->values[var] || s->seen[var]) continue;
+      s->seen[var] = 1;
+      s->learnt[candidates++] = var;
+    }
+  }
+
+  return candidates;
+}
+
+/* Assigns litt at a new decision level and propagates it
+ *
+ * Returns the number of variables assigned, 0 on a conflict
+ */
+size_t dpll_probe(s_dpll s, int litt) {
+  size_t start = s->trail_length;
+  s->trail_lims[s->level++] = start;
+  dpll_assign(s, litt, DPLL_NO_REASON);
+
+  size_t assigned = dpll_propagate(s) == DPLL_NO_REASON ? s->trail_length - start : 0;
+  dpll_backtrack(s, s->level - 1);
+  return assigned;
+}
+
+// ====================================
+
+
+// ===== SOLVER =====
+
+s_dpll s_dpll_create() {
+  s_dpll s = alloc_calloc(ALLOC_DPLL, 1, sizeof(struct dpll));
+  if (!s) return NULL;
+
+  s->var_inc = 1;
+  dpll_options options;
+  dpll_default_options(&options);
+  s_dpll_set_options(s, &options);
+  return s;
+}
+
+void s_dpll_free(s_dpll s) {
+  if (!s) return;
+
+  for (size_t index = 0; index < 2 * (s->vars_capacity + 1) && s->watches; index++)
+    alloc_free(s->watches[index].items);
+
+  alloc_free(s->arena);
+  alloc_free(s->base_arena);
+  alloc_free(s->learnts);
+  alloc_free(s->values);
+  alloc_free(s->phases);
+  alloc_free(s->seen);
+  alloc_free(s->levels);
+  alloc_free(s->reasons);
+  alloc_free(s->activities);
+  alloc_free(s->heap_index);
+  alloc_free(s->watches);
+  alloc_free(s->trail);
+  alloc_free(s->trail_lims);
+  alloc_free(s->heap);
+  alloc_free(s->learnt);
+  alloc_free(s->level_stamps);
+  alloc_free(s->core);
+  alloc_free(s->model);
+  alloc_free(s->flips);
+  alloc_free(s);
+}
+
+void s_dpll_reset(s_dpll s) {
+  if (!s) return;
+
+  // The variables are initialized again when they are used
+  s->vars = 0;
+  s->arena_length = 0;
+  s->wasted = 0;
+  s->clauses = 0;
+  s->litts = 0;
+  s->learnts_length = 0;
+  s->trail_length = 0;
+  s->qhead = 0;
+  s->level = 0;
+  s->heap_length = 0;
+  s->var_inc = 1;
+  s->checkpoint = false;
+  s->core_length = 0;
+  s->unsat = false;
+  s->modeled = false;
+  s->failed = false;
+}
+
+void dpll_default_options(dpll_options *options) {
+  if (!options) return;
+
+  memset(options, 0, sizeof(dpll_options));
+  options->phase = -1;      // Most variables of a formula are false
+  options->restarts = DPLL_RESTARTS_LUBY;
+  options->restart_base = DPLL_RESTART_BASE;
+  options->var_decay = DPLL_VAR_DECAY;
+}
+
+void dpll_portfolio_options(size_t k, dpll_options *options) {
+  if (!options) return;
+
+  dpll_default_options(options);
+  if (k == 0) return;
+
+  // Configurations known to suit different formulas, then the same ones with
+  // other seeds
+  static const struct {
+    int phase;
+    double random_decisions;
+    dpll_restarts restarts;
+    size_t restart_base;
+    double var_decay;
+  } configurations[] = {
+    {-1, 0.02, DPLL_RESTARTS_LUBY, 512, 0.95},
+    {1, 0, DPLL_RESTARTS_GEOMETRIC, 100, 0.95},
+    {0, 0.01, DPLL_RESTARTS_LUBY, 100, 0.85},
+    {-1, 0, DPLL_RESTARTS_NONE, 0, 0.99},
+    {-1, 0.05, DPLL_RESTARTS_GEOMETRIC, 300, 0.9},
+    {0, 0, DPLL_RESTARTS_LUBY, 50, 0.95},
+    {1, 0.02, DPLL_RESTARTS_LUBY, 200, 0.8},
+  };
+  size_t count = sizeof(configurations) / sizeof(configurations[0]);
+
+  options->seed = k;
+  options->phase = configurations[(k - 1) % count].phase;
+  options->random_decisions = configurations[(k - 1) % count].random_decisions;
+  options->restarts = configurations[(k - 1) % count].restarts;
+  options->restart_base = configurations[(k - 1) % count].restart_base;
+  options->var_decay = configurations[(k - 1) % count].var_decay;
+}
+
+int s_dpll_set_options(s_dpll s, const dpll_options *options) {
+  if (!s || !options || options->phase < -1 || options->phase > 1
+      || options->random_decisions < 0 || options->random_decisions > 1
+      || options->var_decay <= 0 || options->var_decay >= 1
+      || (options->restarts != DPLL_RESTARTS_NONE && options->restart_base == 0))
+    return -1;
+
+  s->options = *options;
+
+  // A zero state would stay zero
+  s->random = 0x9e3779b97f4a7c15ULL * (options->seed + 1);
+  return 0;
+}
+
+void s_dpll_get_options(s_dpll s, dpll_options *options) {
+  if (s && options) *options = s->options;
+}
+
+int s_dpll_checkpoint(s_dpll s) {
+  if (!s) return -1;
+
+  dpll_backtrack(s, 0);
+  if (util_grow(ALLOC_DPLL, (void **) &s->base_arena, &s->base_arena_capacity, s->arena_length,
+                sizeof(int)) == -1)
+    return -1;
+
+  memcpy(s->base_arena, s->arena, s->arena_length * sizeof(int));
+  s->base_arena_length = s->arena_length;
+  s->base_clauses = s->clauses;
+  s->base_litts = s->litts;
+  s->base_vars = s->vars;
+  s->base_trail_length = s->trail_length;
+  s->base_unsat = s->unsat;
+  s->checkpoint = true;
+  return 0;
+}
+
+int s_dpll_rollback(s_dpll s) {
+  if (!s || !s->checkpoint) return -1;
+
+  dpll_backtrack(s, 0);
+  for (size_t k = s->base_trail_length; k < s->trail_length; k++) {
+    int var = abs(s->trail[k]);
+    s->values[var] = 0;
+    s->reasons[var] = DPLL_NO_REASON;
+  }
+  s->trail_length = s->base_trail_length;
+  s->qhead = 0;
+
+  // The arena is never smaller than its saved copy
+  memcpy(s->arena, s->base_arena, s->base_arena_length * sizeof(int));
+  s->arena_length = s->base_arena_length;
+  s->wasted = 0;
+  s->clauses = s->base_clauses;
+  s->litts = s->base_litts;
+  s->vars = s->base_vars;
+  s->unsat = s->base_unsat;
+  s->modeled = false;
+  s->failed = false;
+
+  // The search starts again as in a new solver
+  s->var_inc = 1;
+  s->heap_length = 0;
+  for (size_t var = 1; var <= s->vars; var++) {
+    s->phases[var] = dpll_initial_phase(s);
+    s->activities[var] = dpll_initial_activity(s);
+    s->heap_index[var] = -1;
+    dpll_heap_insert(s, var);
+  }
+
+  dpll_watch_all(s);
+  return s->failed ? -1 : 0;
+}
+
+int s_dpll_add_clause(s_dpll s, const int *litts, size_t length) {
+  if (!s || (!litts && length > 0)) return -1;
+  if (dpll_ensure_litts(s, litts, length) == -1) return -1;
+
+  dpll_backtrack(s, 0);
+  s->modeled = false;
+  s->clauses++;
+  s->litts += length;
+  if (s->unsat) return 0;
+
+  // Removes the false and repeated litterals, marked 1 when positive and
+  // 2 when negative in seen
+  size_t kept = 0;
+  bool satisfied = false;
+  for (size_t k = 0; k < length && !satisfied; k++) {
+    int var = abs(litts[k]);
+    char mark = litts[k] > 0 ? 1 : 2;
+    signed char value = dpll_litt_value(s, litts[k]);
+
+    if (value == 1 || s->seen[var] == 3 - mark) satisfied = true;
+    else if (value == 0 && s->seen[var] != mark) {
+      s->seen[var] = mark;
+      s->learnt[kept++] = litts[k];
+    }
+  }
+  for (size_t k = 0; k < kept; k++)
+    s->seen[abs(s->learnt[k])] = 0;
+
+  if (satisfied) return 0;
+  if (kept == 0) {
+    s->unsat = true;
+    return 0;
+  }
+  if (kept == 1) {
+    dpll_assign(s, s->learnt[0], DPLL_NO_REASON);
+    return 0;
+  }
+
+  return dpll_new_clause(s, s->learnt, kept, 0) == DPLL_NO_REASON ? -1 : 0;
+}
+
+int s_dpll_add_cnf(s_dpll s, s_cnf cn) {
+  if (!s || !cn) return -1;
+
+  size_t clauses_length = 0;
+  size_t *clauses = s_cnf_get_clauses_ids(cn, &clauses_length);
+  if (!clauses && clauses_length > 0) return -1;
+
+  int status = 0;
+  for (size_t k = 0; k < clauses_length && status == 0; k++) {
+    size_t length = 0;
+    int *litts = s_cnf_clause_get_litts(cn, clauses[k], &length);
+    if (!litts && length > 0) status = -1;
+    else status = s_dpll_add_clause(s, litts, length);
+    alloc_free(litts);
+  }
+
+  alloc_free(clauses);
+  return status;
+}
+
+int s_dpll_solve(s_dpll s) {
+  return s_dpll_solve_assuming(s, NULL, 0);
+}
+
+int s_dpll_solve_assuming(s_dpll s, const int *assumptions, size_t length) {
+  if (dpll_begin(s, assumptions, length) == -1) return -1;
+
+  int result = s->unsat ? 0 : dpll_search(s);
+  if (result == 1) dpll_save_model(s);
+
+  dpll_end(s, result);
+  return result;
+}
+
+int s_dpll_lookahead(s_dpll s, const int *assumptions, size_t length) {
+  if (!s || (!assumptions && length > 0)) return -1;
+  if (dpll_ensure_litts(s, assumptions, length) == -1) return -1;
+
+  dpll_backtrack(s, 0);
+  s->modeled = false;
+  if (s->unsat || s->vars == 0) return 0;
+  if (dpll_propagate(s) != DPLL_NO_REASON) {
+    s->unsat = true;
+    return 0;
+  }
+
+  // Every assumption at level 1, the probes above
+  s->trail_lims[s->level++] = s->trail_length;
+  bool conflict = false;
+  for (size_t k = 0; k < length && !conflict; k++) {
+    signed char value = dpll_litt_value(s, assumptions[k]);
+    if (value == 0) {
+      dpll_assign(s, assumptions[k], DPLL_NO_REASON);
+      conflict = dpll_propagate(s) != DPLL_NO_REASON;
+    }
+    conflict |= value == -1;
+  }
+
+  size_t candidates = conflict ? 0 : dpll_lookahead_candidates(s);
+  double best_score = 0;
+  int best = 0;
+
+  // A litteral whose propagation fails is a failed litteral: its negation
+  // is implied by the assumptions and is propagated at their level
+  for (size_t k = 0; k < candidates; k++) {
+    int var = s->learnt[k];
+    s->seen[var] = 0;
+    if (conflict || s->values[var]) continue;
+
+    size_t positive = dpll_probe(s, var), negative = dpll_probe(s, -var);
+    if (positive == 0 || negative == 0) {
+      if (positive == 0 && negative == 0) {
+        conflict = true;
+        continue;
+      }
+      dpll_assign(s, positive == 0 ? -var : var, DPLL_NO_REASON);
+      conflict = dpll_propagate(s) != DPLL_NO_REASON;
+      continue;
+    }
+
+    // Both cubes should be much simpler than the formula
+    double score = (double) positive * negative;
+    if (score > best_score) {
+      best_score = score;
+      best = var;
+    }
+  }
+
+  if (best && s->values[best]) best = 0;
+  dpll_backtrack(s, 0);
+  return conflict ? 0 : best;
+}
+
+long s_dpll_count_assuming(s_dpll s, const int *assumptions, size_t length, size_t limit) {
+  if (limit == 0 || dpll_begin(s, assumptions, length) == -1) return -1;
+
+  // A new variable activates the blocking clauses, it is removed with them
+  if (limit > 1) {
+    if (dpll_ensure_vars(s, s->vars + 1) == -1) return -1;
+    s->activation = s->vars;
+    s->blocked = s->arena_length;
+  }
+
+  long found = 0;
+  int result = s->unsat ? 0 : dpll_search(s);
+  while (result == 1) {
+    if (found++ == 0) dpll_save_model(s);
+    if ((size_t) found == limit) break;
+
+    result = dpll_block(s);
+    if (result == 1) result = dpll_search(s);
+  }
+
+  if (s->activation) {
+    dpll_backtrack(s, 0);
+    dpll_unblock(s);
+  }
+  if (found > 0) s->core_length = 0;
+
+  dpll_end(s, result == -1 ? -1 : found > 0);
+  return result == -1 ? -1 : found;
+}
+
+long s_dpll_enumerate_assuming(s_dpll s, const int *assumptions, size_t length,
+                               dpll_model_callback callback, void *ctx) {
+  if (!callback || dpll_begin(s, assumptions, length) == -1) return -1;
+
+  long found = 0;
+  int result = s->unsat ? 0 : dpll_search(s);
+  while (result == 1) {
+    found++;
+    dpll_save_model(s);
+    s->modeled = true;
+    if (callback(s, ctx) != 0) break;
+
+    result = dpll_flip(s);
+    if (result == 1) result = dpll_search(s);
+  }
+
+  s->flipped = 0;
+  if (found > 0) s->core_length = 0;
+
+  dpll_end(s, result == -1 ? -1 : found > 0);
+  return result == -1 ? -1 : found;
+}
+
+// ==================
+
+
+// ===== SOLVER GETTERS =====
+
+int s_dpll_value(s_dpll s, int var) {
+  if (!s || !s->modeled || var <= 0 || (size_t) var > s->vars) return -1;
+  return s->model[var] > 0;
+}
+
+size_t s_dpll_vars(s_dpll s) {
+  if (!s) return 0;
+  return s->vars;
+}
+
+const int *s_dpll_get_core(s_dpll s, size_t *length) {
+  if (!s || !length) return NULL;
+  *length = s->core_length;
+  return s->core;
+}
+
+void s_dpll_get_stats(s_dpll s, dpll_stats *stats) {
+  if (!s || !stats) return;
+  *stats = s->stats;
+}
+
+// ==========================
@@ -1,48 +1,195 @@
+#define _GNU_SOURCE
+
 #include <stdio.h>
 #include <stdlib.h>
+#include <stdbool.h>
+
+#include <string.h>
+#include <unistd.h>
+#include <getopt.h>
 
 #include "sudoku.h"
-#include "cnf.h"
+#include "sudoku_writer.h"
 #include "sudoku_cnf.h"
-#include "dpll.h"
+#include "batch.h"
+#include "pipeline.h"
+#include "daemon.h"
+#include "trace.h"
+#include "alloc.h"
 
 void usage(char *exec) {
-  printf("%s <filename>\n", exec);
+  printf("%s [-f format [--preprocess] | --count] [-j threads [--portfolio solvers\n"
+         "    [--conquer]] | -p [-v]] [--stats] [-t trace] <filename>...\n", exec);
+  printf("%s [-t trace] -d | -s <socket>\n", exec);
+  printf("    each file may contain any number of grids (see sudoku_stream.h)\n");
+  printf("    use - to read the grids from the standard input\n");
+  printf("    -f, --format format : output format of the solutions\n");
+  printf("        pretty    : grid and solution drawn with boxes (default)\n");
+  printf("        semicolon : solution in the input format of the files\n");
+  printf("        line      : solution on a single line\n");
+  printf("      Unsolvable grids are reported by the line 'unsolvable' in the\n");
+  printf("      semicolon and line formats.\n");
+  printf("    --preprocess : simplify the formula of each grid with its values before\n");
+  printf("      solving it (see preprocess.h), not with --count nor -p\n");
+  printf("    --count : print the number of solutions of each grid instead, counted\n");
+  printf("      without enumerating them (see count.h), not with -p\n");
+  printf("    -j, --jobs threads : number of grids solved in parallel (default 1,\n");
+  printf("      0 for one per core), the output stays in the input order\n");
+  printf("    --portfolio solvers : each grid is solved by solvers sat solvers with\n");
+  printf("      different configurations racing in their own threads, the first\n");
+  printf("      to finish cancels the others (see portfolio.h), not with -p\n");
+  printf("    --conquer : with --portfolio, the solvers share the search of each grid\n");
+  printf("      split into cubes instead of racing (cube-and-conquer)\n");
+  printf("    -p, --pipeline : parse, encode, solve and write the grids on their\n");
+  printf("      own threads connected by bounded queues (see pipeline.h)\n");
+  printf("    -v, --verbose : with -p, print the statistics of the stages as JSON\n");
+  printf("      on the standard error\n");
+  printf("    --stats : print the statistics of the resolutions (decisions,\n");
+  printf("      conflicts, time per phase, allocations, ...) as JSON on the\n");
+  printf("      standard error\n");
+  printf("    -d, --daemon : daemon answering requests read from the standard\n");
+  printf("      input, one grid per line (see daemon.h)\n");
+  printf("    -s, --socket socket : same as -d on the unix domain socket\n");
+  printf("    -t, --trace trace : records the phases of the resolution in the file\n");
+  printf("      trace, in the Chrome trace event format (needs cmake\n");
+  printf("      -DSUDOKUSAT_TRACE=ON)\n");
+  printf("    --cache directory : keeps the encoded rules of sudoku of each size in\n");
+  printf("      files of directory, reused by the next runs\n");
 }
 
-int main(int argc, char *argv[]) {
-  if (argc != 2) {
-    usage(argv[0]);
-    exit(EXIT_FAILURE);
+/* Solves the grids of the files and writes the results to the standard output
+ *
+ * Returns 0 on success and -1 on failure
+ */
+int solve_files(char **filenames, size_t count, batch_options options,
+                bool pipeline, bool verbose) {
+  s_sudoku_writer w = s_sudoku_writer_create(stdout, SUDOKU_WRITER_CAPACITY);
+  if (!w) return -1;
+
+  int r;
+  if (pipeline) {
+    pipeline_options p_options = {PIPELINE_QUEUE_CAPACITY, options.format, options.stats};
+    pipeline_stats stats;
+    r = pipeline_solve(filenames, count, w, p_options, &stats);
+    if (verbose) pipeline_stats_print(stderr, &stats);
+  } else {
+    r = batch_solve(filenames, count, w, options);
   }
 
-  s_sudoku g = s_sudoku_create_from_file(argv[1]);
-  if (!g) return EXIT_FAILURE;
+  if (s_sudoku_writer_flush(w) == -1) r = -1;
+  s_sudoku_writer_free(w);
+  return r;
+}
 
-  s_sudoku_print(stdout, g);
+int main(int argc, char *argv[]) {
+  batch_options options = {1, SUDOKU_FORMAT_PRETTY, NULL, false, 1, false, false};
+  bool daemon = false;
+  char *socket_path = NULL;
+  bool pipeline = false;
+  bool verbose = false;
+  char *trace_path = NULL;
+  char *cache_path = NULL;
+  sudoku_stats stats;
+  memset(&stats, 0, sizeof(stats));
 
-  s_cnf cn = sudoku_to_cnf(g);
-  if (!cn) return EXIT_FAILURE;
+  // Long only options have no short equivalent
+  enum { OPT_STATS = 256, OPT_CACHE, OPT_COUNT, OPT_PORTFOLIO, OPT_CONQUER,
+         OPT_PREPROCESS };
 
-  // s_cnf_print(cn);
+  struct option long_options[] = {
+    {"format", required_argument, NULL, 'f'},
+    {"jobs", required_argument, NULL, 'j'},
+    {"pipeline", no_argument, NULL, 'p'},
+    {"verbose", no_argument, NULL, 'v'},
+    {"daemon", no_argument, NULL, 'd'},
+    {"socket", required_argument, NULL, 's'},
+    {"trace", required_argument, NULL, 't'},
+    {"stats", no_argument, NULL, OPT_STATS},
+    {"cache", required_argument, NULL, OPT_CACHE},
+    {"count", no_argument, NULL, OPT_COUNT},
+    {"portfolio", required_argument, NULL, OPT_PORTFOLIO},
+    {"conquer", no_argument, NULL, OPT_CONQUER},
+    {"preprocess", no_argument, NULL, OPT_PREPROCESS},
+    {NULL, 0, NULL, 0}
+  };
 
-  int *valuations = NULL;
-  size_t valuations_length = 0;
+  int opt;
+  while ((opt = getopt_long(argc, argv, "f:j:pvds:t:", long_options, NULL)) != -1) {
+    if (opt == 'f' && strcmp(optarg, "pretty") == 0) {
+      options.format = SUDOKU_FORMAT_PRETTY;
+    } else if (opt == 'f' && strcmp(optarg, "semicolon") == 0) {
+      options.format = SUDOKU_FORMAT_SEMICOLON;
+    } else if (opt == 'f' && strcmp(optarg, "line") == 0) {
+      options.format = SUDOKU_FORMAT_LINE;
+    } else if (opt == 'j' && atoi(optarg) >= 0) {
+      options.threads = atoi(optarg);
+    } else if (opt == 'p') {
+      pipeline = true;
+    } else if (opt == 'v') {
+      verbose = true;
+    } else if (opt == 'd') {
+      daemon = true;
+    } else if (opt == 's') {
+      socket_path = optarg;
+    } else if (opt == 't') {
+      trace_path = optarg;
+    } else if (opt == OPT_STATS) {
+      options.stats = &stats;
+    } else if (opt == OPT_CACHE) {
+      cache_path = optarg;
+    } else if (opt == OPT_COUNT) {
+      options.count = true;
+    } else if (opt == OPT_PORTFOLIO && atoi(optarg) > 0) {
+      options.portfolio = atoi(optarg);
+    } else if (opt == OPT_CONQUER) {
+      options.conquer = true;
+    } else if (opt == OPT_PREPROCESS) {
+      options.preprocess = true;
+    } else {
+      usage(argv[0]);
+      exit(EXIT_FAILURE);
+    }
+  }
 
-  printf("Can be solved ? : %d\n", dpll_valuations(cn, &valuations, &valuations_length));
+  bool files = argc - optind >= 1;
+  if ((daemon && socket_path) || ((daemon || socket_path) == files)
+      || (verbose && !pipeline) || (options.stats && !files)
+      || ((options.count || options.portfolio > 1) && pipeline)
+      || (options.conquer && options.portfolio <= 1)
+      || (options.preprocess && (options.count || pipeline))) {
+    usage(argv[0]);
+    exit(EXIT_FAILURE);
+  }
 
-  printf("Solved grid :\n");
+  if (options.stats) alloc_set_counting(true);
 
-  for (int i = 0; i < valuations_length; i++) {
-    int litt = valuations[i];
-    sat_var v = litt_to_sat_var(g, litt);
-    // printf("i: %d ; j: %d ; v : %d ; litt : x%d\n", v.i, v.j, v.value, litt);
-    s_sudoku_set_cell_value(g, v.i, v.j, v.value);
+  if (cache_path && sudoku_set_rules_cache(cache_path) == -1) {
+    fprintf(stderr, "%s: can't use the cache\n", cache_path);
+    exit(EXIT_FAILURE);
   }
 
-  s_sudoku_print(stdout, g);
+  if (trace_path && trace_start(trace_path) == -1) {
+    if (!trace_available())
+      fprintf(stderr, "tracing is not compiled in (cmake -DSUDOKUSAT_TRACE=ON)\n");
+    else
+      fprintf(stderr, "%s: can't start the trace\n", trace_path);
+    exit(EXIT_FAILURE);
+  }
+
+  int r;
+  if (daemon)
+    r = daemon_run_stream(stdin, stdout);
+  else if (socket_path)
+    r = daemon_run_socket(socket_path);
+  else
+    r = solve_files(argv + optind, argc - optind, options, pipeline, verbose);
+
+  if (options.stats) sudoku_stats_print(stderr, options.stats);
+
+  if (trace_path && trace_stop() == -1) {
+    fprintf(stderr, "%s: can't write the trace\n", trace_path);
+    r = -1;
+  }
 
-  s_cnf_free(cn);
-  s_sudoku_free(g);
-  return EXIT_SUCCESS;
+  return r == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
 }
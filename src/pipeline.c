@@ -0,0 +1,401 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+
+#include <string.h>
+#include <time.h>
+#include <sched.h>
+#include <pthread.h>
+
+#include "sudoku.h"
+#include "sudoku_stream.h"
+#include "sudoku_writer.h"
+#include "sudoku_cnf.h"
+#include "spsc_queue.h"
+#include "batch.h"
+#include "pipeline.h"
+#include "alloc.h"
+#include "util.h"
+
+
+// ===== STRUCTS =====
+
+// A grid going through the pipeline
+struct pipeline_item {
+  s_sudoku initial;   // Grid as read from the input
+  s_sudoku solution;  // Grid being solved
+  int *assumptions;   // Givens of the grid (between encode and solve), see
+  size_t assumptions_length;   // sudoku_to_assumptions
+  int solved;         // Result of the resolution (-1 on failure)
+};
+
+// Counters of a queue, only updated by its producer
+struct pipeline_queue_counters {
+  size_t max_depth;
+  double depth_sum;
+  size_t pushes;
+};
+
+struct pipeline {
+  char **filenames;
+  size_t count;
+  sudoku_format format;
+
+  // queues[k] is the output of stage k and the input of stage k + 1
+  s_spsc_queue queues[PIPELINE_STAGES - 1];
+  struct pipeline_queue_counters counters[PIPELINE_STAGES - 1];
+
+  // stages[k] is only updated by the thread of stage k
+  pipeline_stage_stats stages[PIPELINE_STAGES];
+
+  // Set when a stage could not start: the others drop their items instead
+  // of waiting for it, see pipeline_push
+  int stopped;
+
+  // Results of the parse stage
+  bool invalid;     // An invalid grid or file was found
+  size_t grids;     // Number of grids read
+
+  // Statistics of the resolutions, the encode stage only fills
+  // encode_seconds and the solve stage the others (and the time spent
+  // restoring the rules in encode_seconds)
+  sudoku_stats encode_stats;
+  sudoku_stats solve_stats;
+};
+
+// ===================
+
+
+// ===== PRIVATE =====
+
+// Marks the end of the input in the queues
+static struct pipeline_item pipeline_end;
+
+/* Waits a bit before trying again to push or pop, the first tries only
+ * yield the processor
+ */
+void pipeline_backoff(size_t tries) {
+  if (tries < 64) {
+    sched_yield();
+  } else {
+    struct timespec ts = {0, 50000};
+    nanosleep(&ts, NULL);
+  }
+}
+
+void pipeline_item_free(struct pipeline_item *item) {
+  if (item->initial) s_sudoku_free(item->initial);
+  if (item->solution) s_sudoku_free(item->solution);
+  alloc_free(item->assumptions);
+  alloc_free(item);
+}
+
+// Returns whether a stage of p could not start
+bool pipeline_stopped(struct pipeline *p) {
+  return __atomic_load_n(&p->stopped, __ATOMIC_ACQUIRE);
+}
+
+/* Pushes item in the output queue of stage, waiting for room if it is full
+ *
+ * Once p is stopped an item which doesn't fit is freed instead, as the next
+ * stage may never pop it.
+ */
+void pipeline_push(struct pipeline *p, size_t stage, struct pipeline_item *item) {
+  s_spsc_queue q = p->queues[stage];
+
+  if (!s_spsc_queue_push(q, item)) {
+    double start = util_now();
+    for (size_t tries = 0; !s_spsc_queue_push(q, item); tries++) {
+      if (pipeline_stopped(p)) {
+        if (item != &pipeline_end) pipeline_item_free(item);
+        return;
+      }
+      pipeline_backoff(tries);
+    }
+    p->stages[stage].wait_seconds += util_now() - start;
+  }
+
+  // Sample the depth of the queue
+  size_t depth = s_spsc_queue_length(q);
+  struct pipeline_queue_counters *c = &p->counters[stage];
+  if (depth > c->max_depth) c->max_depth = depth;
+  c->depth_sum += depth;
+  c->pushes++;
+}
+
+/* Pops the next item of the input queue of stage, waiting for one if it is
+ * empty
+ */
+struct pipeline_item *pipeline_pop(struct pipeline *p, size_t stage) {
+  s_spsc_queue q = p->queues[stage - 1];
+  void *item;
+
+  if (!s_spsc_queue_pop(q, &item)) {
+    double start = util_now();
+    for (size_t tries = 0; !s_spsc_queue_pop(q, &item); tries++)
+      pipeline_backoff(tries);
+    p->stages[stage].wait_seconds += util_now() - start;
+  }
+
+  return item;
+}
+
+/* Parse stage, reads the grids of the file filename
+ */
+void pipeline_parse_file(struct pipeline *p, char *filename) {
+  pipeline_stage_stats *stats = &p->stages[PIPELINE_PARSE];
+  bool use_stdin = strcmp(filename, "-") == 0;
+
+  FILE *file = use_stdin ? stdin : fopen(filename, "r");
+  s_sudoku_stream st = file ? s_sudoku_stream_create(file) : NULL;
+  if (!st) {
+    fprintf(stderr, "%s: can't open file\n", filename);
+    if (file && !use_stdin) fclose(file);
+    p->invalid = true;
+    return;
+  }
+
+  while (!s_sudoku_stream_eof(st) && !pipeline_stopped(p)) {
+    double start = util_now();
+
+    s_sudoku g = s_sudoku_stream_next(st);
+    if (!g) {
+      if (!s_sudoku_stream_eof(st)) {
+        fprintf(stderr, "%s:%zu: invalid grid\n", filename, s_sudoku_stream_line(st));
+        p->invalid = true;
+      }
+      continue;
+    }
+
+    struct pipeline_item *item = alloc_malloc(ALLOC_RUNTIME, sizeof(struct pipeline_item));
+    if (!item) {
+      s_sudoku_free(g);
+      p->invalid = true;
+      break;
+    }
+
+    item->initial = g;
+    item->solution = s_sudoku_copy(g);
+    item->assumptions = NULL;
+    item->assumptions_length = 0;
+    item->solved = item->solution ? 0 : -1;
+
+    stats->items++;
+    stats->busy_seconds += util_now() - start;
+    p->grids++;
+
+    pipeline_push(p, PIPELINE_PARSE, item);
+  }
+
+  s_sudoku_stream_free(st);
+  if (!use_stdin) fclose(file);
+}
+
+void *pipeline_parse(void *arg) {
+  struct pipeline *p = arg;
+
+  for (size_t k = 0; k < p->count; k++)
+    pipeline_parse_file(p, p->filenames[k]);
+
+  pipeline_push(p, PIPELINE_PARSE, &pipeline_end);
+  return NULL;
+}
+
+void *pipeline_encode(void *arg) {
+  struct pipeline *p = arg;
+  pipeline_stage_stats *stats = &p->stages[PIPELINE_ENCODE];
+
+  struct pipeline_item *item;
+  while ((item = pipeline_pop(p, PIPELINE_ENCODE)) != &pipeline_end) {
+    double start = util_now();
+
+    // The rules are kept by the solver of the solve stage, only the givens
+    // depend on the grid
+    if (item->solved != -1) {
+      size_t n = s_sudoku_size(item->solution);
+      item->assumptions = alloc_malloc(ALLOC_ENCODE, sizeof(int) * n * n);
+      if (item->assumptions)
+        item->assumptions_length = sudoku_to_assumptions(item->solution, item->assumptions);
+      else
+        item->solved = -1;
+    }
+
+    double busy = util_now() - start;
+    stats->items++;
+    stats->busy_seconds += busy;
+    p->encode_stats.encode_seconds += busy;
+
+    pipeline_push(p, PIPELINE_ENCODE, item);
+  }
+
+  pipeline_push(p, PIPELINE_ENCODE, &pipeline_end);
+  return NULL;
+}
+
+void *pipeline_solve_stage(void *arg) {
+  struct pipeline *p = arg;
+  pipeline_stage_stats *stats = &p->stages[PIPELINE_SOLVE];
+
+  s_sudoku_solver sv = s_sudoku_solver_create();
+
+  struct pipeline_item *item;
+  while ((item = pipeline_pop(p, PIPELINE_SOLVE)) != &pipeline_end) {
+    double start = util_now();
+
+    if (item->solved != -1) {
+      item->solved = sv ? s_sudoku_solver_solve_assuming(sv, item->solution, item->assumptions,
+                                                         item->assumptions_length)
+                        : -1;
+      alloc_free(item->assumptions);
+      item->assumptions = NULL;
+    }
+
+    double busy = util_now() - start;
+    stats->items++;
+    stats->busy_seconds += busy;
+
+    pipeline_push(p, PIPELINE_SOLVE, item);
+  }
+
+  pipeline_push(p, PIPELINE_SOLVE, &pipeline_end);
+
+  // The restoring of the rules is counted by the solver as encoding
+  if (sv) {
+    sudoku_stats solve_stats;
+    s_sudoku_solver_get_stats(sv, &solve_stats);
+    sudoku_stats_add(&p->solve_stats, &solve_stats);
+    s_sudoku_solver_free(sv);
+  }
+  return NULL;
+}
+
+// ===================
+
+
+// ===== BASE FUNCTIONS =====
+
+int pipeline_solve(char **filenames, size_t count, s_sudoku_writer w,
+                   pipeline_options options, pipeline_stats *stats) {
+  if (!filenames || !w || options.queue_capacity == 0) return -1;
+
+  double start = util_now();
+
+  struct pipeline p;
+  memset(&p, 0, sizeof(p));
+  p.filenames = filenames;
+  p.count = count;
+  p.format = options.format;
+
+  bool created = true;
+  for (size_t k = 0; k < PIPELINE_STAGES - 1; k++) {
+    p.queues[k] = s_spsc_queue_create(options.queue_capacity);
+    if (!p.queues[k]) created = false;
+  }
+
+  void *(*stages[])(void *) = {pipeline_parse, pipeline_encode, pipeline_solve_stage};
+  pthread_t threads[PIPELINE_STAGES - 1];
+  size_t started = 0;
+
+  while (created && started < PIPELINE_STAGES - 1
+         && pthread_create(&threads[started], NULL, stages[started], &p) == 0)
+    started++;
+
+  int status = 0;
+
+  // Emit stage, on the calling thread. It always consumes every item so the
+  // other stages never stay blocked.
+  if (started == PIPELINE_STAGES - 1) {
+    pipeline_stage_stats *emit = &p.stages[PIPELINE_EMIT];
+    struct pipeline_item *item;
+
+    while ((item = pipeline_pop(&p, PIPELINE_EMIT)) != &pipeline_end) {
+      double item_start = util_now();
+
+      if (item->solved == -1) status = -1;
+
+      // Results of the pretty and semicolon formats are separated by an
+      // empty line
+      if (status == 0 && emit->items > 0 && p.format != SUDOKU_FORMAT_LINE)
+        status = s_sudoku_writer_write_string(w, "\n", 1);
+
+      if (status == 0)
+        status = batch_write_result(w, item->initial, item->solution,
+                                    item->solved, p.format);
+
+      pipeline_item_free(item);
+
+      emit->items++;
+      emit->busy_seconds += util_now() - item_start;
+    }
+  } else {
+    // The stages started end without waiting for the missing ones
+    __atomic_store_n(&p.stopped, 1, __ATOMIC_RELEASE);
+    status = -1;
+  }
+
+  for (size_t k = 0; k < started; k++)
+    pthread_join(threads[k], NULL);
+
+  if (options.stats) {
+    sudoku_stats_add(options.stats, &p.encode_stats);
+    sudoku_stats_add(options.stats, &p.solve_stats);
+  }
+
+  // If a stage could not start, the items left in the queues are freed here
+  size_t capacities[PIPELINE_STAGES - 1] = {0};
+  for (size_t k = 0; k < PIPELINE_STAGES - 1; k++) {
+    if (!p.queues[k]) continue;
+
+    capacities[k] = s_spsc_queue_capacity(p.queues[k]);
+
+    void *item;
+    while (s_spsc_queue_pop(p.queues[k], &item))
+      if (item != &pipeline_end) pipeline_item_free(item);
+    s_spsc_queue_free(p.queues[k]);
+  }
+
+  if (stats) {
+    stats->seconds = util_now() - start;
+    memcpy(stats->stages, p.stages, sizeof(p.stages));
+
+    for (size_t k = 0; k < PIPELINE_STAGES - 1; k++) {
+      struct pipeline_queue_counters *c = &p.counters[k];
+      stats->queues[k].capacity = capacities[k];
+      stats->queues[k].max_depth = c->max_depth;
+      stats->queues[k].mean_depth = c->pushes ? c->depth_sum / c->pushes : 0;
+    }
+  }
+
+  if (p.invalid || p.grids == 0) status = -1;
+  return status;
+}
+
+void pipeline_stats_print(FILE *file, pipeline_stats *stats) {
+  if (!file || !stats) return;
+
+  const char *names[] = {"parse", "encode", "solve", "emit"};
+
+  fprintf(file, "{\"seconds\": %.6f, \"stages\": [", stats->seconds);
+  for (size_t k = 0; k < PIPELINE_STAGES; k++) {
+    pipeline_stage_stats *s = &stats->stages[k];
+    double per_second = s->busy_seconds > 0 ? s->items / s->busy_seconds : 0;
+    fprintf(file, "%s{\"name\": \"%s\", \"items\": %zu, \"busy_seconds\": %.6f, "
+            "\"wait_seconds\": %.6f, \"items_per_busy_second\": %.1f}",
+            k ? ", " : "", names[k], s->items, s->busy_seconds, s->wait_seconds,
+            per_second);
+  }
+
+  fprintf(file, "], \"queues\": [");
+  for (size_t k = 0; k < PIPELINE_STAGES - 1; k++) {
+    pipeline_queue_stats *q = &stats->queues[k];
+    fprintf(file, "%s{\"from\": \"%s\", \"to\": \"%s\", \"capacity\": %zu, "
+            "\"max_depth\": %zu, \"mean_depth\": %.2f}",
+            k ? ", " : "", names[k], names[k + 1], q->capacity, q->max_depth,
+            q->mean_depth);
+  }
+  fprintf(file, "]}\n");
+}
+
+// ==========================
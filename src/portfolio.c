@@ -0,0 +1,499 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+
+#include <string.h>
+#include <pthread.h>
+
+#include "cnf.h"
+#include "dpll.h"
+#include "portfolio.h"
+#include "clause_ring.h"
+#include "alloc.h"
+
+
+// ===== STRUCTS =====
+
+// Part of the search of a cube-and-conquer: the assumptions of the
+// resolution followed by the litterals of the branches leading to it
+struct portfolio_cube {
+  size_t length;
+  int litts[];
+};
+
+/* A solver of the portfolio and the result of its last resolution
+ *
+ * When conquering, the cubes split by the solver wait in its deque: it takes
+ * back the last one (the deepest) and the others steal the first one (the
+ * largest part of the search left).
+ */
+struct portfolio_racer {
+  s_portfolio p;
+  s_dpll sat;
+  pthread_t thread;
+  int result;
+
+  // Clauses shared by the solver, and positions of the solver in the rings
+  // of the others (see portfolio_import)
+  s_clause_ring ring;
+  size_t *cursors;
+  size_t imported;
+
+  pthread_mutex_t lock;   // Of the deque
+  struct portfolio_cube **cubes;
+  size_t first;           // Cubes first to last - 1 are in the deque
+  size_t last;
+  size_t capacity;
+};
+
+struct portfolio {
+  struct portfolio_racer *racers;
+  size_t size;
+
+  int cancel;   // Read by every solver, see dpll_options
+  long winner;  // Racer which found the answer first, -1 for none
+
+  const int *assumptions;   // Of the resolution in progress
+  size_t length;
+  bool sharing;             // See s_portfolio_set_sharing
+
+  // Cube-and-conquer, see s_portfolio_conquer_assuming
+  pthread_mutex_t lock;
+  pthread_cond_t work;  // Signaled when a cube is split or the search ends
+  size_t depth;         // Branches of the deepest cubes
+  size_t pending;       // Cubes split and not refuted yet
+  bool done;            // The answer is known or the search failed
+
+  portfolio_stats stats;
+};
+
+// ===================
+
+
+// ===== PRIVATE =====
+
+/* Makes the racer r the winner of the resolution of p with the result
+ * result if it is the first one to answer, then cancels the others
+ */
+void portfolio_win(s_portfolio p, struct portfolio_racer *r, int result) {
+  long none = -1;
+  r->result = result;
+  if (__atomic_compare_exchange_n(&p->winner, &none, r - p->racers, false, __ATOMIC_ACQ_REL,
+                                  __ATOMIC_ACQUIRE))
+    __atomic_store_n(&p->cancel, 1, __ATOMIC_RELAXED);
+}
+
+/* Runs the resolution of p with one of its solvers, the first one to find
+ * the answer cancels the others
+ */
+void *portfolio_race(void *arg) {
+  struct portfolio_racer *r = arg;
+  s_portfolio p = r->p;
+
+  int result = s_dpll_solve_assuming(r->sat, p->assumptions, p->length);
+  if (result != -1) portfolio_win(p, r, result);   // Else failed or cancelled
+
+  return NULL;
+}
+
+/* Shares the clause learnt by the solver of the racer ctx if it is short
+ * enough (see dpll_export_callback)
+ */
+void portfolio_export(const int *litts, size_t length, size_t lbd, void *ctx) {
+  struct portfolio_racer *r = ctx;
+  if (length <= PORTFOLIO_SHARE_LENGTH && lbd <= PORTFOLIO_SHARE_LBD)
+    s_clause_ring_push(r->ring, litts, length);
+}
+
+/* Gives the solver of the racer ctx the next clause shared by another racer
+ * (see dpll_import_callback)
+ */
+size_t portfolio_import(int *litts, size_t capacity, void *ctx) {
+  struct portfolio_racer *r = ctx;
+  s_portfolio p = r->p;
+
+  size_t k = r - p->racers;
+  for (size_t i = 1; i < p->size; i++) {
+    size_t other = (k + i) % p->size;
+    size_t length = s_clause_ring_read(p->racers[other].ring, &r->cursors[other], litts,
+                                       capacity);
+    if (length > 0) {
+      r->imported++;
+      return length;
+    }
+  }
+
+  return 0;
+}
+
+/* Sets the callbacks of clause sharing of the solvers of p, or removes them
+ * when sharing is false
+ */
+void portfolio_share(s_portfolio p, bool sharing) {
+  for (size_t k = 0; k < p->size; k++) {
+    struct portfolio_racer *r = &p->racers[k];
+    dpll_options options;
+    s_dpll_get_options(r->sat, &options);
+    options.export_clause = sharing ? portfolio_export : NULL;
+    options.import_clause = sharing ? portfolio_import : NULL;
+    options.sharing = sharing ? r : NULL;
+    s_dpll_set_options(r->sat, &options);
+
+    // The clauses of the previous resolutions may not hold anymore
+    s_clause_ring_clear(r->ring);
+    memset(r->cursors, 0, p->size * sizeof(size_t));
+    r->imported = 0;
+  }
+}
+
+/* Runs the thread function run for every racer of p, the racer 0 in the
+ * calling thread, and waits for all of them
+ */
+void portfolio_run(s_portfolio p, void *(*run)(void *)) {
+  p->cancel = 0;
+  p->winner = -1;
+  if (p->sharing && p->size > 1) portfolio_share(p, true);
+
+  // The racers which can't be started are left out
+  size_t started = 1;
+  while (started < p->size
+         && pthread_create(&p->racers[started].thread, NULL, run, &p->racers[started]) == 0)
+    started++;
+
+  run(&p->racers[0]);
+
+  for (size_t k = 1; k < started; k++)
+    pthread_join(p->racers[k].thread, NULL);
+
+  if (p->sharing && p->size > 1) {
+    for (size_t k = 0; k < p->size; k++) {
+      p->stats.shared += s_clause_ring_pushed(p->racers[k].ring);
+      p->stats.imported += p->racers[k].imported;
+    }
+    portfolio_share(p, false);
+  }
+
+  // The solvers can be used on their own until the next resolution
+  p->cancel = 0;
+}
+
+/* Returns a new cube of the length litterals litts followed by litt (none
+ * when litt is 0), with room for the branches of the deepest cubes of p
+ *
+ * Returns NULL on failure
+ */
+struct portfolio_cube *portfolio_cube_create(s_portfolio p, const int *litts, size_t length,
+                                             int litt) {
+  struct portfolio_cube *cube = alloc_malloc(ALLOC_DPLL, sizeof(struct portfolio_cube)
+                                             + (p->length + p->depth) * sizeof(int));
+  if (!cube) return NULL;
+
+  if (length > 0) memcpy(cube->litts, litts, length * sizeof(int));
+  cube->length = length;
+  if (litt) cube->litts[cube->length++] = litt;
+  return cube;
+}
+
+/* Adds cube at the end of the deque of r
+ *
+ * Returns 0 on success and -1 on failure
+ */
+int portfolio_push(struct portfolio_racer *r, struct portfolio_cube *cube) {
+  pthread_mutex_lock(&r->lock);
+
+  // The room left by the stolen cubes is used first
+  if (r->last == r->capacity && r->first > 0) {
+    memmove(r->cubes, r->cubes + r->first, (r->last - r->first) * sizeof(*r->cubes));
+    r->last -= r->first;
+    r->first = 0;
+  }
+  if (r->last == r->capacity) {
+    size_t capacity = r->capacity ? 2 * r->capacity : 16;
+    struct portfolio_cube **cubes = alloc_realloc(ALLOC_DPLL, r->cubes,
+                                                  capacity * sizeof(*cubes));
+    if (!cubes) {
+      pthread_mutex_unlock(&r->lock);
+      return -1;
+    }
+    r->cubes = cubes;
+    r->capacity = capacity;
+  }
+
+  r->cubes[r->last++] = cube;
+  pthread_mutex_unlock(&r->lock);
+  return 0;
+}
+
+/* Removes the last cube of the deque of r, or the first one when steal is
+ * true
+ *
+ * Returns the cube and NULL if the deque is empty
+ */
+struct portfolio_cube *portfolio_pop(struct portfolio_racer *r, bool steal) {
+  pthread_mutex_lock(&r->lock);
+
+  struct portfolio_cube *cube = NULL;
+  if (r->first < r->last) cube = steal ? r->cubes[r->first++] : r->cubes[--r->last];
+  if (r->first == r->last) r->first = r->last = 0;
+
+  pthread_mutex_unlock(&r->lock);
+  return cube;
+}
+
+/* Ends the cube-and-conquer of p, which failed when failed is true
+ */
+void portfolio_stop(s_portfolio p, bool failed) {
+  pthread_mutex_lock(&p->lock);
+  if (failed) __atomic_store_n(&p->cancel, 1, __ATOMIC_RELAXED);
+  p->done = true;
+  pthread_cond_broadcast(&p->work);
+  pthread_mutex_unlock(&p->lock);
+}
+
+/* Returns the next cube of the racer r: the last one of its deque, or else
+ * the first one of the deque of another racer, waiting for a cube to be
+ * split if there is none
+ *
+ * Returns NULL once the search is done
+ */
+struct portfolio_cube *portfolio_next_cube(struct portfolio_racer *r) {
+  s_portfolio p = r->p;
+  if (__atomic_load_n(&p->cancel, __ATOMIC_RELAXED)) return NULL;
+
+  struct portfolio_cube *cube = portfolio_pop(r, false);
+  if (cube) return cube;
+
+  // Only r fills its deque, so it stays empty while r waits
+  pthread_mutex_lock(&p->lock);
+  while (!p->done) {
+    size_t k = r - p->racers;
+    for (size_t i = 1; i < p->size && !cube; i++)
+      cube = portfolio_pop(&p->racers[(k + i) % p->size], true);
+
+    if (cube) {
+      p->stats.steals++;
+      break;
+    }
+    pthread_cond_wait(&p->work, &p->lock);
+  }
+  pthread_mutex_unlock(&p->lock);
+
+  return cube;
+}
+
+/* Splits cube until it has the branches of the deepest cubes of p (see
+ * s_dpll_lookahead), the other side of each split going to the deque of r,
+ * then solves it with the solver of r
+ *
+ * Returns 1 if the cube has a model, 0 if not and -1 on failure or when the
+ * search is cancelled
+ */
+int portfolio_conquer_cube(struct portfolio_racer *r, struct portfolio_cube *cube) {
+  s_portfolio p = r->p;
+
+  while (cube->length < p->length + p->depth) {
+    if (__atomic_load_n(&p->cancel, __ATOMIC_RELAXED)) return -1;
+
+    int var = s_dpll_lookahead(r->sat, cube->litts, cube->length);
+    if (var == -1) return -1;
+    if (var == 0) break;
+
+    struct portfolio_cube *other = portfolio_cube_create(p, cube->litts, cube->length, -var);
+    if (!other) return -1;
+
+    // Counted before it can be stolen and refuted
+    pthread_mutex_lock(&p->lock);
+    p->pending++;
+    pthread_mutex_unlock(&p->lock);
+
+    if (portfolio_push(r, other) == -1) {
+      alloc_free(other);
+      return -1;
+    }
+    cube->litts[cube->length++] = var;
+
+    pthread_mutex_lock(&p->lock);
+    pthread_cond_signal(&p->work);
+    pthread_mutex_unlock(&p->lock);
+  }
+
+  __atomic_add_fetch(&p->stats.cubes, 1, __ATOMIC_RELAXED);
+  return s_dpll_solve_assuming(r->sat, cube->litts, cube->length);
+}
+
+/* Solves the cubes of p with one of its solvers until one of them has a
+ * model or every one of them is refuted
+ */
+void *portfolio_conquer(void *arg) {
+  struct portfolio_racer *r = arg;
+  s_portfolio p = r->p;
+
+  struct portfolio_cube *cube;
+  while ((cube = portfolio_next_cube(r))) {
+    int result = portfolio_conquer_cube(r, cube);
+    alloc_free(cube);
+
+    if (result == 1) {
+      portfolio_win(p, r, 1);
+      portfolio_stop(p, false);
+    } else if (result == 0) {
+      pthread_mutex_lock(&p->lock);
+      bool refuted = --p->pending == 0;
+      pthread_mutex_unlock(&p->lock);
+
+      // Every cube of the search is refuted, so is the formula
+      if (refuted) {
+        portfolio_win(p, r, 0);
+        portfolio_stop(p, false);
+      }
+    } else if (!__atomic_load_n(&p->cancel, __ATOMIC_RELAXED)) {
+      portfolio_stop(p, true);
+    }
+  }
+
+  return NULL;
+}
+
+// ===================
+
+
+// ===== BASE FUNCTIONS =====
+
+s_portfolio s_portfolio_create(size_t solvers) {
+  if (solvers == 0) return NULL;
+
+  s_portfolio p = alloc_malloc(ALLOC_DPLL, sizeof(struct portfolio));
+  if (!p) return NULL;
+
+  p->racers = alloc_calloc(ALLOC_DPLL, solvers, sizeof(struct portfolio_racer));
+  if (!p->racers) {
+    alloc_free(p);
+    return NULL;
+  }
+
+  p->size = 0;
+  p->cancel = 0;
+  p->winner = -1;
+  p->assumptions = NULL;
+  p->length = 0;
+  p->sharing = true;
+  pthread_mutex_init(&p->lock, NULL);
+  pthread_cond_init(&p->work, NULL);
+  memset(&p->stats, 0, sizeof(portfolio_stats));
+
+  for (size_t k = 0; k < solvers; k++) {
+    dpll_options options;
+    dpll_portfolio_options(k, &options);
+    options.cancel = &p->cancel;
+
+    struct portfolio_racer *r = &p->racers[k];
+    r->sat = s_dpll_create();
+    r->ring = s_clause_ring_create(PORTFOLIO_SHARE_CAPACITY);
+    r->cursors = alloc_calloc(ALLOC_DPLL, solvers, sizeof(size_t));
+    pthread_mutex_init(&r->lock, NULL);
+    r->p = p;
+    p->size++;
+
+    if (!r->sat || !r->ring || !r->cursors || s_dpll_set_options(r->sat, &options) == -1) {
+      s_portfolio_free(p);
+      return NULL;
+    }
+  }
+
+  return p;
+}
+
+void s_portfolio_free(s_portfolio p) {
+  for (size_t k = 0; k < p->size; k++) {
+    s_dpll_free(p->racers[k].sat);
+    if (p->racers[k].ring) s_clause_ring_free(p->racers[k].ring);
+    alloc_free(p->racers[k].cursors);
+    pthread_mutex_destroy(&p->racers[k].lock);
+    alloc_free(p->racers[k].cubes);
+  }
+
+  pthread_mutex_destroy(&p->lock);
+  pthread_cond_destroy(&p->work);
+  alloc_free(p->racers);
+  alloc_free(p);
+}
+
+size_t s_portfolio_size(s_portfolio p) {
+  return p->size;
+}
+
+void s_portfolio_set_sharing(s_portfolio p, bool sharing) {
+  p->sharing = sharing;
+}
+
+s_dpll s_portfolio_solver(s_portfolio p, size_t k) {
+  return k < p->size ? p->racers[k].sat : NULL;
+}
+
+int s_portfolio_add_clause(s_portfolio p, const int *litts, size_t length) {
+  for (size_t k = 0; k < p->size; k++)
+    if (s_dpll_add_clause(p->racers[k].sat, litts, length) == -1) return -1;
+
+  return 0;
+}
+
+int s_portfolio_add_cnf(s_portfolio p, s_cnf cn) {
+  for (size_t k = 0; k < p->size; k++)
+    if (s_dpll_add_cnf(p->racers[k].sat, cn) == -1) return -1;
+
+  return 0;
+}
+
+int s_portfolio_solve_assuming(s_portfolio p, const int *assumptions, size_t length) {
+  if (!p || (!assumptions && length > 0)) return -1;
+
+  p->assumptions = assumptions;
+  p->length = length;
+  memset(&p->stats, 0, sizeof(portfolio_stats));
+
+  portfolio_run(p, portfolio_race);
+  return p->winner == -1 ? -1 : p->racers[p->winner].result;
+}
+
+int s_portfolio_conquer_assuming(s_portfolio p, const int *assumptions, size_t length) {
+  if (!p || (!assumptions && length > 0)) return -1;
+
+  p->assumptions = assumptions;
+  p->length = length;
+  memset(&p->stats, 0, sizeof(portfolio_stats));
+
+  // Enough cubes for each solver to steal some when its own are easy
+  p->depth = 0;
+  while ((size_t) 1 << p->depth < p->size * PORTFOLIO_CUBES_PER_SOLVER) p->depth++;
+
+  // The whole search is the first cube
+  struct portfolio_cube *cube = portfolio_cube_create(p, assumptions, length, 0);
+  if (!cube) return -1;
+  if (portfolio_push(&p->racers[0], cube) == -1) {
+    alloc_free(cube);
+    return -1;
+  }
+  p->pending = 1;
+  p->done = false;
+
+  portfolio_run(p, portfolio_conquer);
+
+  // The cubes left once the answer is known
+  for (size_t k = 0; k < p->size; k++)
+    while ((cube = portfolio_pop(&p->racers[k], false))) alloc_free(cube);
+
+  return p->winner == -1 ? -1 : p->racers[p->winner].result;
+}
+
+s_dpll s_portfolio_winner(s_portfolio p) {
+  return p->winner == -1 ? NULL : p->racers[p->winner].sat;
+}
+
+void s_portfolio_get_stats(s_portfolio p, portfolio_stats *stats) {
+  if (!p || !stats) return;
+  *stats = p->stats;
+}
+
+// ==========================
@@ -0,0 +1,756 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdlib.h>
+#include <stdbool.h>
+
+#include <stdint.h>
+#include <string.h>
+
+#include "cnf.h"
+#include "preprocess.h"
+#include "alloc.h"
+#include "util.h"
+
+
+// ===== STRUCTS =====
+
+// Flags of the variables
+#define PREPROCESS_FROZEN 1
+#define PREPROCESS_ELIMINATED 2
+
+// Clause of the formula being simplified, its litterals are sorted
+struct preprocess_clause {
+  size_t start;         // In litts
+  size_t length;
+  uint64_t signature;   // Bit var % 64 set for each variable of the clause
+  bool removed;
+  bool queued;          // Waits in queue to subsume the others
+};
+
+// Clauses containing a litteral, the removed ones are only dropped from the
+// list when it is read (see preprocess_occurrences)
+struct preprocess_list {
+  size_t *clauses;
+  size_t length;
+  size_t capacity;
+};
+
+struct preprocess {
+  size_t vars;
+
+  int *litts;
+  size_t litts_length;
+  size_t litts_capacity;
+  struct preprocess_clause *clauses;
+  size_t clauses_length;
+  size_t clauses_capacity;
+
+  struct preprocess_list *lists;  // Indexed by litteral, see util_litt_index
+
+  // Indexed by variable
+  signed char *values;  // Fixed by a unit: 1 true, -1 false, 0 otherwise
+  unsigned char *flags;
+
+  // Units assigned, propagated from units_head
+  int *units;
+  size_t units_length;
+  size_t units_head;
+
+  // Clauses which must subsume the others, see preprocess_subsume
+  size_t *queue;
+  size_t queue_length;
+  size_t queue_capacity;
+
+  // Clauses removed by the eliminations in order, the litteral of the
+  // variable eliminated first, each one followed by 0 (see
+  // s_preprocess_extend)
+  int *removed;
+  size_t removed_length;
+  size_t removed_capacity;
+
+  // Scratch space of the subsumption and of the resolution
+  size_t *marks;        // Indexed by litteral
+  size_t stamp;
+  size_t *candidates;
+  size_t candidates_capacity;
+  int *resolvent;
+  size_t resolvent_capacity;
+
+  bool unsat;           // The empty clause was found
+  bool failed;          // An allocation failed
+
+  // Simplified formula, its clauses each followed by 0, and as a formula
+  // once it is asked for (see s_preprocess_cnf)
+  int *simplified;
+  size_t simplified_length;
+  s_cnf cn;
+  preprocess_stats stats;
+};
+
+// ===================
+
+
+// ===== PRIVATE =====
+
+/* Grows the array *ptr of *capacity items of size bytes to hold at least
+ * length items, and marks pp failed when it can't
+ *
+ * Returns 0 on success and -1 on failure
+ */
+int preprocess_grow(s_preprocess pp, void **ptr, size_t *capacity, size_t length, size_t size) {
+  if (util_grow(ALLOC_PREPROCESS, ptr, capacity, length, size) == -1) {
+    pp->failed = true;
+    return -1;
+  }
+  return 0;
+}
+
+uint64_t preprocess_signature(const int *litts, size_t length) {
+  uint64_t signature = 0;
+  for (size_t k = 0; k < length; k++)
+    signature |= (uint64_t) 1 << (abs(litts[k]) % 64);
+  return signature;
+}
+
+/* Drops the removed clauses from the list of litt
+ *
+ * Returns the list
+ */
+struct preprocess_list *preprocess_occurrences(s_preprocess pp, int litt) {
+  struct preprocess_list *list = &pp->lists[util_litt_index(litt)];
+
+  size_t kept = 0;
+  for (size_t k = 0; k < list->length; k++)
+    if (!pp->clauses[list->clauses[k]].removed) list->clauses[kept++] = list->clauses[k];
+  list->length = kept;
+
+  return list;
+}
+
+/* Copies the clauses containing litt, then the ones containing -litt when
+ * both is true, to pp->candidates, which are not changed while they are
+ * read
+ *
+ * Returns the number of clauses copied
+ */
+size_t preprocess_candidates(s_preprocess pp, int litt, bool both) {
+  struct preprocess_list *list = preprocess_occurrences(pp, litt);
+  struct preprocess_list *opposite = both ? preprocess_occurrences(pp, -litt) : NULL;
+  size_t length = list->length + (both ? opposite->length : 0);
+  if (length == 0) return 0;
+
+  if (preprocess_grow(pp, (void **) &pp->candidates, &pp->candidates_capacity, length,
+                      sizeof(size_t)) == -1)
+    return 0;
+
+  if (list->length > 0)
+    memcpy(pp->candidates, list->clauses, sizeof(size_t) * list->length);
+  if (both && opposite->length > 0)
+    memcpy(pp->candidates + list->length, opposite->clauses, sizeof(size_t) * opposite->length);
+  return length;
+}
+
+// Puts clause in the queue of the clauses which must subsume the others
+void preprocess_enqueue(s_preprocess pp, size_t clause) {
+  if (pp->clauses[clause].queued) return;
+  if (preprocess_grow(pp, (void **) &pp->queue, &pp->queue_capacity, pp->queue_length + 1,
+                      sizeof(size_t)) == -1)
+    return;
+
+  pp->clauses[clause].queued = true;
+  pp->queue[pp->queue_length++] = clause;
+}
+
+// Fixes the variable of litt so that litt is true, the empty clause is found
+// when it is already false
+void preprocess_assign(s_preprocess pp, int litt) {
+  signed char value = litt > 0 ? 1 : -1;
+  signed char *current = &pp->values[abs(litt)];
+
+  if (*current == 0) {
+    *current = value;
+    pp->units[pp->units_length++] = litt;
+    pp->stats.fixed++;
+  } else if (*current != value) {
+    pp->unsat = true;
+  }
+}
+
+/* Adds the clause of the length litterals, sorted and without duplicates
+ * nor tautologies, to the formula: the empty clause makes it unsatisfiable
+ * and a unit clause is assigned instead
+ */
+void preprocess_add(s_preprocess pp, const int *litts, size_t length) {
+  if (length == 0) {
+    pp->unsat = true;
+    return;
+  }
+  if (length == 1) {
+    preprocess_assign(pp, litts[0]);
+    return;
+  }
+
+  if (preprocess_grow(pp, (void **) &pp->litts, &pp->litts_capacity,
+                      pp->litts_length + length, sizeof(int)) == -1
+      || preprocess_grow(pp, (void **) &pp->clauses, &pp->clauses_capacity,
+                         pp->clauses_length + 1, sizeof(struct preprocess_clause)) == -1)
+    return;
+
+  size_t clause = pp->clauses_length++;
+  struct preprocess_clause *c = &pp->clauses[clause];
+  c->start = pp->litts_length;
+  c->length = length;
+  c->signature = preprocess_signature(litts, length);
+  c->removed = false;
+  c->queued = false;
+  memcpy(pp->litts + c->start, litts, sizeof(int) * length);
+  pp->litts_length += length;
+
+  for (size_t k = 0; k < length; k++) {
+    struct preprocess_list *list = &pp->lists[util_litt_index(litts[k])];
+    if (preprocess_grow(pp, (void **) &list->clauses, &list->capacity, list->length + 1,
+                        sizeof(size_t)) == -1)
+      return;
+    list->clauses[list->length++] = clause;
+  }
+
+  preprocess_enqueue(pp, clause);
+}
+
+/* Removes litt from clause, the clause without it being implied by the
+ * formula: a clause left with one litteral is removed and the litteral
+ * assigned
+ */
+void preprocess_strengthen(s_preprocess pp, size_t clause, int litt) {
+  struct preprocess_clause *c = &pp->clauses[clause];
+  int *litts = pp->litts + c->start;
+
+  size_t kept = 0;
+  for (size_t k = 0; k < c->length; k++)
+    if (litts[k] != litt) litts[kept++] = litts[k];
+  c->length = kept;
+  c->signature = preprocess_signature(litts, kept);
+
+  struct preprocess_list *list = &pp->lists[util_litt_index(litt)];
+  for (size_t k = 0; k < list->length; k++) {
+    if (list->clauses[k] != clause) continue;
+    list->clauses[k] = list->clauses[--list->length];
+    break;
+  }
+
+  if (kept == 1) {
+    c->removed = true;
+    preprocess_assign(pp, litts[0]);
+  } else {
+    preprocess_enqueue(pp, clause);
+  }
+}
+
+// Removes the clauses satisfied by the unit litt and litt from the others
+void preprocess_propagate(s_preprocess pp, int litt) {
+  struct preprocess_list *list = preprocess_occurrences(pp, litt);
+  for (size_t k = 0; k < list->length; k++)
+    pp->clauses[list->clauses[k]].removed = true;
+  list->length = 0;
+
+  size_t length = preprocess_candidates(pp, -litt, false);
+  for (size_t k = 0; k < length && !pp->unsat; k++)
+    preprocess_strengthen(pp, pp->candidates[k], -litt);
+}
+
+/* Compares clause to the clause other: returns 1 when clause subsumes
+ * other, with in *flipped the litteral of clause whose opposite is in other
+ * instead (0 if none, at most one), and 0 otherwise
+ */
+int preprocess_subsumes(s_preprocess pp, size_t clause, size_t other, int *flipped) {
+  struct preprocess_clause *c = &pp->clauses[clause], *d = &pp->clauses[other];
+  if (c->length > d->length || (c->signature & ~d->signature) != 0) return 0;
+
+  pp->stamp++;
+  const int *litts = pp->litts + d->start;
+  for (size_t k = 0; k < d->length; k++) pp->marks[util_litt_index(litts[k])] = pp->stamp;
+
+  *flipped = 0;
+  litts = pp->litts + c->start;
+  for (size_t k = 0; k < c->length; k++) {
+    if (pp->marks[util_litt_index(litts[k])] == pp->stamp) continue;
+    if (*flipped != 0 || pp->marks[util_litt_index(-litts[k])] != pp->stamp) return 0;
+    *flipped = litts[k];
+  }
+  return 1;
+}
+
+/* Removes the clauses subsumed by clause and strengthens the ones it
+ * subsumes with one litteral flipped, among the clauses containing the
+ * variable of clause in the fewest clauses (counting the removed ones not
+ * dropped yet, which is cheaper than dropping them)
+ */
+void preprocess_subsume(s_preprocess pp, size_t clause) {
+  struct preprocess_clause *c = &pp->clauses[clause];
+  int best = 0;
+  size_t best_length = 0;
+  for (size_t k = 0; k < c->length; k++) {
+    int litt = pp->litts[c->start + k];
+    size_t length = pp->lists[util_litt_index(litt)].length
+                    + pp->lists[util_litt_index(-litt)].length;
+    if (best == 0 || length < best_length) {
+      best = litt;
+      best_length = length;
+    }
+  }
+
+  size_t length = preprocess_candidates(pp, best, true);
+  for (size_t k = 0; k < length && !pp->unsat; k++) {
+    size_t other = pp->candidates[k];
+    int flipped;
+    if (other == clause || pp->clauses[other].removed || pp->clauses[clause].removed
+        || !preprocess_subsumes(pp, clause, other, &flipped))
+      continue;
+
+    if (flipped == 0) {
+      pp->clauses[other].removed = true;
+      pp->stats.subsumed++;
+    } else {
+      preprocess_strengthen(pp, other, -flipped);
+      pp->stats.strengthened++;
+    }
+  }
+}
+
+// Propagates the units and subsumes with the queued clauses until there is
+// nothing left to do
+void preprocess_simplify(s_preprocess pp) {
+  while (!pp->unsat && !pp->failed) {
+    if (pp->units_head < pp->units_length) {
+      preprocess_propagate(pp, pp->units[pp->units_head++]);
+    } else if (pp->queue_length > 0) {
+      size_t clause = pp->queue[--pp->queue_length];
+      pp->clauses[clause].queued = false;
+      if (!pp->clauses[clause].removed) preprocess_subsume(pp, clause);
+    } else {
+      break;
+    }
+  }
+}
+
+/* Stores in pp->resolvent the resolvent on var of the clause containing var
+ * and of the clause containing -var, sorted and without duplicates
+ *
+ * Returns its length, 0 for a tautology and -1 on failure
+ */
+long preprocess_resolve(s_preprocess pp, size_t positive, size_t negative, int var) {
+  struct preprocess_clause *p = &pp->clauses[positive], *n = &pp->clauses[negative];
+  if (preprocess_grow(pp, (void **) &pp->resolvent, &pp->resolvent_capacity,
+                      p->length + n->length, sizeof(int)) == -1)
+    return -1;
+
+  // Both clauses are sorted, they are merged
+  const int *a = pp->litts + p->start, *b = pp->litts + n->start;
+  size_t i = 0, j = 0, length = 0;
+  while (i < p->length || j < n->length) {
+    int litt;
+    if (j == n->length || (i < p->length && a[i] < b[j])) litt = a[i++];
+    else if (i == p->length || b[j] < a[i]) litt = b[j++];
+    else litt = (i++, b[j++]);
+
+    if (abs(litt) == var) continue;
+    if (length > 0 && pp->resolvent[length - 1] == litt) continue;
+    pp->resolvent[length++] = litt;
+  }
+
+  // The litterals of a variable are next to each other once sorted by
+  // variable, not by value: the opposite of each litteral is looked up
+  pp->stamp++;
+  for (size_t k = 0; k < length; k++) pp->marks[util_litt_index(pp->resolvent[k])] = pp->stamp;
+  for (size_t k = 0; k < length; k++)
+    if (pp->marks[util_litt_index(-pp->resolvent[k])] == pp->stamp) return 0;
+
+  return length;
+}
+
+// Pushes the litterals of clause on the clauses removed by the
+// eliminations, with first in front
+void preprocess_save(s_preprocess pp, size_t clause, int first) {
+  struct preprocess_clause *c = &pp->clauses[clause];
+  if (preprocess_grow(pp, (void **) &pp->removed, &pp->removed_capacity,
+                      pp->removed_length + c->length + 1, sizeof(int)) == -1)
+    return;
+
+  pp->removed[pp->removed_length++] = first;
+  for (size_t k = 0; k < c->length; k++) {
+    int litt = pp->litts[c->start + k];
+    if (litt != first) pp->removed[pp->removed_length++] = litt;
+  }
+  pp->removed[pp->removed_length++] = 0;
+}
+
+/* Eliminates var if the clauses containing it are not more numerous than
+ * their resolvents on it
+ *
+ * Returns 1 if var was eliminated and 0 otherwise
+ */
+int preprocess_eliminate(s_preprocess pp, int var) {
+  if (pp->values[var] != 0 || pp->flags[var] != 0) return 0;
+
+  struct preprocess_list *positives = preprocess_occurrences(pp, var);
+  struct preprocess_list *negatives = preprocess_occurrences(pp, -var);
+  size_t occurrences = positives->length + negatives->length;
+  if (occurrences == 0 || occurrences > PREPROCESS_MAX_OCCURRENCES) return 0;
+
+  // Counted first, the resolvents are only added when they are not too many
+  size_t resolvents = 0;
+  for (size_t i = 0; i < positives->length; i++) {
+    for (size_t j = 0; j < negatives->length; j++) {
+      long length = preprocess_resolve(pp, positives->clauses[i], negatives->clauses[j], var);
+      if (length == -1 || length > PREPROCESS_MAX_RESOLVENT) return 0;
+      if (length > 0 && ++resolvents > occurrences) return 0;
+    }
+  }
+
+  size_t length = preprocess_candidates(pp, var, true);
+  if (length != occurrences) return 0;
+
+  for (size_t k = 0; k < positives->length; k++) {
+    for (size_t l = positives->length; l < length; l++) {
+      long resolvent = preprocess_resolve(pp, pp->candidates[k], pp->candidates[l], var);
+      if (resolvent > 0) preprocess_add(pp, pp->resolvent, resolvent);
+    }
+  }
+
+  // The lists of var are not read again
+  for (size_t k = 0; k < length; k++) {
+    size_t clause = pp->candidates[k];
+    preprocess_save(pp, clause, k < positives->length ? var : -var);
+    pp->clauses[clause].removed = true;
+  }
+
+  pp->flags[var] |= PREPROCESS_ELIMINATED;
+  pp->stats.eliminated++;
+  pp->stats.resolvents += resolvents;
+  return 1;
+}
+
+int preprocess_compare_keys(const void *a, const void *b) {
+  uint64_t x = *(const uint64_t *) a, y = *(const uint64_t *) b;
+  return (x > y) - (x < y);
+}
+
+/* Tries to eliminate every variable, cheapest first (see
+ * preprocess_eliminate), until none is eliminated
+ */
+void preprocess_eliminate_all(s_preprocess pp) {
+  // Each variable as the key of its score above it
+  uint64_t *order = alloc_malloc(ALLOC_PREPROCESS, sizeof(uint64_t) * (pp->vars + 1));
+  if (!order) {
+    pp->failed = true;
+    return;
+  }
+
+  size_t eliminated = 1;
+  while (eliminated > 0 && !pp->unsat && !pp->failed) {
+    // The variables in few clauses of both signs first, each elimination
+    // makes the clauses of the next ones longer
+    size_t length = 0;
+    for (size_t var = 1; var <= pp->vars; var++) {
+      if (pp->values[var] != 0 || pp->flags[var] != 0) continue;
+
+      uint64_t score = (uint64_t) preprocess_occurrences(pp, var)->length
+                       * preprocess_occurrences(pp, -(int) var)->length;
+      if (score > UINT32_MAX) score = UINT32_MAX;
+      order[length++] = score << 32 | var;
+    }
+    qsort(order, length, sizeof(uint64_t), preprocess_compare_keys);
+
+    eliminated = 0;
+    for (size_t k = 0; k < length && !pp->unsat && !pp->failed; k++) {
+      eliminated += preprocess_eliminate(pp, (int) (order[k] & UINT32_MAX));
+      preprocess_simplify(pp);
+    }
+  }
+
+  alloc_free(order);
+}
+
+/* Adds the clause of the n litterals of litts to pp, sorted and without
+ * its duplicated litterals nor the ones already false, unless it is a
+ * tautology or already satisfied
+ */
+void preprocess_load_clause(s_preprocess pp, const int *litts, size_t n) {
+  pp->stats.clauses++;
+  pp->stats.litts += n;
+  if (n == 0) {
+    pp->unsat = true;
+    return;
+  }
+
+  if (preprocess_grow(pp, (void **) &pp->resolvent, &pp->resolvent_capacity, n,
+                      sizeof(int)) == -1)
+    return;
+
+  int *sorted = pp->resolvent;
+  memcpy(sorted, litts, sizeof(int) * n);
+  qsort(sorted, n, sizeof(int), util_compare_ints);
+
+  size_t length = 0;
+  for (size_t l = 0; l < n; l++) {
+    signed char value = pp->values[abs(sorted[l])] * (sorted[l] > 0 ? 1 : -1);
+    if (value == 1) return;
+    if (value == 0 && (length == 0 || sorted[l] != sorted[length - 1]))
+      sorted[length++] = sorted[l];
+  }
+
+  pp->stamp++;
+  for (size_t l = 0; l < length; l++) pp->marks[util_litt_index(sorted[l])] = pp->stamp;
+  for (size_t l = 0; l < length; l++)
+    if (pp->marks[util_litt_index(-sorted[l])] == pp->stamp) return;
+
+  preprocess_add(pp, sorted, length);
+}
+
+/* Creates the preprocessing of a formula of vars variables, with the
+ * variables frozen and without any clause
+ *
+ * Returns NULL on failure
+ */
+s_preprocess preprocess_create(size_t vars, const int *frozen, size_t length) {
+  s_preprocess pp = alloc_calloc(ALLOC_PREPROCESS, 1, sizeof(struct preprocess));
+  if (!pp) return NULL;
+
+  pp->vars = vars;
+  pp->lists = alloc_calloc(ALLOC_PREPROCESS, 2 * vars + 2, sizeof(struct preprocess_list));
+  pp->marks = alloc_calloc(ALLOC_PREPROCESS, 2 * vars + 2, sizeof(size_t));
+  pp->values = alloc_calloc(ALLOC_PREPROCESS, vars + 1, sizeof(signed char));
+  pp->flags = alloc_calloc(ALLOC_PREPROCESS, vars + 1, sizeof(unsigned char));
+  pp->units = alloc_malloc(ALLOC_PREPROCESS, sizeof(int) * (vars + 1));
+  if (!pp->lists || !pp->marks || !pp->values || !pp->flags || !pp->units) {
+    s_preprocess_free(pp);
+    return NULL;
+  }
+
+  for (size_t k = 0; k < length; k++)
+    if ((size_t) abs(frozen[k]) <= vars) pp->flags[abs(frozen[k])] |= PREPROCESS_FROZEN;
+
+  pp->stats.vars = vars;
+  return pp;
+}
+
+/* Stores the simplified formula of pp in pp->simplified from its clauses
+ * left
+ *
+ * Returns 0 on success and -1 on failure
+ */
+int preprocess_collect(s_preprocess pp) {
+  size_t capacity = pp->litts_length + pp->clauses_length + 2 * pp->vars + 1;
+  pp->simplified = alloc_malloc(ALLOC_PREPROCESS, sizeof(int) * capacity);
+  if (!pp->simplified) return -1;
+
+  if (pp->unsat) {
+    pp->simplified[pp->simplified_length++] = 0;
+    pp->stats.removed_clauses = pp->stats.clauses - 1;
+    pp->stats.removed_litts = pp->stats.litts;
+    return 0;
+  }
+
+  // The frozen variables fixed stay as units, to be assumed by the solver
+  size_t clauses = 0, litts = 0;
+  for (size_t var = 1; var <= pp->vars; var++) {
+    if (pp->values[var] == 0 || !(pp->flags[var] & PREPROCESS_FROZEN)) continue;
+
+    pp->simplified[pp->simplified_length++] = pp->values[var] > 0 ? (int) var : -(int) var;
+    pp->simplified[pp->simplified_length++] = 0;
+    clauses++;
+    litts++;
+  }
+
+  for (size_t clause = 0; clause < pp->clauses_length; clause++) {
+    struct preprocess_clause *c = &pp->clauses[clause];
+    if (c->removed) continue;
+
+    memcpy(pp->simplified + pp->simplified_length, pp->litts + c->start,
+           sizeof(int) * c->length);
+    pp->simplified_length += c->length;
+    pp->simplified[pp->simplified_length++] = 0;
+    clauses++;
+    litts += c->length;
+  }
+
+  pp->stats.removed_clauses = pp->stats.clauses - clauses;
+  pp->stats.removed_litts = pp->stats.litts - litts;
+  return 0;
+}
+
+/* Simplifies the clauses loaded in pp (see s_preprocess_create), started
+ * at start
+ *
+ * Returns pp, or NULL once it is freed on failure
+ */
+s_preprocess preprocess_run(s_preprocess pp, double start) {
+  if (!pp->failed) {
+    preprocess_simplify(pp);
+    preprocess_eliminate_all(pp);
+  }
+
+  if (pp->failed || preprocess_collect(pp) == -1) {
+    s_preprocess_free(pp);
+    return NULL;
+  }
+
+  pp->stats.seconds = util_now() - start;
+  return pp;
+}
+
+// ===================
+
+
+// ===== BASE FUNCTIONS =====
+
+s_preprocess s_preprocess_create(s_cnf cn, const int *frozen, size_t length) {
+  if (!cn || (!frozen && length > 0)) return NULL;
+
+  double start = util_now();
+  s_preprocess pp = preprocess_create(s_cnf_get_vars_count(cn), frozen, length);
+  if (!pp) return NULL;
+
+  size_t ids_length = 0;
+  size_t *ids = s_cnf_get_clauses_ids(cn, &ids_length);
+  if (ids_length && !ids) pp->failed = true;
+
+  for (size_t k = 0; k < ids_length && !pp->unsat && !pp->failed; k++) {
+    size_t n = 0;
+    int *litts = s_cnf_clause_get_litts(cn, ids[k], &n);
+    if (n > 0 && !litts) pp->failed = true;
+    else preprocess_load_clause(pp, litts, n);
+    alloc_free(litts);
+  }
+  alloc_free(ids);
+
+  return preprocess_run(pp, start);
+}
+
+s_preprocess s_preprocess_create_from_clauses(const int *litts, size_t length,
+                                              const int *frozen, size_t frozen_length) {
+  if ((!litts && length > 0) || (length > 0 && litts[length - 1] != 0)
+      || (!frozen && frozen_length > 0))
+    return NULL;
+
+  double start = util_now();
+  size_t vars = 0;
+  for (size_t k = 0; k < length; k++)
+    if ((size_t) abs(litts[k]) > vars) vars = abs(litts[k]);
+
+  s_preprocess pp = preprocess_create(vars, frozen, frozen_length);
+  if (!pp) return NULL;
+
+  // The units first, so that the clauses they satisfy are never added
+  for (int units = 1; units >= 0; units--) {
+    size_t clause = 0;
+    for (size_t k = 0; k < length && !pp->unsat && !pp->failed; k++) {
+      if (litts[k] != 0) continue;
+      if ((k - clause == 1) == units) preprocess_load_clause(pp, litts + clause, k - clause);
+      clause = k + 1;
+    }
+  }
+
+  return preprocess_run(pp, start);
+}
+
+void s_preprocess_free(s_preprocess pp) {
+  if (!pp) return;
+
+  if (pp->lists) {
+    for (size_t k = 0; k < 2 * pp->vars + 2; k++) alloc_free(pp->lists[k].clauses);
+  }
+  if (pp->cn) s_cnf_free(pp->cn);
+
+  alloc_free(pp->simplified);
+  alloc_free(pp->litts);
+  alloc_free(pp->clauses);
+  alloc_free(pp->lists);
+  alloc_free(pp->values);
+  alloc_free(pp->flags);
+  alloc_free(pp->units);
+  alloc_free(pp->queue);
+  alloc_free(pp->removed);
+  alloc_free(pp->marks);
+  alloc_free(pp->candidates);
+  alloc_free(pp->resolvent);
+  alloc_free(pp);
+}
+
+s_cnf s_preprocess_cnf(s_preprocess pp) {
+  if (!pp || pp->cn) return pp ? pp->cn : NULL;
+
+  pp->cn = s_cnf_create();
+  if (!pp->cn) return NULL;
+
+  size_t clause = 0;
+  for (size_t k = 0; k < pp->simplified_length; k++) {
+    if (pp->simplified[k] != 0) continue;
+    if (s_cnf_add_clause(pp->cn, pp->simplified + clause, k - clause) < 0) {
+      s_cnf_free(pp->cn);
+      pp->cn = NULL;
+      return NULL;
+    }
+    clause = k + 1;
+  }
+
+  return pp->cn;
+}
+
+const int *s_preprocess_clauses(s_preprocess pp, size_t *length) {
+  if (!pp || !length) return NULL;
+
+  *length = pp->simplified_length;
+  return pp->simplified;
+}
+
+void s_preprocess_extend(s_preprocess pp, int *model) {
+  if (!pp || !model) return;
+
+  for (size_t var = 1; var <= pp->vars; var++) {
+    if (pp->values[var] != 0) model[var - 1] = pp->values[var] > 0 ? (int) var : -(int) var;
+  }
+
+  // The eliminated variables from the last one: the clauses of a variable
+  // only contain the variables eliminated after it, and its value satisfies
+  // them all since the model satisfies their resolvents
+  size_t end = pp->removed_length;
+  while (end > 0) {
+    size_t start = end - 1;
+    while (start > 0 && pp->removed[start - 1] != 0) start--;
+
+    bool satisfied = false;
+    for (size_t k = start; k < end - 1 && !satisfied; k++)
+      satisfied = model[abs(pp->removed[k]) - 1] == pp->removed[k];
+    if (!satisfied) model[abs(pp->removed[start]) - 1] = pp->removed[start];
+
+    end = start;
+  }
+}
+
+size_t s_preprocess_vars(s_preprocess pp) {
+  return pp ? pp->vars : 0;
+}
+
+void s_preprocess_get_stats(s_preprocess pp, preprocess_stats *stats) {
+  if (!pp || !stats) return;
+  *stats = pp->stats;
+}
+
+void preprocess_stats_add(preprocess_stats *total, const preprocess_stats *stats) {
+  if (!total || !stats) return;
+
+  total->fixed += stats->fixed;
+  total->subsumed += stats->subsumed;
+  total->strengthened += stats->strengthened;
+  total->eliminated += stats->eliminated;
+  total->resolvents += stats->resolvents;
+  total->vars += stats->vars;
+  total->clauses += stats->clauses;
+  total->litts += stats->litts;
+  total->removed_clauses += stats->removed_clauses;
+  total->removed_litts += stats->removed_litts;
+  total->seconds += stats->seconds;
+}
+
+// ==========================
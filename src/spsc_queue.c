@@ -0,0 +1,112 @@
+#include <stdlib.h>
+#include <stdbool.h>
+
+#include "spsc_queue.h"
+#include "alloc.h"
+
+
+// ===== STRUCTS =====
+
+// Size of a cache line, the indexes are kept on different lines so the
+// producer and the consumer don't slow each other down
+#define CACHE_LINE 64
+
+typedef struct spsc_queue {
+  // Next item to pop, only written by the consumer
+  size_t head;
+  char head_padding[CACHE_LINE - sizeof(size_t)];
+
+  // Next free slot, only written by the producer
+  size_t tail;
+  char tail_padding[CACHE_LINE - sizeof(size_t)];
+
+  // Last values of the other side's index seen by each side, so the shared
+  // index is only read again when the queue looks full or empty
+  size_t cached_head;   // Producer
+  char cached_head_padding[CACHE_LINE - sizeof(size_t)];
+  size_t cached_tail;   // Consumer
+  char cached_tail_padding[CACHE_LINE - sizeof(size_t)];
+
+  size_t mask;          // Capacity - 1 (capacity is a power of two)
+  void **items;
+} *s_spsc_queue;
+
+// ===================
+
+
+// ===== BASE FUNCTIONS =====
+
+s_spsc_queue s_spsc_queue_create(size_t capacity) {
+  if (capacity == 0) return NULL;
+
+  size_t size = 1;
+  while (size < capacity) size *= 2;
+
+  s_spsc_queue q = alloc_malloc(ALLOC_RUNTIME, sizeof(struct spsc_queue));
+  if (!q) return NULL;
+
+  q->items = alloc_malloc(ALLOC_RUNTIME, sizeof(void *) * size);
+  if (!q->items) {
+    alloc_free(q);
+    return NULL;
+  }
+
+  q->head = 0;
+  q->tail = 0;
+  q->cached_head = 0;
+  q->cached_tail = 0;
+  q->mask = size - 1;
+  return q;
+}
+
+void s_spsc_queue_free(s_spsc_queue q) {
+  alloc_free(q->items);
+  alloc_free(q);
+}
+
+bool s_spsc_queue_push(s_spsc_queue q, void *item) {
+  size_t tail = q->tail;
+
+  if (tail - q->cached_head > q->mask) {
+    q->cached_head = __atomic_load_n(&q->head, __ATOMIC_ACQUIRE);
+    if (tail - q->cached_head > q->mask) return false;
+  }
+
+  q->items[tail & q->mask] = item;
+
+  // Publish the item after writing it
+  __atomic_store_n(&q->tail, tail + 1, __ATOMIC_RELEASE);
+  return true;
+}
+
+bool s_spsc_queue_pop(s_spsc_queue q, void **item) {
+  size_t head = q->head;
+
+  if (head == q->cached_tail) {
+    q->cached_tail = __atomic_load_n(&q->tail, __ATOMIC_ACQUIRE);
+    if (head == q->cached_tail) return false;
+  }
+
+  *item = q->items[head & q->mask];
+
+  // Give the slot back after reading it
+  __atomic_store_n(&q->head, head + 1, __ATOMIC_RELEASE);
+  return true;
+}
+
+// ==========================
+
+
+// ===== GETTERS =====
+
+size_t s_spsc_queue_length(s_spsc_queue q) {
+  size_t head = __atomic_load_n(&q->head, __ATOMIC_ACQUIRE);
+  size_t tail = __atomic_load_n(&q->tail, __ATOMIC_ACQUIRE);
+  return tail - head;
+}
+
+size_t s_spsc_queue_capacity(s_spsc_queue q) {
+  return q->mask + 1;
+}
+
+// ===================
@@ -5,7 +5,14 @@
 
 #include <string.h>
 
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
 #include "sudoku.h"
+#include "trace.h"
+#include "alloc.h"
 #include "math.h"
 
 
@@ -48,63 +55,131 @@ size_t grid_coords_to_index(s_sudoku g, size_t i, size_t j) {
   return i * g->n + j;
 }
 
-/* Returns the size n of the grid from the given file
- * that must contain a grid description
- *    - filename must be non-null and represent a valid file
+/* Returns the size n of the grid described by the first line of buffer
+ * (aka the number of semicolon separated cells on this line)
+ *    - buffer must be a valid array of length characters
  *
- * Returns -1 on error
+ * Returns 0 on error
  */
-int get_grid_size_from_file(char *filename) {
-  if (!filename) return -1;
+size_t get_grid_size_from_buffer(const char *buffer, size_t length) {
+  if (!buffer || length == 0) return 0;
+
+  size_t size = 1;
+  for (size_t k = 0; k < length && buffer[k] != '\n'; k++)
+    if (buffer[k] == ';') size++;
 
-  FILE *file = fopen(filename, "r");
-  if (!file) return -1;
+  return size;
+}
+
+/* Parses the cell starting at buffer[*pos] and stores its value in val.
+ * On return *pos is the index of the separator (';', '\n') that ended the
+ * cell or length.
+ *    - Leading blanks are skipped
+ *    - Only the leading digits are read, anything else until the next
+ *      separator is ignored (so text is read as an empty cell)
+ *    - max is the biggest value accepted
+ *
+ * Returns 0 on success and -1 if the value is negative or bigger than max
+ */
+int parse_cell(const char *buffer, size_t length, size_t *pos, size_t max,
+               size_t *val) {
+  size_t k = *pos;
+  size_t value = 0;
 
-  char *buffer = NULL;
-  size_t buffer_size = 0;
-  int r = 0;
+  while (k < length && (buffer[k] == ' ' || buffer[k] == '\t')) k++;
 
-  // Read the first line of the file
-  r = getline(&buffer, &buffer_size, file);
-  if (r == 0 || buffer_size <= 0) {
-    fclose(file);
-    free(buffer);
+  // Negative values are invalid
+  if (k + 1 < length && buffer[k] == '-'
+      && buffer[k + 1] >= '0' && buffer[k + 1] <= '9')
     return -1;
+
+  while (k < length && buffer[k] >= '0' && buffer[k] <= '9') {
+    value = value * 10 + (buffer[k] - '0');
+    if (value > max) return -1;
+    k++;
   }
 
-  // Initialize strtok
-  int size = 0;
-  char *token = strtok(buffer, ";");
-  if (!token) {
-    fclose(file);
-    free(buffer);
-    return -1;
-  };
+  // Skip what is left of the cell
+  while (k < length && buffer[k] != ';' && buffer[k] != '\n') k++;
 
-  // For every token increase the size of the grid
-  do {
-    size++;
-  } while ((token = strtok(NULL, ";")));
+  *pos = k;
+  *val = value;
+  return 0;
+}
 
-  fclose(file);
-  free(buffer);
-  return size;
+/* Size in bytes of the UTF-8 box drawing characters used to print grids
+ */
+#define SEPARATOR_SIZE 3
+
+/* Returns the number of decimal digits of val
+ */
+size_t count_digits(size_t val) {
+  size_t digits = 1;
+  while (val >= 10) {
+    val /= 10;
+    digits++;
+  }
+  return digits;
+}
+
+/* Writes the decimal representation of val at p
+ *
+ * Returns a pointer to the character following the last digit
+ */
+char *write_number(char *p, size_t val) {
+  size_t digits = count_digits(val);
+
+  for (size_t k = digits; k-- > 0;) {
+    p[k] = '0' + val % 10;
+    val /= 10;
+  }
+
+  return p + digits;
+}
+
+/* Returns the size of the blocks of a grid of size n (aka sqrt(n))
+ *    - n must be a perfect square
+ */
+size_t block_size(size_t n) {
+  size_t sq = 1;
+  while ((sq + 1) * (sq + 1) <= n) sq++;
+  return sq;
 }
 
 // ===================
 
 
+// ===== CELL CHARACTERS =====
+
+int s_sudoku_char_to_value(char c) {
+  if (c == '.' || c == '0') return GRID_EMPTY_CELL;
+  if (c >= '1' && c <= '9') return c - '0';
+  if (c >= 'A' && c <= 'Z') return c - 'A' + 10;
+  if (c >= 'a' && c <= 'z') return c - 'a' + 10;
+  return -1;
+}
+
+char s_sudoku_value_to_char(size_t val) {
+  if (val == GRID_EMPTY_CELL) return '.';
+  if (val <= 9) return '0' + val;
+  if (val <= 35) return 'A' + val - 10;
+  return '?';
+}
+
+// ===========================
+
+
 // ===== BASE FUNCTIONS =====
 
 s_sudoku s_sudoku_create(size_t n) {
   if (!is_perfect_square(n) || n == 0 || n == 1) return NULL;
 
-  s_sudoku g = (s_sudoku)malloc(sizeof(struct sudoku));
+  s_sudoku g = (s_sudoku)alloc_malloc(ALLOC_SUDOKU, sizeof(struct sudoku));
   if (!g) return NULL;
 
-  size_t *grid = (size_t *)calloc(n * n, sizeof(size_t));
+  size_t *grid = (size_t *)alloc_calloc(ALLOC_SUDOKU, n * n, sizeof(size_t));
   if (!grid) {
-    free(g);
+    alloc_free(g);
     return NULL;
   }
 
@@ -114,8 +189,18 @@ s_sudoku s_sudoku_create(size_t n) {
 }
 
 void s_sudoku_free(s_sudoku g) {
-  free(g->grid);
-  free(g);
+  alloc_free(g->grid);
+  alloc_free(g);
+}
+
+s_sudoku s_sudoku_copy(s_sudoku g) {
+  if (!g) return NULL;
+
+  s_sudoku copy = s_sudoku_create(g->n);
+  if (!copy) return NULL;
+
+  memcpy(copy->grid, g->grid, sizeof(size_t) * g->n * g->n);
+  return copy;
 }
 
 // ==========================
@@ -155,143 +240,213 @@ int s_sudoku_set_cell_value(s_sudoku g, size_t i, size_t j, size_t val) {
 
 // ===== UTILITY FUNCTIONS =====
 
-s_sudoku s_sudoku_create_from_file(char *filename) {
-  if (!filename) return NULL;
-
-  // Open file
-  FILE *file = fopen(filename, "r");
-  if (!file) return NULL;
+s_sudoku s_sudoku_create_from_buffer(const char *buffer, size_t length) {
+  if (!buffer) return NULL;
 
-  // Init grid
-  int n = get_grid_size_from_file(filename);
-  if (n == -1) {
-    fclose(file);
-    return NULL;
-  }
+  // The size of the grid is given by the first line
+  size_t n = get_grid_size_from_buffer(buffer, length);
+  if (n == 0) return NULL;
 
   s_sudoku g = s_sudoku_create(n);
+  if (!g) return NULL;
 
-  char *buffer = NULL;
-  size_t buffer_size = 0;
-  int r = 0;
-
-  // Those are user to keep count
-  // of the cells position in the grid description
-  size_t i = 0; // Current grid line
-  size_t j = 0; // Current gird col
-
-  // For each line of the file
-  while ((r = getline(&buffer, &buffer_size, file)) > 0) {
-    char *token = strtok(buffer, ";");
-    if (!token) continue;
+  size_t pos = 0;
 
-    int line_size = 0;
+  // For each line of the grid
+  for (size_t i = 0; i < n; i++) {
+    // Missing lines
+    if (pos >= length) {
+      s_sudoku_free(g);
+      return NULL;
+    }
 
-    // For every token in the line
-    do {
-      // Get cell value
-      int val = atol(token);
-      if (val < 0 || val > n) {
-        fclose(file);
+    // For each cell of the line
+    for (size_t j = 0; j < n; j++) {
+      size_t val = 0;
+      if (parse_cell(buffer, length, &pos, n, &val) == -1) {
         s_sudoku_free(g);
-        free(buffer);
         return NULL;
       }
 
-      line_size++;
+      g->grid[grid_coords_to_index(g, i, j)] = val;
 
-      // If there is more cols than the size of the grid
-      // there is an error
-      if (line_size > n) {
-        fclose(file);
+      // Every cell but the last one of the line must be followed by a
+      // semicolon
+      bool has_next_cell = pos < length && buffer[pos] == ';';
+      if (has_next_cell != (j < n - 1)) {
         s_sudoku_free(g);
-        s_sudoku_free(g);
-        free(buffer);
         return NULL;
       }
+      pos++; // Skip the separator
+    }
+  }
 
-      // Update grid
-      int index = grid_coords_to_index(g, i, j);
-      g->grid[index] = val;
+  // Only blanks are allowed after the last line
+  for (; pos < length; pos++) {
+    char c = buffer[pos];
+    if (c != '\n' && c != '\r' && c != ' ' && c != '\t') {
+      s_sudoku_free(g);
+      return NULL;
+    }
+  }
 
-      j++; // Next col
-    } while ((token = strtok(NULL, ";")));
+  return g;
+}
+
+s_sudoku s_sudoku_create_from_line(const char *line, size_t length) {
+  if (!line) return NULL;
 
-    j = 0; // Reset col
-    i++;   // Next line
+  // Ignore trailing blanks
+  while (length > 0 && (line[length - 1] == '\n' || line[length - 1] == '\r'
+                        || line[length - 1] == ' ' || line[length - 1] == '\t'))
+    length--;
 
-    // If there is too much line in the file
-    // Or not enough columns in the line
-    // Error
-    if (i > n || line_size != n) {
-      fclose(file);
+  // The line contains n * n cells
+  size_t n = (size_t)sqrt(length);
+  if (n * n != length) return NULL;
+
+  s_sudoku g = s_sudoku_create(n);
+  if (!g) return NULL;
+
+  for (size_t k = 0; k < length; k++) {
+    int val = s_sudoku_char_to_value(line[k]);
+    if (val < 0 || val > n) {
       s_sudoku_free(g);
-      free(buffer);
       return NULL;
     }
+    g->grid[k] = val;
   }
 
-  // If there is not enough lines in the file
-  // Error
-  if (i != n) {
-    fclose(file);
-    s_sudoku_free(g);
-    free(buffer);
+  return g;
+}
+
+s_sudoku s_sudoku_create_from_file(char *filename) {
+  if (!filename) return NULL;
+
+  // Open file
+  int fd = open(filename, O_RDONLY);
+  if (fd == -1) return NULL;
+
+  struct stat st;
+  if (fstat(fd, &st) == -1 || st.st_size == 0) {
+    close(fd);
     return NULL;
   }
 
-  fclose(file);
-  free(buffer);
+  TRACE_BEGIN("io", "read");
+
+  // Map the whole file once and parse it in place
+  char *buffer = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+
+  s_sudoku g = NULL;
+  if (buffer != MAP_FAILED) {
+    g = s_sudoku_create_from_buffer(buffer, st.st_size);
+    munmap(buffer, st.st_size);
+  }
+
+  TRACE_END("io", "read");
   return g;
 }
 
-int s_sudoku_print(FILE *file, s_sudoku g) {
-  if (!g || !file) return -1;
+size_t s_sudoku_render_size(size_t n, sudoku_format format) {
+  size_t digits = count_digits(n);
+
+  switch (format) {
+    case SUDOKU_FORMAT_PRETTY:
+      // Lines of cells and separation lines
+      return n * (n * (digits + 2) + (n - 1) * SEPARATOR_SIZE + 1)
+             + (n - 1) * (n * 4 * SEPARATOR_SIZE + 1);
+    case SUDOKU_FORMAT_SEMICOLON:
+      return n * n * (digits + 1);
+    case SUDOKU_FORMAT_LINE:
+      return n * n + 1;
+  }
+
+  return 0;
+}
+
+size_t s_sudoku_render(s_sudoku g, sudoku_format format, char *buffer,
+                       size_t size) {
+  if (!g || !buffer || size < s_sudoku_render_size(g->n, format)) return 0;
+
+  size_t n = g->n;
+  char *p = buffer;
+
+  if (format == SUDOKU_FORMAT_LINE) {
+    for (size_t k = 0; k < n * n; k++)
+      *p++ = s_sudoku_value_to_char(g->grid[k]);
+    *p++ = '\n';
+    return p - buffer;
+  }
+
+  if (format == SUDOKU_FORMAT_SEMICOLON) {
+    for (size_t i = 0; i < n; i++) {
+      for (size_t j = 0; j < n; j++) {
+        p = write_number(p, g->grid[grid_coords_to_index(g, i, j)]);
+        *p++ = j < n - 1 ? ';' : '\n';
+      }
+    }
+    return p - buffer;
+  }
 
-  for (int i = 0; i < g->n; i++) {
-    for (int j = 0; j < g->n; j++) {
-      int index = grid_coords_to_index(g, i, j);
-      int val = g->grid[index];
+  // Size of the blocks, hard separations are shown every sq cells
+  // On a n=9 grid it is every 3 cells
+  size_t sq = block_size(n);
 
+  for (size_t i = 0; i < n; i++) {
+    for (size_t j = 0; j < n; j++) {
+      size_t val = g->grid[grid_coords_to_index(g, i, j)];
+
+      *p++ = ' ';
       if (val != 0) {
-        if (fprintf(file, " %d ", val) < 0) return -1;
+        p = write_number(p, val);
       } else {
-        if (fprintf(file, "   ") < 0) return -1;
+        *p++ = ' ';
       }
+      *p++ = ' ';
 
-      // Show hard separation every sqrt(n) cells
-      // On a n=9 grid it is every 3 cells
-      bool verticalSeparation = (j + 1) % (int)sqrt(g->n) == 0;
-      bool isLastCol = j == g->n - 1;
+      bool verticalSeparation = (j + 1) % sq == 0;
+      bool isLastCol = j == n - 1;
 
-      if (verticalSeparation && !isLastCol) {
-        if (fprintf(file, "┃") < 0) return -1;
-      } else if (!isLastCol) {
-        if (fprintf(file, "┊") < 0) return -1;
+      if (!isLastCol) {
+        const char *separator = verticalSeparation ? "┃" : "┊";
+        memcpy(p, separator, SEPARATOR_SIZE);
+        p += SEPARATOR_SIZE;
       }
     }
 
-    if (fprintf(file, "\n") < 0) return -1;
+    *p++ = '\n';
 
-    // Show hard separation every sqrt(n) cells
-    // On a n=9 grid it is every 3 cells
-    bool horizontalSeparation = (i + 1) % (int)sqrt(g->n) == 0;
-    bool isLastLine = i == g->n - 1;
+    bool horizontalSeparation = (i + 1) % sq == 0;
+    bool isLastLine = i == n - 1;
 
-    for (int k = 0; k < g->n; k++) {
-      if (horizontalSeparation && !isLastLine) {
-        if (fprintf(file, "━━━━") < 0) return -1;
-      } else if (!isLastLine) {
-        if (fprintf(file, "┈┈┈┈") < 0) return -1;
+    if (!isLastLine) {
+      const char *separator = horizontalSeparation ? "━━━━" : "┈┈┈┈";
+      for (size_t k = 0; k < n; k++) {
+        memcpy(p, separator, 4 * SEPARATOR_SIZE);
+        p += 4 * SEPARATOR_SIZE;
       }
+      *p++ = '\n';
     }
+  }
+
+  return p - buffer;
+}
+
+int s_sudoku_print(FILE *file, s_sudoku g) {
+  if (!g || !file) return -1;
 
-    if (!isLastLine)
-      if (fprintf(file, "\n") < 0) return -1;
+  size_t size = s_sudoku_render_size(g->n, SUDOKU_FORMAT_PRETTY);
+  char *buffer = alloc_malloc(ALLOC_SUDOKU, size);
+  if (!buffer) return -1;
 
-  }
+  // Render the whole grid and write it at once
+  size_t length = s_sudoku_render(g, SUDOKU_FORMAT_PRETTY, buffer, size);
+  int r = fwrite(buffer, 1, length, file) == length ? 0 : -1;
 
-  return 0;
+  alloc_free(buffer);
+  return r;
 }
 
 // =============================
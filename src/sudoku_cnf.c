@@ -1,10 +1,84 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
 #include <stdbool.h>
 
 #include <math.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/resource.h>
 
 #include "sudoku.h"
 #include "cnf.h"
 #include "sudoku_cnf.h"
+#include "dpll.h"
+#include "count.h"
+#include "portfolio.h"
+#include "preprocess.h"
+#include "trace.h"
+#include "alloc.h"
+#include "util.h"
+
+
+// ===== USEFULL DEFINES =====
+
+// Rules files of the cache directory (see sudoku_set_rules_cache) :
+//
+//    offset  size  content
+//         0     4  magic "SDKR"
+//         4     2  version (SOLVER_RULES_VERSION)
+//         6     2  size n of the grids
+//         8     8  number of litterals and separators
+//        16        clauses, litterals on 4 bytes each followed by 0
+//
+// Integers are little endian.
+#define SOLVER_RULES_HEADER_SIZE 16
+#define SOLVER_RULES_VERSION 1
+
+// ===========================
+
+
+// ===== STRUCTS =====
+
+// Rules of sudoku for a size of grid, as a formula and as its clauses one
+// after the other, each one followed by 0
+struct solver_rules {
+  s_cnf cn;
+  int *litts;
+  size_t length;
+};
+
+typedef struct sudoku_solver {
+  // rules[n] are the rules for the grids of size n (cn is NULL until a grid
+  // of size n is solved)
+  struct solver_rules *rules;
+  size_t rules_length;
+
+  // The rules of the grids of size loaded (0 for none) are kept in sat from
+  // a grid to the next (see s_dpll_rollback), the givens are assumptions
+  s_dpll sat;
+  s_portfolio portfolio;  // If not NULL, sat is its solver 0 and every
+                          // solver of the portfolio has the rules loaded
+  bool conquer;           // The portfolio shares the search instead of racing
+  bool preprocess;        // See s_sudoku_solver_set_preprocess
+  size_t loaded;
+  int *givens;
+  size_t givens_capacity;
+
+  sudoku_stats stats;   // Statistics of every grid solved
+} *s_sudoku_solver;
+
+// Enumeration of the solutions of a grid, see s_sudoku_solver_enumerate
+struct solver_enumeration {
+  s_sudoku solution;
+  sudoku_solution_callback callback;
+  void *ctx;
+};
+
+// ===================
 
 
 // ===== PRIVATE =====
@@ -25,7 +99,7 @@ typedef struct coords {
 coords *get_sudoku_line(s_sudoku g, size_t i) {
   int n = s_sudoku_size(g);
 
-  coords *cells = malloc(sizeof(coords) * n);
+  coords *cells = alloc_malloc(ALLOC_ENCODE, sizeof(coords) * n);
   if (!cells) return NULL;
 
   for (int j = 0; j < n; j++) {
@@ -45,7 +119,7 @@ coords *get_sudoku_line(s_sudoku g, size_t i) {
 coords *get_sudoku_col(s_sudoku g, size_t j) {
   int n = s_sudoku_size(g);
 
-  coords *cells = malloc(sizeof(coords) * n);
+  coords *cells = alloc_malloc(ALLOC_ENCODE, sizeof(coords) * n);
   if (!cells) return NULL;
 
   for (int i = 0; i < n; i++) {
@@ -72,7 +146,7 @@ coords *get_sudoku_col(s_sudoku g, size_t j) {
 coords *get_sudoku_block(s_sudoku g, size_t b) {
   int n = s_sudoku_size(g);
 
-  coords *cells = malloc(sizeof(coords) * n);
+  coords *cells = alloc_malloc(ALLOC_ENCODE, sizeof(coords) * n);
   if (!cells) return NULL;
 
   // Here we determine the size of the blocks
@@ -130,7 +204,7 @@ void add_cnf_sudoku_set_complete(s_cnf cn, s_sudoku g, coords *set, size_t set_l
 
     // This will contain the clause that will ensure that at
     // least one cell of the set contains this value
-    int *clause = malloc(sizeof(int) * set_length);
+    int *clause = alloc_malloc(ALLOC_ENCODE, sizeof(int) * set_length);
 
     // There is at least one cell in the set that has this value
     for (int i = 0; i < set_length; i++) {
@@ -143,7 +217,7 @@ void add_cnf_sudoku_set_complete(s_cnf cn, s_sudoku g, coords *set, size_t set_l
 
     // Add the clause to the formula
     s_cnf_add_clause(cn, clause, set_length);
-    free(clause);
+    alloc_free(clause);
 
     // Repeats for every possible values
   }
@@ -312,6 +386,496 @@ void add_cnf_cells_have_one_value(s_cnf cn, s_sudoku g) {
 
 // ====================== (1)
 
+/* Adds the rules of sudoku for grids of the size of g to the formula cn
+ * (without the default conditions of g)
+ */
+void add_cnf_sudoku_rules(s_cnf cn, s_sudoku g) {
+  // Size of the grid
+  int n = s_sudoku_size(g);
+
+  // We wan't every cell to have exactly one value
+  // To do that we will ensure that every cell has
+  // at least one value and at most one value.
+
+  // At least
+  add_cnf_cells_have_values(cn, g);
+
+  // At most
+  // REDUNDANT
+  // add_cnf_cells_have_one_value(cn, g);
+
+  // We want each line of the grid to contain every possible values exactly one
+  // time (rules of sudoku).
+
+  // For every lines
+  for (int l = 0; l < n; l++) {
+    // Get every cells of the current line
+    coords *line = get_sudoku_line(g, l);
+
+    // REDUNDANT
+    // Ensure it contains every values at least once
+    // add_cnf_sudoku_set_complete(cn, g, line, n);
+
+    // Ensure it contains every values at most once
+    add_cnf_sudoku_set_uniq(cn, g, line, n);
+
+    alloc_free(line);
+  }
+
+  // Same for columns
+
+  // For every columns
+  for (int c = 0; c < n; c++) {
+    // Get every cells of the current col
+    coords *col = get_sudoku_col(g, c);
+
+    // REDUNDANT CLAUSES
+    // Ensure it contains every values at least once
+    // add_cnf_sudoku_set_complete(cn, g, col, n);
+
+    // Ensure it contains every values at most once
+    add_cnf_sudoku_set_uniq(cn, g, col, n);
+
+    alloc_free(col);
+  }
+
+  // Same for blocks
+
+  // For every block
+  for (int b = 0; b < n; b++) {
+    // Get every cells of the current block
+    coords *block = get_sudoku_block(g, b);
+
+    // REDUNDANT CLAUSES
+    // Ensure it contains every values at least once
+    // add_cnf_sudoku_set_complete(cn, g, block, n);
+
+    // Ensure it contains every values at most once
+    add_cnf_sudoku_set_uniq(cn, g, block, n);
+
+    alloc_free(block);
+  }
+
+  // All those rules ensure that the solution we can find by solving the
+  // formula respect the rules of our initial problem sudoku problem.
+}
+
+static const char solver_rules_magic[4] = {'S', 'D', 'K', 'R'};
+
+// Directory of the rules files, NULL when they are only kept in memory
+static char *solver_cache = NULL;
+
+void solver_put_le(unsigned char *dst, uint64_t value, size_t bytes) {
+  for (size_t k = 0; k < bytes; k++)
+    dst[k] = (value >> (8 * k)) & 0xff;
+}
+
+uint64_t solver_get_le(const unsigned char *src, size_t bytes) {
+  uint64_t value = 0;
+  for (size_t k = 0; k < bytes; k++)
+    value |= (uint64_t)src[k] << (8 * k);
+  return value;
+}
+
+/* Stores in path (of size bytes) the name of the rules file of the grids of
+ * size n in the cache directory
+ *
+ * Returns 0 on success and -1 on failure
+ */
+int solver_rules_path(char *path, size_t size, size_t n) {
+  int length = snprintf(path, size, "%s/rules-%zu.sdkr", solver_cache, n);
+  return length > 0 && (size_t) length < size ? 0 : -1;
+}
+
+/* Reads the rules of the grids of size n from the cache directory
+ *
+ * Returns 0 on success and -1 on failure (no cache, missing or invalid file)
+ */
+int solver_read_rules(struct solver_rules *rules, size_t n) {
+  char path[4096];
+  if (!solver_cache || solver_rules_path(path, sizeof(path), n) == -1) return -1;
+
+  FILE *file = fopen(path, "rb");
+  if (!file) return -1;
+
+  unsigned char header[SOLVER_RULES_HEADER_SIZE];
+  bool valid = fread(header, SOLVER_RULES_HEADER_SIZE, 1, file) == 1
+               && memcmp(header, solver_rules_magic, sizeof(solver_rules_magic)) == 0
+               && solver_get_le(header + 4, 2) == SOLVER_RULES_VERSION
+               && solver_get_le(header + 6, 2) == n;
+
+  uint64_t length = valid ? solver_get_le(header + 8, 8) : 0;
+  valid = valid && length > 0 && length < SIZE_MAX / sizeof(int);
+
+  int *litts = valid ? alloc_malloc(ALLOC_ENCODE, sizeof(int) * length) : NULL;
+  long max = (long) (n * n) * (n + 1);
+
+  // Every litterals must be a variable of a grid of size n, a truncated
+  // file is invalid
+  unsigned char bytes[4];
+  size_t k = 0;
+  for (; litts && valid && k < length; k++) {
+    valid = fread(bytes, 4, 1, file) == 1;
+    if (!valid) break;
+    litts[k] = (int32_t) solver_get_le(bytes, 4);
+    valid = labs(litts[k]) <= max;
+  }
+  valid = valid && k == length && fgetc(file) == EOF;
+
+  fclose(file);
+  if (!litts || !valid || litts[length - 1] != 0) {
+    alloc_free(litts);
+    return -1;
+  }
+
+  rules->litts = litts;
+  rules->length = length;
+  return 0;
+}
+
+/* Writes the rules of the grids of size n in the cache directory, through a
+ * temporary file so that other processes never read a partial file
+ */
+void solver_write_rules(struct solver_rules *rules, size_t n) {
+  char path[4096], tmp[4096 + 8];
+  if (!solver_cache || solver_rules_path(path, sizeof(path), n) == -1) return;
+  snprintf(tmp, sizeof(tmp), "%s.XXXXXX", path);
+
+  // Readable by the other users of the directory as a normal file
+  int fd = mkstemp(tmp);
+  if (fd == -1) return;
+  fchmod(fd, 0644);
+
+  FILE *file = fdopen(fd, "wb");
+  if (!file) {
+    close(fd);
+    unlink(tmp);
+    return;
+  }
+
+  unsigned char header[SOLVER_RULES_HEADER_SIZE] = {0};
+  memcpy(header, solver_rules_magic, sizeof(solver_rules_magic));
+  solver_put_le(header + 4, SOLVER_RULES_VERSION, 2);
+  solver_put_le(header + 6, n, 2);
+  solver_put_le(header + 8, rules->length, 8);
+  bool written = fwrite(header, SOLVER_RULES_HEADER_SIZE, 1, file) == 1;
+
+  unsigned char bytes[4];
+  for (size_t k = 0; k < rules->length && written; k++) {
+    solver_put_le(bytes, (uint32_t) rules->litts[k], 4);
+    written = fwrite(bytes, 4, 1, file) == 1;
+  }
+
+  if (fclose(file) != 0) written = false;
+  if (!written || rename(tmp, path) == -1) unlink(tmp);
+}
+
+/* Stores in rules the clauses of rules->cn one after the other, each one
+ * followed by 0
+ *
+ * Returns 0 on success and -1 on failure
+ */
+int solver_flatten_rules(struct solver_rules *rules) {
+  size_t clauses_length = 0;
+  size_t *clauses = s_cnf_get_clauses_ids(rules->cn, &clauses_length);
+  if (!clauses) return -1;
+
+  size_t length = s_cnf_get_litts_count(rules->cn) + clauses_length;
+  rules->litts = alloc_malloc(ALLOC_ENCODE, sizeof(int) * length);
+  if (!rules->litts) {
+    alloc_free(clauses);
+    return -1;
+  }
+
+  rules->length = 0;
+  for (size_t k = 0; k < clauses_length; k++) {
+    size_t n = 0;
+    int *litts = s_cnf_clause_get_litts(rules->cn, clauses[k], &n);
+    if (!litts) break;
+
+    memcpy(rules->litts + rules->length, litts, sizeof(int) * n);
+    rules->length += n;
+    rules->litts[rules->length++] = 0;
+    alloc_free(litts);
+  }
+
+  alloc_free(clauses);
+  if (rules->length == length) return 0;
+
+  alloc_free(rules->litts);
+  rules->litts = NULL;
+  return -1;
+}
+
+/* Returns the rules for grids of size n of the solver, read from the cache
+ * directory or encoded the first time they are needed
+ *
+ * Returns NULL on failure
+ */
+struct solver_rules *solver_get_rules(s_sudoku_solver sv, size_t n) {
+  if (n < sv->rules_length && sv->rules[n].litts) return &sv->rules[n];
+
+  if (n >= sv->rules_length) {
+    struct solver_rules *rules = alloc_realloc(ALLOC_ENCODE, sv->rules,
+                                               sizeof(struct solver_rules) * (n + 1));
+    if (!rules) return NULL;
+
+    memset(rules + sv->rules_length, 0,
+           sizeof(struct solver_rules) * (n + 1 - sv->rules_length));
+    sv->rules = rules;
+    sv->rules_length = n + 1;
+  }
+
+  // The rules only depend on the size of the grid
+  s_sudoku g = s_sudoku_create(n);
+  if (!g) return NULL;
+
+  struct solver_rules *rules = &sv->rules[n];
+  if (solver_read_rules(rules, n) == -1) {
+    TRACE_BEGIN("sudoku", "encode_rules");
+    if (!rules->cn) rules->cn = s_cnf_create();
+    if (rules->cn && s_cnf_get_clauses_count(rules->cn) == 0) add_cnf_sudoku_rules(rules->cn, g);
+    if (rules->cn && solver_flatten_rules(rules) == 0) solver_write_rules(rules, n);
+    TRACE_END("sudoku", "encode_rules");
+  }
+
+  s_sudoku_free(g);
+  return rules->litts ? rules : NULL;
+}
+
+/* Returns the formula of the rules, built from their clauses when they were
+ * read from the cache directory
+ *
+ * Returns NULL on failure
+ */
+s_cnf solver_rules_cnf(struct solver_rules *rules) {
+  if (rules->cn) return rules->cn;
+
+  rules->cn = s_cnf_create();
+  if (!rules->cn) return NULL;
+
+  size_t start = 0;
+  for (size_t k = 0; k < rules->length; k++) {
+    if (rules->litts[k] != 0) continue;
+    if (s_cnf_add_clause(rules->cn, rules->litts + start, k - start) < 0) {
+      s_cnf_free(rules->cn);
+      rules->cn = NULL;
+      return NULL;
+    }
+    start = k + 1;
+  }
+
+  return rules->cn;
+}
+
+/* Loads the rules of the grids of size n in the sat solver sat and saves
+ * them (see s_dpll_checkpoint)
+ *
+ * Returns 0 on success and -1 on failure
+ */
+int solver_load_sat(s_dpll sat, struct solver_rules *rules, size_t n) {
+  s_dpll_reset(sat);
+
+  size_t start = 0;
+  for (size_t k = 0; k < rules->length; k++) {
+    if (rules->litts[k] != 0) continue;
+    if (s_dpll_add_clause(sat, rules->litts + start, k - start) == -1) return -1;
+    start = k + 1;
+  }
+
+  // The variables between the ones of two cells (see sat_var_to_litt) are in
+  // no clause, false so that each solution is a single model when counting
+  for (int litt = n + 1; (size_t) litt < (n + 1) * n * n; litt += n + 1) {
+    int unused = -litt;
+    if (s_dpll_add_clause(sat, &unused, 1) == -1) return -1;
+  }
+
+  return s_dpll_checkpoint(sat);
+}
+
+/* Prepares the sat solvers of sv for a grid of size n: the rules are loaded
+ * and saved the first time, then restored (see s_dpll_rollback)
+ *
+ * Returns 0 on success and -1 on failure
+ */
+int solver_load(s_sudoku_solver sv, size_t n) {
+  size_t sats = sv->portfolio ? s_portfolio_size(sv->portfolio) : 1;
+
+  if (sv->loaded == n) {
+    for (size_t k = 0; k < sats; k++) {
+      s_dpll sat = sv->portfolio ? s_portfolio_solver(sv->portfolio, k) : sv->sat;
+      if (s_dpll_rollback(sat) == -1) return -1;
+    }
+    return 0;
+  }
+
+  struct solver_rules *rules = solver_get_rules(sv, n);
+  if (!rules) return -1;
+
+  sv->loaded = 0;
+  for (size_t k = 0; k < sats; k++) {
+    s_dpll sat = sv->portfolio ? s_portfolio_solver(sv->portfolio, k) : sv->sat;
+    if (solver_load_sat(sat, rules, n) == -1) return -1;
+  }
+
+  sv->loaded = n;
+  return 0;
+}
+
+/* Returns the formula of the grids of size n with the rules of sv, the
+ * assumptions and the variables in no clause (see solver_load) as units
+ *
+ * Returns NULL on failure
+ */
+s_cnf solver_grid_cnf(s_sudoku_solver sv, int n, const int *assumptions, size_t length) {
+  struct solver_rules *rules = solver_get_rules(sv, n);
+  s_cnf rules_cn = rules ? solver_rules_cnf(rules) : NULL;
+  s_cnf cn = rules_cn ? s_cnf_copy(rules_cn) : NULL;
+  if (!cn) return NULL;
+
+  bool failed = false;
+  for (size_t k = 0; k < length; k++) {
+    int given = assumptions[k];
+    failed |= s_cnf_add_clause(cn, &given, 1) < 0;
+  }
+  for (int litt = n + 1; litt < (n + 1) * n * n; litt += n + 1) {
+    int unused = -litt;
+    failed |= s_cnf_add_clause(cn, &unused, 1) < 0;
+  }
+
+  if (failed) {
+    s_cnf_free(cn);
+    return NULL;
+  }
+  return cn;
+}
+
+/* Loads in the sat solvers of sv the formula of the grids of size n with the
+ * assumptions (see solver_grid_cnf), simplified (see preprocess.h)
+ *
+ * Returns the preprocessing, to extend the model found, and NULL on failure
+ */
+s_preprocess solver_preprocess(s_sudoku_solver sv, int n, const int *assumptions,
+                               size_t length) {
+  struct solver_rules *rules = solver_get_rules(sv, n);
+  if (!rules) return NULL;
+
+  // Same clauses as solver_grid_cnf, flat as the rules to skip the copy of
+  // their formula
+  size_t unused_length = (size_t) n * n;
+  int *litts = alloc_malloc(ALLOC_ENCODE,
+                            sizeof(int) * (rules->length + 2 * (length + unused_length)));
+  if (!litts) return NULL;
+
+  size_t litts_length = rules->length;
+  memcpy(litts, rules->litts, sizeof(int) * rules->length);
+  for (size_t k = 0; k < length; k++) {
+    litts[litts_length++] = assumptions[k];
+    litts[litts_length++] = 0;
+  }
+  for (int litt = n + 1; litt < (n + 1) * n * n; litt += n + 1) {
+    litts[litts_length++] = -litt;
+    litts[litts_length++] = 0;
+  }
+
+  s_preprocess pp = s_preprocess_create_from_clauses(litts, litts_length, NULL, 0);
+  alloc_free(litts);
+  if (!pp) return NULL;
+
+  size_t simplified_length = 0;
+  const int *simplified = s_preprocess_clauses(pp, &simplified_length);
+
+  // The rules are loaded again by the next grid solved without preprocessing
+  sv->loaded = 0;
+  size_t sats = sv->portfolio ? s_portfolio_size(sv->portfolio) : 1;
+  for (size_t k = 0; k < sats; k++) {
+    s_dpll sat = sv->portfolio ? s_portfolio_solver(sv->portfolio, k) : sv->sat;
+    s_dpll_reset(sat);
+
+    size_t start = 0;
+    for (size_t l = 0; l < simplified_length; l++) {
+      if (simplified[l] != 0) continue;
+      if (s_dpll_add_clause(sat, simplified + start, l - start) == -1) {
+        s_preprocess_free(pp);
+        return NULL;
+      }
+      start = l + 1;
+    }
+  }
+
+  return pp;
+}
+
+/* Stores in sv->givens the assumptions of the values of the cells of g
+ *
+ * Returns the number of assumptions stored and -1 on failure
+ */
+long solver_givens(s_sudoku_solver sv, s_sudoku g) {
+  double start = util_now();
+  size_t n = s_sudoku_size(g);
+  if (n * n > sv->givens_capacity) {
+    int *givens = alloc_realloc(ALLOC_ENCODE, sv->givens, sizeof(int) * n * n);
+    if (!givens) return -1;
+
+    sv->givens = givens;
+    sv->givens_capacity = n * n;
+  }
+
+  TRACE_BEGIN("sudoku", "encode");
+  size_t length = sudoku_to_assumptions(g, sv->givens);
+  TRACE_END("sudoku", "encode");
+  sv->stats.encode_seconds += util_now() - start;
+
+  return length;
+}
+
+/* Sets the values of the cells of g according to the model found by the sat
+ * solver sat
+ */
+void solver_apply_model(s_dpll sat, s_sudoku g) {
+  int n = s_sudoku_size(g);
+
+  for (int i = 0; i < n; i++) {
+    for (int j = 0; j < n; j++) {
+      for (int value = 1; value <= n; value++) {
+        sat_var v = {i, j, value, 0};
+        if (s_dpll_value(sat, sat_var_to_litt(g, v)) == 1) {
+          s_sudoku_set_cell_value(g, i, j, value);
+          break;
+        }
+      }
+    }
+  }
+}
+
+/* Sets the values of the cells of g according to the model found by the sat
+ * solver sat for the formula simplified by pp
+ *
+ * Returns 0 on success and -1 on failure
+ */
+int solver_apply_extended_model(s_dpll sat, s_preprocess pp, s_sudoku g) {
+  size_t vars = s_preprocess_vars(pp);
+  int *model = alloc_malloc(ALLOC_ENCODE, sizeof(int) * (vars + 1));
+  if (!model) return -1;
+
+  for (size_t var = 1; var <= vars; var++)
+    model[var - 1] = s_dpll_value(sat, var) == 1 ? (int) var : -(int) var;
+  s_preprocess_extend(pp, model);
+  sudoku_apply_valuations(g, model, vars);
+
+  alloc_free(model);
+  return 0;
+}
+
+/* Gives the model found by the sat solver to the callback of the
+ * enumeration ctx, as a solution
+ */
+int solver_enumerate_model(s_dpll s, void *ctx) {
+  struct solver_enumeration *e = ctx;
+  solver_apply_model(s, e->solution);
+  return e->callback(e->solution, e->ctx);
+}
+
 // ===================  (0)
 
 // ===== SAT VARIABLES =====
@@ -374,79 +938,368 @@ s_cnf sudoku_to_cnf(s_sudoku g) {
   s_cnf cn = s_cnf_create();
   if (!cn) return NULL;
 
-  // Size of the grid
-  int n = s_sudoku_size(g);
+  TRACE_BEGIN("sudoku", "encode");
 
   // Base conditions
   add_cnf_default_conditions(cn, g);
 
-  // We wan't every cell to have exactly one value
-  // To do that we will ensure that every cell has
-  // at least one value and at most one value.
+  // Rules of the game
+  add_cnf_sudoku_rules(cn, g);
 
-  // At least
-  add_cnf_cells_have_values(cn, g);
+  TRACE_END("sudoku", "encode");
+  return cn;
+}
 
-  // At most
-  // REDUNDANT
-  // add_cnf_cells_have_one_value(cn, g);
+void sudoku_apply_valuations(s_sudoku g, int *valuations, size_t length) {
+  if (!g || !valuations) return;
 
-  // We want each line of the grid to contain every possible values exactly one
-  // time (rules of sudoku).
+  // Every positive valuation is a value of a cell of the solution
+  for (size_t k = 0; k < length; k++) {
+    if (valuations[k] <= 0) continue;
 
-  // For every lines
-  for (int l = 0; l < n; l++) {
-    // Get every cells of the current line
-    coords *line = get_sudoku_line(g, l);
+    sat_var v = litt_to_sat_var(g, valuations[k]);
+    s_sudoku_set_cell_value(g, v.i, v.j, v.value);
+  }
+}
 
-    // REDUNDANT
-    // Ensure it contains every values at least once
-    // add_cnf_sudoku_set_complete(cn, g, line, n);
+size_t sudoku_to_assumptions(s_sudoku g, int *litts) {
+  if (!g || !litts) return 0;
 
-    // Ensure it contains every values at most once
-    add_cnf_sudoku_set_uniq(cn, g, line, n);
+  int n = s_sudoku_size(g);
+  size_t length = 0;
 
-    free(line);
+  for (int i = 0; i < n; i++) {
+    for (int j = 0; j < n; j++) {
+      int cell_val = s_sudoku_get_cell_value(g, i, j);
+      if (cell_val == GRID_EMPTY_CELL) continue;
+
+      sat_var v = {i, j, cell_val, 0};
+      litts[length++] = sat_var_to_litt(g, v);
+    }
   }
 
-  // Same for columns
+  return length;
+}
 
-  // For every columns
-  for (int c = 0; c < n; c++) {
-    // Get every cells of the current col
-    coords *col = get_sudoku_col(g, c);
+int sudoku_set_rules_cache(const char *directory) {
+  char *copy = NULL;
+  if (directory) {
+    copy = alloc_malloc(ALLOC_ENCODE, strlen(directory) + 1);
+    if (!copy) return -1;
+    strcpy(copy, directory);
+  }
 
-    // REDUNDANT CLAUSES
-    // Ensure it contains every values at least once
-    // add_cnf_sudoku_set_complete(cn, g, col, n);
+  alloc_free(solver_cache);
+  solver_cache = copy;
+  return 0;
+}
 
-    // Ensure it contains every values at most once
-    add_cnf_sudoku_set_uniq(cn, g, col, n);
+int sudoku_solve(s_sudoku g) {
+  if (!g) return -1;
+
+  s_sudoku_solver sv = s_sudoku_solver_create();
+  if (!sv) return -1;
+
+  int solved = s_sudoku_solver_solve(sv, g);
 
-    free(col);
+  s_sudoku_solver_free(sv);
+  return solved;
+}
+
+// ========================== (0)
+
+// ===== SOLVER =====
+
+s_sudoku_solver s_sudoku_solver_create() {
+  s_sudoku_solver sv = alloc_malloc(ALLOC_ENCODE, sizeof(struct sudoku_solver));
+  if (!sv) return NULL;
+
+  sv->sat = s_dpll_create();
+  if (!sv->sat) {
+    alloc_free(sv);
+    return NULL;
   }
 
-  // Same for blocks
+  sv->portfolio = NULL;
+  sv->conquer = false;
+  sv->preprocess = false;
+  sv->rules = NULL;
+  sv->rules_length = 0;
+  sv->loaded = 0;
+  sv->givens = NULL;
+  sv->givens_capacity = 0;
+  memset(&sv->stats, 0, sizeof(sudoku_stats));
+  return sv;
+}
 
-  // For every block
-  for (int b = 0; b < n; b++) {
-    // Get every cells of the current block
-    coords *block = get_sudoku_block(g, b);
+s_sudoku_solver s_sudoku_solver_create_portfolio(size_t solvers, bool conquer) {
+  s_sudoku_solver sv = s_sudoku_solver_create();
+  if (!sv) return NULL;
 
-    // REDUNDANT CLAUSES
-    // Ensure it contains every values at least once
-    // add_cnf_sudoku_set_complete(cn, g, block, n);
+  sv->portfolio = s_portfolio_create(solvers);
+  if (!sv->portfolio) {
+    s_sudoku_solver_free(sv);
+    return NULL;
+  }
 
-    // Ensure it contains every values at most once
-    add_cnf_sudoku_set_uniq(cn, g, block, n);
+  s_dpll_free(sv->sat);
+  sv->sat = s_portfolio_solver(sv->portfolio, 0);
+  sv->conquer = conquer;
+  return sv;
+}
 
-    free(block);
+void s_sudoku_solver_free(s_sudoku_solver sv) {
+  for (size_t n = 0; n < sv->rules_length; n++) {
+    if (sv->rules[n].cn) s_cnf_free(sv->rules[n].cn);
+    alloc_free(sv->rules[n].litts);
   }
 
-  // All those rules ensure that the solution we can find by solving the
-  // formula respect the rules of our initial problem sudoku problem.
+  if (sv->portfolio)
+    s_portfolio_free(sv->portfolio);
+  else
+    s_dpll_free(sv->sat);
+  alloc_free(sv->givens);
+  alloc_free(sv->rules);
+  alloc_free(sv);
+}
+
+void s_sudoku_solver_set_preprocess(s_sudoku_solver sv, bool preprocess) {
+  if (sv) sv->preprocess = preprocess;
+}
+
+s_cnf s_sudoku_solver_encode(s_sudoku_solver sv, s_sudoku g) {
+  if (!sv || !g) return NULL;
 
+  struct solver_rules *rules = solver_get_rules(sv, s_sudoku_size(g));
+  if (!rules) return NULL;
+
+  TRACE_BEGIN("sudoku", "encode");
+
+  // Only the default conditions depend on the grid
+  s_cnf rules_cn = solver_rules_cnf(rules);
+  s_cnf cn = rules_cn ? s_cnf_copy(rules_cn) : NULL;
+  if (cn) add_cnf_default_conditions(cn, g);
+
+  TRACE_END("sudoku", "encode");
   return cn;
 }
 
-// ========================== (0)
+int s_sudoku_solver_solve(s_sudoku_solver sv, s_sudoku g) {
+  if (!sv || !g) return -1;
+
+  long length = solver_givens(sv, g);
+  if (length == -1) return -1;
+
+  return s_sudoku_solver_solve_assuming(sv, g, sv->givens, length);
+}
+
+int s_sudoku_solver_solve_assuming(s_sudoku_solver sv, s_sudoku g, const int *assumptions,
+                                   size_t length) {
+  if (!sv || !g || (!assumptions && length > 0)) return -1;
+
+  double start = util_now();
+  s_preprocess pp = NULL;
+  int loaded;
+  if (sv->preprocess) {
+    // The assumptions are part of the simplified formula
+    TRACE_BEGIN("sudoku", "preprocess");
+    pp = solver_preprocess(sv, s_sudoku_size(g), assumptions, length);
+    TRACE_END("sudoku", "preprocess");
+    loaded = pp ? 0 : -1;
+    assumptions = NULL;
+    length = 0;
+  } else {
+    TRACE_BEGIN("sudoku", "load_rules");
+    loaded = solver_load(sv, s_sudoku_size(g));
+    TRACE_END("sudoku", "load_rules");
+  }
+  if (loaded == -1) return -1;
+  double encoded = util_now();
+
+  dpll_stats stats;
+
+  // With a portfolio, the model and the statistics are the ones of the
+  // solver which found the answer first
+  TRACE_BEGIN("sudoku", "solve");
+  s_dpll sat = sv->sat;
+  int solved;
+  if (sv->portfolio) {
+    solved = sv->conquer ? s_portfolio_conquer_assuming(sv->portfolio, assumptions, length)
+                         : s_portfolio_solve_assuming(sv->portfolio, assumptions, length);
+    if (solved != -1) sat = s_portfolio_winner(sv->portfolio);
+  } else {
+    solved = s_dpll_solve_assuming(sat, assumptions, length);
+  }
+  if (solved == 1 && pp && solver_apply_extended_model(sat, pp, g) == -1) solved = -1;
+  else if (solved == 1 && !pp) solver_apply_model(sat, g);
+  TRACE_END("sudoku", "solve");
+
+  // The preprocessing is counted apart from the encoding
+  double preprocess_seconds = 0;
+  if (pp) {
+    preprocess_stats simplified;
+    s_preprocess_get_stats(pp, &simplified);
+    preprocess_stats_add(&sv->stats.preprocess, &simplified);
+    preprocess_seconds = simplified.seconds;
+    s_preprocess_free(pp);
+  }
+
+  if (solved == -1) return -1;
+  s_dpll_get_stats(sat, &stats);
+
+  sv->stats.grids++;
+  sv->stats.solvable += solved;
+  sv->stats.encode_seconds += encoded - start - preprocess_seconds;
+  sv->stats.solve_seconds += util_now() - encoded;
+  dpll_stats_add(&sv->stats.dpll, &stats);
+
+  return solved;
+}
+
+long s_sudoku_solver_count(s_sudoku_solver sv, s_sudoku g, size_t limit) {
+  if (!sv || !g || limit == 0) return -1;
+
+  long length = solver_givens(sv, g);
+  if (length == -1) return -1;
+
+  // The number of solutions does not depend on the clauses learnt from the
+  // previous grids, so they are kept instead of being rolled back
+  double start = util_now();
+  size_t n = s_sudoku_size(g);
+  TRACE_BEGIN("sudoku", "load_rules");
+  int loaded = sv->loaded == n ? 0 : solver_load(sv, n);
+  TRACE_END("sudoku", "load_rules");
+  if (loaded == -1) return -1;
+  double encoded = util_now();
+
+  dpll_stats stats;
+
+  TRACE_BEGIN("sudoku", "solve");
+  long found = s_dpll_count_assuming(sv->sat, sv->givens, length, limit);
+  TRACE_END("sudoku", "solve");
+
+  if (found == -1) return -1;
+  s_dpll_get_stats(sv->sat, &stats);
+
+  sv->stats.grids++;
+  sv->stats.solvable += found > 0;
+  sv->stats.encode_seconds += encoded - start;
+  sv->stats.solve_seconds += util_now() - encoded;
+  dpll_stats_add(&sv->stats.dpll, &stats);
+
+  return found;
+}
+
+int s_sudoku_solver_count_all(s_sudoku_solver sv, s_sudoku g, count_number *count) {
+  if (!sv || !g || !count) return -1;
+
+  long length = solver_givens(sv, g);
+  if (length == -1) return -1;
+
+  double start = util_now();
+  TRACE_BEGIN("sudoku", "load_rules");
+  s_cnf cn = solver_grid_cnf(sv, s_sudoku_size(g), sv->givens, length);
+  TRACE_END("sudoku", "load_rules");
+  if (!cn) return -1;
+  double encoded = util_now();
+
+  TRACE_BEGIN("sudoku", "solve");
+  bool failed = count_models(cn, count, NULL) == -1;
+  TRACE_END("sudoku", "solve");
+
+  s_cnf_free(cn);
+  if (failed) return -1;
+
+  sv->stats.grids++;
+  sv->stats.solvable += *count > 0;
+  sv->stats.encode_seconds += encoded - start;
+  sv->stats.solve_seconds += util_now() - encoded;
+
+  return 0;
+}
+
+long s_sudoku_solver_enumerate(s_sudoku_solver sv, s_sudoku g,
+                               sudoku_solution_callback callback, void *ctx) {
+  if (!sv || !g || !callback) return -1;
+
+  long length = solver_givens(sv, g);
+  if (length == -1) return -1;
+
+  // As for a count, the solutions don't depend on the clauses learnt before
+  double start = util_now();
+  size_t n = s_sudoku_size(g);
+  TRACE_BEGIN("sudoku", "load_rules");
+  int loaded = sv->loaded == n ? 0 : solver_load(sv, n);
+  TRACE_END("sudoku", "load_rules");
+  if (loaded == -1) return -1;
+
+  struct solver_enumeration e = {s_sudoku_copy(g), callback, ctx};
+  if (!e.solution) return -1;
+  double encoded = util_now();
+
+  dpll_stats stats;
+
+  TRACE_BEGIN("sudoku", "solve");
+  long found = s_dpll_enumerate_assuming(sv->sat, sv->givens, length, solver_enumerate_model,
+                                         &e);
+  TRACE_END("sudoku", "solve");
+
+  s_sudoku_free(e.solution);
+  if (found == -1) return -1;
+  s_dpll_get_stats(sv->sat, &stats);
+
+  sv->stats.grids++;
+  sv->stats.solvable += found > 0;
+  sv->stats.encode_seconds += encoded - start;
+  sv->stats.solve_seconds += util_now() - encoded;
+  dpll_stats_add(&sv->stats.dpll, &stats);
+
+  return found;
+}
+
+void s_sudoku_solver_get_stats(s_sudoku_solver sv, sudoku_stats *stats) {
+  if (!sv || !stats) return;
+  *stats = sv->stats;
+}
+
+void sudoku_stats_add(sudoku_stats *total, const sudoku_stats *stats) {
+  if (!total || !stats) return;
+
+  total->grids += stats->grids;
+  total->solvable += stats->solvable;
+  total->encode_seconds += stats->encode_seconds;
+  total->solve_seconds += stats->solve_seconds;
+  dpll_stats_add(&total->dpll, &stats->dpll);
+  preprocess_stats_add(&total->preprocess, &stats->preprocess);
+}
+
+void sudoku_stats_print(FILE *file, const sudoku_stats *stats) {
+  if (!file || !stats) return;
+
+  struct rusage usage;
+  long peak_rss_kb = getrusage(RUSAGE_SELF, &usage) == 0 ? usage.ru_maxrss : -1;
+
+  // Only filled when the allocations are counted (see alloc_set_counting)
+  alloc_stats allocs;
+  alloc_get_total(&allocs);
+
+  const dpll_stats *d = &stats->dpll;
+  const preprocess_stats *p = &stats->preprocess;
+  fprintf(file, "{\"grids\": %zu, \"solvable\": %zu, \"encode_seconds\": %.6f, "
+          "\"solve_seconds\": %.6f, \"decisions\": %zu, \"propagations\": %zu, "
+          "\"pure_litterals\": %zu, \"conflicts\": %zu, \"backtracks\": %zu, "
+          "\"max_depth\": %zu, \"clauses\": %zu, \"litts\": %zu, \"vars\": %zu, "
+          "\"exported_clauses\": %zu, \"imported_clauses\": %zu, "
+          "\"preprocess_seconds\": %.6f, \"fixed_vars\": %zu, \"eliminated_vars\": %zu, "
+          "\"subsumed_clauses\": %zu, \"strengthened_litts\": %zu, "
+          "\"removed_clauses\": %zu, \"removed_litts\": %zu, \"allocations\": %zu, "
+          "\"allocated_bytes\": %zu, \"peak_allocated_bytes\": %zu, \"peak_rss_kb\": %ld}\n",
+          stats->grids, stats->solvable, stats->encode_seconds, stats->solve_seconds,
+          d->decisions, d->propagations, d->pure_litterals, d->conflicts,
+          d->backtracks, d->max_depth, d->clauses, d->litts, d->vars, d->exported,
+          d->imported, p->seconds, p->fixed, p->eliminated, p->subsumed, p->strengthened,
+          p->removed_clauses, p->removed_litts, allocs.allocations, allocs.bytes,
+          allocs.peak_bytes, peak_rss_kb);
+}
+
+// ==================
@@ -0,0 +1,295 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "sudoku.h"
+#include "sudoku_pack.h"
+#include "alloc.h"
+
+
+// ===== STRUCTS =====
+
+typedef struct sudoku_pack {
+  unsigned char *data;   // Mapped file
+  size_t data_size;
+  size_t n;
+  size_t cell_bits;
+  size_t record_size;
+  size_t count;
+} *s_sudoku_pack;
+
+typedef struct sudoku_pack_writer {
+  FILE *file;
+  size_t n;
+  size_t cell_bits;
+  size_t record_size;
+  size_t count;
+  unsigned char *record; // Record being encoded
+} *s_sudoku_pack_writer;
+
+// ===================
+
+
+// ===== PRIVATE =====
+
+static const char pack_magic[4] = {'S', 'D', 'K', 'P'};
+
+/* Returns the number of bits needed to store the values 0 to n
+ */
+size_t pack_cell_bits(size_t n) {
+  size_t bits = 1;
+  while (((size_t)1 << bits) <= n) bits++;
+  return bits;
+}
+
+/* Returns the size in bytes of a record of a grid of size n
+ */
+size_t pack_record_size(size_t n) {
+  return (n * n * pack_cell_bits(n) + 7) / 8;
+}
+
+/* Returns whether n is the size of grids a pack can store: a perfect square
+ * above 1 whose values fit in a byte, checked without creating a grid
+ */
+bool pack_valid_size(size_t n) {
+  if (n <= 1 || pack_cell_bits(n) > 8) return false;
+
+  size_t root = 1;
+  while (root * root < n) root++;
+  return root * root == n;
+}
+
+/* Little endian encoding of integers of the header
+ */
+void pack_put_le(unsigned char *dst, uint64_t value, size_t bytes) {
+  for (size_t k = 0; k < bytes; k++)
+    dst[k] = (value >> (8 * k)) & 0xff;
+}
+
+uint64_t pack_get_le(const unsigned char *src, size_t bytes) {
+  uint64_t value = 0;
+  for (size_t k = 0; k < bytes; k++)
+    value |= (uint64_t)src[k] << (8 * k);
+  return value;
+}
+
+/* Writes the header of a pack in header
+ *    - header must be an array of SUDOKU_PACK_HEADER_SIZE bytes
+ */
+void pack_write_header(unsigned char *header, size_t n, size_t count) {
+  memset(header, 0, SUDOKU_PACK_HEADER_SIZE);
+  memcpy(header, pack_magic, sizeof(pack_magic));
+  pack_put_le(header + 4, SUDOKU_PACK_VERSION, 2);
+  pack_put_le(header + 6, n, 2);
+  pack_put_le(header + 8, pack_cell_bits(n), 1);
+  pack_put_le(header + 12, pack_record_size(n), 4);
+  pack_put_le(header + 16, count, 8);
+}
+
+// ===================
+
+
+// ===== READER =====
+
+s_sudoku_pack s_sudoku_pack_open(char *filename) {
+  if (!filename) return NULL;
+
+  int fd = open(filename, O_RDONLY);
+  if (fd == -1) return NULL;
+
+  struct stat st;
+  if (fstat(fd, &st) == -1 || st.st_size < SUDOKU_PACK_HEADER_SIZE) {
+    close(fd);
+    return NULL;
+  }
+
+  unsigned char *data = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (data == MAP_FAILED) return NULL;
+
+  size_t n = pack_get_le(data + 6, 2);
+  size_t cell_bits = pack_get_le(data + 8, 1);
+  size_t record_size = pack_get_le(data + 12, 4);
+  uint64_t count = pack_get_le(data + 16, 8);
+
+  // Check that the header describes a valid pack that fits in the file, its
+  // size first so that the records are not empty
+  bool valid = memcmp(data, pack_magic, sizeof(pack_magic)) == 0
+               && pack_get_le(data + 4, 2) == SUDOKU_PACK_VERSION
+               && pack_valid_size(n) && cell_bits == pack_cell_bits(n)
+               && record_size > 0 && record_size == pack_record_size(n)
+               && count <= (st.st_size - SUDOKU_PACK_HEADER_SIZE) / record_size;
+
+  if (!valid) {
+    munmap(data, st.st_size);
+    return NULL;
+  }
+
+  s_sudoku_pack pk = alloc_malloc(ALLOC_SUDOKU, sizeof(struct sudoku_pack));
+  if (!pk) {
+    munmap(data, st.st_size);
+    return NULL;
+  }
+
+  pk->data = data;
+  pk->data_size = st.st_size;
+  pk->n = n;
+  pk->cell_bits = cell_bits;
+  pk->record_size = record_size;
+  pk->count = count;
+  return pk;
+}
+
+void s_sudoku_pack_close(s_sudoku_pack pk) {
+  munmap(pk->data, pk->data_size);
+  alloc_free(pk);
+}
+
+size_t s_sudoku_pack_size(s_sudoku_pack pk) {
+  if (!pk) return 0;
+  return pk->n;
+}
+
+size_t s_sudoku_pack_count(s_sudoku_pack pk) {
+  if (!pk) return 0;
+  return pk->count;
+}
+
+int s_sudoku_pack_load(s_sudoku_pack pk, size_t index, s_sudoku g) {
+  if (!pk || !g || index >= pk->count || s_sudoku_size(g) != pk->n) return -1;
+
+  const unsigned char *record =
+    pk->data + SUDOKU_PACK_HEADER_SIZE + index * pk->record_size;
+  size_t mask = ((size_t)1 << pk->cell_bits) - 1;
+
+  size_t bit = 0;
+  for (size_t i = 0; i < pk->n; i++) {
+    for (size_t j = 0; j < pk->n; j++) {
+      // A cell is at most 8 bits so it spans at most two bytes
+      size_t byte = bit / 8;
+      size_t word = record[byte];
+      if (byte + 1 < pk->record_size) word |= (size_t)record[byte + 1] << 8;
+
+      size_t val = (word >> (bit % 8)) & mask;
+      if (s_sudoku_set_cell_value(g, i, j, val) == -1) return -1;
+
+      bit += pk->cell_bits;
+    }
+  }
+
+  return 0;
+}
+
+s_sudoku s_sudoku_pack_get(s_sudoku_pack pk, size_t index) {
+  if (!pk || index >= pk->count) return NULL;
+
+  s_sudoku g = s_sudoku_create(pk->n);
+  if (!g) return NULL;
+
+  if (s_sudoku_pack_load(pk, index, g) == -1) {
+    s_sudoku_free(g);
+    return NULL;
+  }
+
+  return g;
+}
+
+// ==================
+
+
+// ===== WRITER =====
+
+s_sudoku_pack_writer s_sudoku_pack_writer_create(char *filename, size_t n) {
+  if (!filename) return NULL;
+
+  // Only valid grid sizes that fit in the header (and the two bytes read per
+  // cell)
+  if (!pack_valid_size(n)) return NULL;
+
+  s_sudoku_pack_writer w = alloc_malloc(ALLOC_SUDOKU, sizeof(struct sudoku_pack_writer));
+  if (!w) return NULL;
+
+  w->n = n;
+  w->cell_bits = pack_cell_bits(n);
+  w->record_size = pack_record_size(n);
+  w->count = 0;
+
+  w->record = alloc_malloc(ALLOC_SUDOKU, w->record_size);
+  if (!w->record) {
+    alloc_free(w);
+    return NULL;
+  }
+
+  w->file = fopen(filename, "wb");
+  if (!w->file) {
+    alloc_free(w->record);
+    alloc_free(w);
+    return NULL;
+  }
+
+  // Header with a count of 0 until the writer is closed
+  unsigned char header[SUDOKU_PACK_HEADER_SIZE];
+  pack_write_header(header, n, 0);
+  if (fwrite(header, SUDOKU_PACK_HEADER_SIZE, 1, w->file) != 1) {
+    fclose(w->file);
+    alloc_free(w->record);
+    alloc_free(w);
+    return NULL;
+  }
+
+  return w;
+}
+
+int s_sudoku_pack_writer_add(s_sudoku_pack_writer w, s_sudoku g) {
+  if (!w || !g || s_sudoku_size(g) != w->n) return -1;
+
+  memset(w->record, 0, w->record_size);
+
+  size_t bit = 0;
+  for (size_t i = 0; i < w->n; i++) {
+    for (size_t j = 0; j < w->n; j++) {
+      size_t val = s_sudoku_get_cell_value(g, i, j);
+      size_t byte = bit / 8;
+
+      w->record[byte] |= (val << (bit % 8)) & 0xff;
+      if (byte + 1 < w->record_size)
+        w->record[byte + 1] |= (val << (bit % 8)) >> 8;
+
+      bit += w->cell_bits;
+    }
+  }
+
+  if (fwrite(w->record, w->record_size, 1, w->file) != 1) return -1;
+
+  w->count++;
+  return 0;
+}
+
+int s_sudoku_pack_writer_close(s_sudoku_pack_writer w) {
+  if (!w) return -1;
+
+  // Rewrite the header with the final number of grids
+  unsigned char header[SUDOKU_PACK_HEADER_SIZE];
+  pack_write_header(header, w->n, w->count);
+
+  int r = 0;
+  if (fseek(w->file, 0, SEEK_SET) != 0
+      || fwrite(header, SUDOKU_PACK_HEADER_SIZE, 1, w->file) != 1)
+    r = -1;
+  if (fclose(w->file) != 0) r = -1;
+
+  alloc_free(w->record);
+  alloc_free(w);
+  return r;
+}
+
+// ==================
@@ -0,0 +1,180 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+
+#include <string.h>
+
+#include "sudoku.h"
+#include "sudoku_stream.h"
+#include "trace.h"
+#include "alloc.h"
+
+
+// ===== STRUCTS =====
+
+typedef struct sudoku_stream {
+  FILE *file;
+
+  // Current line of the file (reused for every line)
+  char *line;
+  size_t line_capacity;
+
+  // Lines of the current semicolon grid (reused for every grid)
+  char *grid;
+  size_t grid_length;
+  size_t grid_capacity;
+
+  size_t line_number;  // Number of lines read so far
+  size_t grid_line;    // Line where the last grid starts
+  bool eof;
+} *s_sudoku_stream;
+
+// ===================
+
+
+// ===== PRIVATE =====
+
+/* Reads the next line of the stream in st->line
+ *
+ * Returns the length of the line or -1 at the end of the file
+ */
+ssize_t stream_read_line(s_sudoku_stream st) {
+  ssize_t r = getline(&st->line, &st->line_capacity, st->file);
+  if (r == -1) return -1;
+
+  st->line_number++;
+  return r;
+}
+
+/* Returns whether the line should be skipped between two grids (empty line
+ * or comment)
+ */
+bool stream_line_is_ignored(const char *line, size_t length) {
+  if (length > 0 && line[0] == '#') return true;
+
+  for (size_t k = 0; k < length; k++) {
+    char c = line[k];
+    if (c != '\n' && c != '\r' && c != ' ' && c != '\t') return false;
+  }
+
+  return true;
+}
+
+/* Appends the current line to the semicolon grid buffer
+ *
+ * Returns 0 on success and -1 on failure
+ */
+int stream_append_line(s_sudoku_stream st, size_t length) {
+  if (st->grid_length + length > st->grid_capacity) {
+    size_t capacity = st->grid_capacity ? st->grid_capacity : 256;
+    while (capacity < st->grid_length + length) capacity *= 2;
+
+    char *grid = alloc_realloc(ALLOC_SUDOKU, st->grid, capacity);
+    if (!grid) return -1;
+
+    st->grid = grid;
+    st->grid_capacity = capacity;
+  }
+
+  memcpy(st->grid + st->grid_length, st->line, length);
+  st->grid_length += length;
+  return 0;
+}
+
+/* Reads the rest of a semicolon grid whose first line is in st->line and
+ * returns it
+ *
+ * Returns NULL on failure
+ */
+s_sudoku stream_next_semicolon_grid(s_sudoku_stream st, size_t length) {
+  // The size of the grid is given by its first line
+  size_t n = 1;
+  for (size_t k = 0; k < length; k++)
+    if (st->line[k] == ';') n++;
+
+  st->grid_length = 0;
+  if (stream_append_line(st, length) == -1) return NULL;
+
+  for (size_t i = 1; i < n; i++) {
+    ssize_t r = stream_read_line(st);
+    if (r == -1) return NULL; // Missing lines
+    if (stream_append_line(st, r) == -1) return NULL;
+  }
+
+  return s_sudoku_create_from_buffer(st->grid, st->grid_length);
+}
+
+// ===================
+
+
+// ===== BASE FUNCTIONS =====
+
+s_sudoku_stream s_sudoku_stream_create(FILE *file) {
+  if (!file) return NULL;
+
+  s_sudoku_stream st = alloc_malloc(ALLOC_SUDOKU, sizeof(struct sudoku_stream));
+  if (!st) return NULL;
+
+  st->file = file;
+  st->line = NULL;
+  st->line_capacity = 0;
+  st->grid = NULL;
+  st->grid_length = 0;
+  st->grid_capacity = 0;
+  st->line_number = 0;
+  st->grid_line = 0;
+  st->eof = false;
+  return st;
+}
+
+void s_sudoku_stream_free(s_sudoku_stream st) {
+  free(st->line);       // Allocated by getline
+  alloc_free(st->grid);
+  alloc_free(st);
+}
+
+s_sudoku s_sudoku_stream_next(s_sudoku_stream st) {
+  if (!st || st->eof) return NULL;
+
+  // Skip everything until the first line of the next grid
+  ssize_t r = 0;
+  do {
+    r = stream_read_line(st);
+    if (r == -1) {
+      st->eof = true;
+      return NULL;
+    }
+  } while (stream_line_is_ignored(st->line, r));
+
+  st->grid_line = st->line_number;
+
+  TRACE_BEGIN("io", "parse");
+
+  s_sudoku g;
+  if (memchr(st->line, ';', r))
+    g = stream_next_semicolon_grid(st, r);
+  else
+    g = s_sudoku_create_from_line(st->line, r);
+
+  TRACE_END("io", "parse");
+  return g;
+}
+
+// ==========================
+
+
+// ===== GETTERS =====
+
+bool s_sudoku_stream_eof(s_sudoku_stream st) {
+  if (!st) return true;
+  return st->eof;
+}
+
+size_t s_sudoku_stream_line(s_sudoku_stream st) {
+  if (!st) return 0;
+  return st->grid_line;
+}
+
+// ===================
@@ -0,0 +1,114 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <string.h>
+
+#include "sudoku.h"
+#include "sudoku_writer.h"
+#include "trace.h"
+#include "alloc.h"
+
+
+// ===== STRUCTS =====
+
+typedef struct sudoku_writer {
+  FILE *file;
+  char *buffer;
+  size_t length;
+  size_t capacity;
+} *s_sudoku_writer;
+
+// ===================
+
+
+// ===== PRIVATE =====
+
+/* Makes sure there is room for size more bytes in the buffer of the writer,
+ * by flushing it or growing it if size is bigger than its capacity
+ *
+ * Returns 0 on success and -1 on failure
+ */
+int writer_reserve(s_sudoku_writer w, size_t size) {
+  if (w->length + size <= w->capacity) return 0;
+
+  if (s_sudoku_writer_flush(w) == -1) return -1;
+  if (size <= w->capacity) return 0;
+
+  char *buffer = alloc_realloc(ALLOC_SUDOKU, w->buffer, size);
+  if (!buffer) return -1;
+
+  w->buffer = buffer;
+  w->capacity = size;
+  return 0;
+}
+
+// ===================
+
+
+// ===== BASE FUNCTIONS =====
+
+s_sudoku_writer s_sudoku_writer_create(FILE *file, size_t capacity) {
+  if (!file || capacity == 0) return NULL;
+
+  s_sudoku_writer w = alloc_malloc(ALLOC_SUDOKU, sizeof(struct sudoku_writer));
+  if (!w) return NULL;
+
+  w->buffer = alloc_malloc(ALLOC_SUDOKU, capacity);
+  if (!w->buffer) {
+    alloc_free(w);
+    return NULL;
+  }
+
+  w->file = file;
+  w->length = 0;
+  w->capacity = capacity;
+  return w;
+}
+
+void s_sudoku_writer_free(s_sudoku_writer w) {
+  s_sudoku_writer_flush(w);
+  alloc_free(w->buffer);
+  alloc_free(w);
+}
+
+int s_sudoku_writer_write(s_sudoku_writer w, s_sudoku g, sudoku_format format) {
+  if (!w || !g) return -1;
+
+  size_t size = s_sudoku_render_size(s_sudoku_size(g), format);
+  if (writer_reserve(w, size) == -1) return -1;
+
+  TRACE_BEGIN("io", "print");
+  size_t length = s_sudoku_render(g, format, w->buffer + w->length, size);
+  TRACE_END("io", "print");
+  if (length == 0) return -1;
+
+  w->length += length;
+  return 0;
+}
+
+int s_sudoku_writer_write_string(s_sudoku_writer w, const char *str,
+                                 size_t length) {
+  if (!w || (!str && length > 0)) return -1;
+
+  if (writer_reserve(w, length) == -1) return -1;
+
+  memcpy(w->buffer + w->length, str, length);
+  w->length += length;
+  return 0;
+}
+
+int s_sudoku_writer_flush(s_sudoku_writer w) {
+  if (!w) return -1;
+  if (w->length == 0) return 0;
+
+  TRACE_BEGIN("io", "write");
+  size_t written = fwrite(w->buffer, 1, w->length, w->file);
+  int flushed = fflush(w->file);
+  TRACE_END("io", "write");
+  if (written != w->length || flushed != 0) return -1;
+
+  w->length = 0;
+  return 0;
+}
+
+// ==========================
@@ -0,0 +1,74 @@
+#include <stdlib.h>
+
+#include <string.h>
+
+#include "sudoku.h"
+#include "sudoku_cnf.h"
+#include "sudokusat.h"
+
+
+// ===== PRIVATE =====
+
+/* Solves g with sv, or with a temporary solver when sv is NULL
+ *
+ * Returns 1 if g is solved, 0 if it has no solution and -1 on failure
+ */
+int sudokusat_solve(s_sudoku_solver sv, s_sudoku g) {
+  if (sv) return s_sudoku_solver_solve(sv, g);
+  return sudoku_solve(g);
+}
+
+// ===================
+
+
+// ===== BASE FUNCTIONS =====
+
+int sudokusat_solve_cells(s_sudoku_solver sv, const int *cells, size_t n, int *solution) {
+  if (!cells || !solution) return -1;
+
+  s_sudoku g = s_sudoku_create(n);
+  if (!g) return -1;
+
+  for (size_t k = 0; k < n * n; k++) {
+    if (cells[k] < 0 || s_sudoku_set_cell_value(g, k / n, k % n, cells[k]) == -1) {
+      s_sudoku_free(g);
+      return -1;
+    }
+  }
+
+  int solved = sudokusat_solve(sv, g);
+  if (solved == 1) {
+    for (size_t k = 0; k < n * n; k++)
+      solution[k] = s_sudoku_get_cell_value(g, k / n, k % n);
+  }
+
+  s_sudoku_free(g);
+  return solved;
+}
+
+long sudokusat_solve_string(s_sudoku_solver sv, const char *grid, size_t length,
+                            sudoku_format format, char *buffer, size_t size) {
+  if (!grid || !buffer) return -1;
+
+  s_sudoku g = memchr(grid, ';', length) ? s_sudoku_create_from_buffer(grid, length)
+                                         : s_sudoku_create_from_line(grid, length);
+  if (!g) return -1;
+
+  // One more byte for the null character
+  if (size <= s_sudoku_render_size(s_sudoku_size(g), format)) {
+    s_sudoku_free(g);
+    return -1;
+  }
+
+  long written = sudokusat_solve(sv, g);
+  if (written == 1) {
+    written = s_sudoku_render(g, format, buffer, size);
+    if (written == 0) written = -1;
+    else buffer[written] = '\0';
+  }
+
+  s_sudoku_free(g);
+  return written;
+}
+
+// ==========================
@@ -0,0 +1,212 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+
+#include <string.h>
+#include <sched.h>
+#include <pthread.h>
+
+#include "trace.h"
+#include "alloc.h"
+#include "util.h"
+
+
+// ===== STRUCTS =====
+
+// Events of a chunk, the records of a trace are allocated by chunks
+#define TRACE_CHUNK_EVENTS 4096
+#define TRACE_CHUNKS (TRACE_MAX_EVENTS / TRACE_CHUNK_EVENTS)
+
+struct trace_record {
+  const char *category;
+  const char *name;
+  char phase;           // 0 for a record never written, see trace_event
+  unsigned tid;
+  double ts;            // Microseconds since the start of the trace
+};
+
+/* Trace being recorded: each event takes the next index of records with an
+ * atomic increment, so the threads never wait for each other, and the chunk
+ * of the index is allocated by its first event
+ */
+struct trace {
+  char *filename;
+  struct trace_record *chunks[TRACE_CHUNKS];
+  size_t length;        // Indexes taken, the ones past TRACE_MAX_EVENTS are
+  size_t dropped;       // dropped like the ones of chunks not allocated
+  size_t writers;       // Events being recorded, waited for by trace_stop
+  double start;
+  pthread_mutex_t mutex;  // Taken by trace_start and trace_stop only
+};
+
+// ===================
+
+
+// ===== PRIVATE =====
+
+static struct trace trace = {.mutex = PTHREAD_MUTEX_INITIALIZER};
+
+// Whether a trace is started, read without the mutex by trace_event
+static int trace_active = 0;
+
+// Next id given to a thread, and id of the current thread (0 until its
+// first event)
+static unsigned trace_next_tid = 1;
+static __thread unsigned trace_tid = 0;
+
+// Timestamps of the events are in microseconds
+double trace_now() {
+  return util_now() * 1e6;
+}
+
+/* Writes str as a JSON string to file
+ */
+void trace_write_string(FILE *file, const char *str) {
+  fputc('"', file);
+  for (; *str; str++) {
+    if (*str == '"' || *str == '\\') fputc('\\', file);
+    if ((unsigned char) *str >= 0x20) fputc(*str, file);
+  }
+  fputc('"', file);
+}
+
+int trace_write(FILE *file) {
+  size_t length = trace.length < TRACE_MAX_EVENTS ? trace.length : TRACE_MAX_EVENTS;
+  fprintf(file, "{\"displayTimeUnit\": \"ns\", \"otherData\": {\"dropped_events\": %zu},\n"
+          "\"traceEvents\": [", trace.dropped);
+
+  bool first = true;
+  for (size_t k = 0; k < length; k++) {
+    struct trace_record *chunk = trace.chunks[k / TRACE_CHUNK_EVENTS];
+    struct trace_record *r = chunk ? &chunk[k % TRACE_CHUNK_EVENTS] : NULL;
+    if (!r || !r->phase) continue;
+
+    fprintf(file, "%s\n{\"name\": ", first ? "" : ",");
+    first = false;
+    trace_write_string(file, r->name);
+    fprintf(file, ", \"cat\": ");
+    trace_write_string(file, r->category);
+    fprintf(file, ", \"ph\": \"%c\", \"ts\": %.3f, \"pid\": 1, \"tid\": %u%s}",
+            r->phase, r->ts, r->tid, r->phase == 'i' ? ", \"s\": \"t\"" : "");
+  }
+
+  fprintf(file, "\n]}\n");
+  return ferror(file) ? -1 : 0;
+}
+
+/* Returns the chunk of records k of the trace, allocated by the first
+ * thread needing it, and NULL on failure
+ */
+struct trace_record *trace_chunk(size_t k) {
+  struct trace_record *chunk = __atomic_load_n(&trace.chunks[k], __ATOMIC_ACQUIRE);
+  if (chunk) return chunk;
+
+  struct trace_record *allocated = alloc_calloc(ALLOC_RUNTIME, TRACE_CHUNK_EVENTS,
+                                                sizeof(struct trace_record));
+  if (!allocated) return __atomic_load_n(&trace.chunks[k], __ATOMIC_ACQUIRE);
+
+  // Another thread may have allocated it meanwhile
+  if (__atomic_compare_exchange_n(&trace.chunks[k], &chunk, allocated, false,
+                                  __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+    return allocated;
+
+  alloc_free(allocated);
+  return chunk;
+}
+
+// ===================
+
+
+// ===== BASE FUNCTIONS =====
+
+int trace_start(const char *filename) {
+  if (!trace_available() || !filename) return -1;
+
+  pthread_mutex_lock(&trace.mutex);
+
+  int status = -1;
+  if (!trace.filename) {
+    trace.filename = alloc_malloc(ALLOC_RUNTIME, strlen(filename) + 1);
+    if (trace.filename) {
+      strcpy(trace.filename, filename);
+      trace.length = 0;
+      trace.dropped = 0;
+      trace.start = trace_now();
+      __atomic_store_n(&trace_active, 1, __ATOMIC_RELEASE);
+      status = 0;
+    }
+  }
+
+  pthread_mutex_unlock(&trace.mutex);
+  return status;
+}
+
+int trace_stop() {
+  pthread_mutex_lock(&trace.mutex);
+
+  if (!trace.filename) {
+    pthread_mutex_unlock(&trace.mutex);
+    return -1;
+  }
+
+  // The events being recorded are written before the file
+  __atomic_store_n(&trace_active, 0, __ATOMIC_SEQ_CST);
+  while (__atomic_load_n(&trace.writers, __ATOMIC_SEQ_CST) > 0) sched_yield();
+
+  FILE *file = fopen(trace.filename, "w");
+  int status = file ? trace_write(file) : -1;
+  if (file && fclose(file) != 0) status = -1;
+
+  for (size_t k = 0; k < TRACE_CHUNKS; k++) {
+    alloc_free(trace.chunks[k]);
+    trace.chunks[k] = NULL;
+  }
+  alloc_free(trace.filename);
+  trace.filename = NULL;
+  trace.length = 0;
+
+  pthread_mutex_unlock(&trace.mutex);
+  return status;
+}
+
+void trace_event(const char *category, const char *name, char phase) {
+  if (!__atomic_load_n(&trace_active, __ATOMIC_ACQUIRE)) return;
+
+  double ts = trace_now();
+  if (trace_tid == 0)
+    trace_tid = __atomic_fetch_add(&trace_next_tid, 1, __ATOMIC_RELAXED);
+
+  // Counted as a writer before checking again that the trace is not
+  // stopped, trace_stop waits for it otherwise
+  __atomic_fetch_add(&trace.writers, 1, __ATOMIC_SEQ_CST);
+  if (__atomic_load_n(&trace_active, __ATOMIC_SEQ_CST)) {
+    size_t k = __atomic_fetch_add(&trace.length, 1, __ATOMIC_RELAXED);
+    struct trace_record *chunk = k < TRACE_MAX_EVENTS ? trace_chunk(k / TRACE_CHUNK_EVENTS)
+                                                      : NULL;
+
+    if (chunk) {
+      struct trace_record r = {category, name, phase, trace_tid, ts - trace.start};
+      chunk[k % TRACE_CHUNK_EVENTS] = r;
+    } else {
+      __atomic_fetch_add(&trace.dropped, 1, __ATOMIC_RELAXED);
+    }
+  }
+  __atomic_fetch_sub(&trace.writers, 1, __ATOMIC_RELEASE);
+}
+
+// ==========================
+
+
+// ===== GETTERS =====
+
+bool trace_available() {
+#ifdef SUDOKUSAT_TRACE
+  return true;
+#else
+  return false;
+#endif
+}
+
+// ===================
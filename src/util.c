@@ -0,0 +1,39 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdlib.h>
+
+#include <time.h>
+
+#include "util.h"
+#include "alloc.h"
+
+
+// ===== BASE FUNCTIONS =====
+
+double util_now() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+int util_compare_ints(const void *a, const void *b) {
+  int x = *(const int *) a, y = *(const int *) b;
+  return (x > y) - (x < y);
+}
+
+int util_grow(alloc_subsystem subsystem, void **ptr, size_t *capacity, size_t length,
+              size_t size) {
+  if (length <= *capacity) return 0;
+
+  size_t new_capacity = *capacity ? *capacity : 16;
+  while (new_capacity < length) new_capacity *= 2;
+
+  void *grown = alloc_realloc(subsystem, *ptr, new_capacity * size);
+  if (!grown) return -1;
+
+  *ptr = grown;
+  *capacity = new_capacity;
+  return 0;
+}
+
+// ==========================
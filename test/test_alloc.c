@@ -0,0 +1,179 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+
+#include <string.h>
+#include <assert.h>
+
+#include "alloc.h"
+#include "sudoku.h"
+#include "cnf.h"
+#include "dpll.h"
+
+// Allocator counting the calls made to it, over the C library one
+struct test_allocator {
+  size_t mallocs, callocs, reallocs, frees;
+};
+
+void *test_malloc(void *ctx, size_t size) {
+  ((struct test_allocator *) ctx)->mallocs++;
+  return malloc(size);
+}
+
+void *test_calloc(void *ctx, size_t count, size_t size) {
+  ((struct test_allocator *) ctx)->callocs++;
+  return calloc(count, size);
+}
+
+void *test_realloc(void *ctx, void *ptr, size_t size) {
+  ((struct test_allocator *) ctx)->reallocs++;
+  return realloc(ptr, size);
+}
+
+void test_free(void *ctx, void *ptr) {
+  ((struct test_allocator *) ctx)->frees++;
+  free(ptr);
+}
+
+void test_alloc_set_allocator() {
+  struct test_allocator t = {0};
+  alloc_allocator allocator = {test_malloc, test_calloc, test_realloc, test_free, NULL, &t};
+  alloc_set_allocator(&allocator);
+
+  void *a = alloc_malloc(ALLOC_SUDOKU, 16);
+  void *b = alloc_calloc(ALLOC_CNF, 4, 8);
+  a = alloc_realloc(ALLOC_SUDOKU, a, 64);
+  assert(a && b);
+  alloc_free(a);
+  alloc_free(b);
+  alloc_free(NULL);                   // Ignored as free(NULL)
+
+  assert(t.mallocs == 1 && t.callocs == 1 && t.reallocs == 1 && t.frees == 2);
+
+  // The library allocates through it too
+  s_sudoku g = s_sudoku_create(4);
+  assert(g);
+  s_sudoku_free(g);
+  assert(t.mallocs == 2 && t.callocs == 2 && t.frees == 4);
+
+  alloc_set_allocator(NULL);
+  free(alloc_malloc(ALLOC_SUDOKU, 16));   // Back to the C library
+  assert(t.mallocs == 2);
+}
+
+void test_alloc_get_stats() {
+  alloc_stats stats;
+
+  // Nothing is counted by default
+  alloc_reset_stats();
+  alloc_free(alloc_malloc(ALLOC_SUDOKU, 16));
+  alloc_get_total(&stats);
+  assert(stats.allocations == 0 && stats.frees == 0 && stats.peak_bytes == 0);
+
+  alloc_set_counting(true);
+
+  void *a = alloc_malloc(ALLOC_SUDOKU, 100);
+  void *b = alloc_calloc(ALLOC_CNF, 10, 30);
+  a = alloc_realloc(ALLOC_SUDOKU, a, 1000);
+  assert(a && b);
+
+  alloc_get_stats(ALLOC_SUDOKU, &stats);
+  assert(stats.allocations == 2 && stats.bytes == 1100);
+  alloc_get_stats(ALLOC_CNF, &stats);
+  assert(stats.allocations == 1 && stats.bytes == 300);
+  alloc_get_stats(ALLOC_DPLL, &stats);
+  assert(stats.allocations == 0 && stats.bytes == 0);
+
+  alloc_get_total(&stats);
+  assert(stats.allocations == 3 && stats.bytes == 1400 && stats.frees == 0);
+  assert(stats.live_bytes >= 1300 && stats.peak_bytes == stats.live_bytes);
+  size_t peak = stats.peak_bytes;
+
+  alloc_free(a);
+  alloc_free(b);
+
+  // The peak stays after the frees
+  alloc_get_total(&stats);
+  assert(stats.frees == 2 && stats.live_bytes == 0 && stats.peak_bytes == peak);
+
+  alloc_reset_stats();
+  alloc_get_total(&stats);
+  assert(stats.allocations == 0 && stats.bytes == 0 && stats.peak_bytes == 0);
+
+  alloc_set_counting(false);
+
+  assert(strcmp(alloc_subsystem_name(ALLOC_CNF), "cnf") == 0);
+  assert(strcmp(alloc_subsystem_name(ALLOC_SUBSYSTEMS), "unknown") == 0);
+}
+
+void test_alloc_hot_paths() {
+  char line[] = ".12....1.3.2.2..";
+  s_sudoku g = s_sudoku_create_from_line(line, strlen(line));
+  assert(g);
+
+  s_cnf cn = s_cnf_create();
+  int clause[] = {1, -2, 3};
+  int c_id = s_cnf_add_clause(cn, clause, 3);
+  assert(c_id >= 0);
+
+  char buffer[1024];
+  alloc_stats stats;
+
+  alloc_set_counting(true);
+  alloc_reset_stats();
+
+  // Rendering a grid and querying a formula don't allocate
+  assert(s_sudoku_render(g, SUDOKU_FORMAT_PRETTY, buffer, sizeof(buffer)) > 0);
+  assert(s_cnf_clause_contains_litt(cn, c_id, -2) == 1);
+  assert(s_cnf_clause_unit(cn, c_id) == 0);
+
+  alloc_get_total(&stats);
+  assert(stats.allocations == 0);
+
+  // Every block of a copy and of a resolution is given back
+  s_cnf copy = s_cnf_copy(cn);
+  assert(copy);
+  s_cnf_clause_remove_litt(copy, c_id, 3);
+  s_cnf_free(copy);
+
+  int *valuations = NULL;
+  size_t valuations_length = 0;
+  assert(dpll_valuations(cn, &valuations, &valuations_length));
+  alloc_free(valuations);
+
+  alloc_get_total(&stats);
+  assert(stats.allocations > 0 && stats.live_bytes == 0 && stats.peak_bytes > 0);
+
+  alloc_get_stats(ALLOC_CNF, &stats);
+  assert(stats.allocations > 0);
+
+  alloc_set_counting(false);
+
+  s_cnf_free(cn);
+  s_sudoku_free(g);
+}
+
+void usage(char *exec) {
+  printf("%s testname     -> Execute the given testname\n", exec);
+  printf("%s all    -> Execute every tests\n", exec);
+}
+
+int main(int argc, char *argv[]) {
+  if (argc != 2) {
+    usage(argv[0]);
+    exit(EXIT_FAILURE);
+  }
+
+  bool execute_all = strcmp(argv[1], "all") == 0;
+
+  if (strcmp(argv[1], "test_alloc_set_allocator") == 0 || execute_all) {
+    test_alloc_set_allocator();
+  }
+  if (strcmp(argv[1], "test_alloc_get_stats") == 0 || execute_all) {
+    test_alloc_get_stats();
+  }
+  if (strcmp(argv[1], "test_alloc_hot_paths") == 0 || execute_all) {
+    test_alloc_hot_paths();
+  }
+  return EXIT_SUCCESS;
+}
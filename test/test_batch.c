@@ -0,0 +1,162 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+
+#include <string.h>
+#include <assert.h>
+
+#include "sudoku.h"
+#include "sudoku_writer.h"
+#include "batch.h"
+
+/* Reads the whole content of file in buffer and returns its length
+ */
+size_t read_file(FILE *file, char *buffer, size_t size) {
+  rewind(file);
+  size_t length = fread(buffer, 1, size - 1, file);
+  buffer[length] = '\0';
+  return length;
+}
+
+void test_batch_solve() {
+  char *filenames[] = {"../data/test.txt", "../data/test2.txt", "../data/test.txt",
+                       "../data/test1.txt", "../data/test2.txt"};
+  char expected[] =
+    "3124243113424213\n"
+    "1342241331244231\n"
+    "3124243113424213\n";
+
+  // The output is in the input order whatever the number of threads
+  for (size_t threads = 1; threads <= 4; threads++) {
+    FILE *file = tmpfile();
+    assert(file);
+
+    s_sudoku_writer w = s_sudoku_writer_create(file, SUDOKU_WRITER_CAPACITY);
+    assert(w);
+
+    batch_options options = {threads, SUDOKU_FORMAT_LINE};
+    assert(batch_solve(filenames, 5, w, options) == 0);
+    s_sudoku_writer_free(w);
+
+    char buffer[1024];
+    read_file(file, buffer, sizeof(buffer));
+
+    // test1.txt is empty so any valid solution can be found
+    assert(strncmp(buffer, expected, strlen(expected)) == 0);
+    assert(strlen(buffer) == 5 * 17);
+    assert(strncmp(buffer + 4 * 17, "1342241331244231\n", 17) == 0);
+
+    fclose(file);
+  }
+
+  // Each grid solved by a portfolio racing or sharing the search, any of
+  // its solvers may answer
+  char buffer[1024];
+  for (int conquer = 0; conquer <= 1; conquer++) {
+    FILE *file = tmpfile();
+    assert(file);
+    s_sudoku_writer w = s_sudoku_writer_create(file, SUDOKU_WRITER_CAPACITY);
+    assert(w);
+
+    batch_options options = {2, SUDOKU_FORMAT_LINE, NULL, false, 3, conquer};
+    assert(batch_solve(filenames, 5, w, options) == 0);
+    s_sudoku_writer_free(w);
+
+    // test.txt has two solutions
+    read_file(file, buffer, sizeof(buffer));
+    assert(strlen(buffer) == 5 * 17);
+    for (int k = 0; k <= 2; k += 2) {
+      assert(strncmp(buffer + k * 17, "3124243113424213\n", 17) == 0
+             || strncmp(buffer + k * 17, "3124243143121243\n", 17) == 0);
+    }
+    fclose(file);
+  }
+
+  // The numbers of solutions instead of the solutions
+  FILE *file = tmpfile();
+  assert(file);
+  s_sudoku_writer w = s_sudoku_writer_create(file, SUDOKU_WRITER_CAPACITY);
+  assert(w);
+
+  batch_options options = {2, SUDOKU_FORMAT_PRETTY, NULL, true};
+  assert(batch_solve(filenames, 5, w, options) == 0);
+  s_sudoku_writer_free(w);
+
+  char counts[64];
+  read_file(file, counts, sizeof(counts));
+  assert(strcmp(counts, "2\n12\n2\n288\n12\n") == 0);
+  fclose(file);
+
+  file = tmpfile();
+  assert(file);
+  w = s_sudoku_writer_create(file, SUDOKU_WRITER_CAPACITY);
+  assert(w);
+
+  options = (batch_options) {2, SUDOKU_FORMAT_LINE};
+
+  char *invalid[] = {"../data/test.txt", "../data/invalid_sudoku.txt"};
+  assert(batch_solve(invalid, 2, w, options) == -1);   // Invalid grid
+
+  char *missing[] = {"non-existing-file"};
+  assert(batch_solve(missing, 1, w, options) == -1);   // Invalid file
+
+  assert(batch_solve(filenames, 0, w, options) == -1); // No grid
+
+  s_sudoku_writer_free(w);
+
+  // The valid grid was still solved
+  read_file(file, buffer, sizeof(buffer));
+  assert(strcmp(buffer, "3124243113424213\n") == 0);
+
+  fclose(file);
+}
+
+void test_batch_write_result() {
+  FILE *file = tmpfile();
+  assert(file);
+
+  s_sudoku_writer w = s_sudoku_writer_create(file, SUDOKU_WRITER_CAPACITY);
+  assert(w);
+
+  char line[] = ".12....1.3.2.2..";
+  s_sudoku initial = s_sudoku_create_from_line(line, strlen(line));
+  assert(initial);
+  char solved[] = "3124243113424213";
+  s_sudoku solution = s_sudoku_create_from_line(solved, strlen(solved));
+  assert(solution);
+
+  assert(batch_write_result(w, initial, solution, 1, SUDOKU_FORMAT_LINE) == 0);
+  assert(batch_write_result(w, initial, solution, 0, SUDOKU_FORMAT_LINE) == 0);
+  assert(batch_write_result(w, initial, solution, 1, SUDOKU_FORMAT_SEMICOLON) == 0);
+  s_sudoku_writer_free(w);
+
+  char buffer[1024];
+  read_file(file, buffer, sizeof(buffer));
+  assert(strcmp(buffer, "3124243113424213\nunsolvable\n3;1;2;4\n2;4;3;1\n1;3;4;2\n4;2;1;3\n") == 0);
+
+  s_sudoku_free(initial);
+  s_sudoku_free(solution);
+  fclose(file);
+}
+
+void usage(char *exec) {
+  printf("%s testname     -> Execute the given testname\n", exec);
+  printf("%s all    -> Execute every tests\n", exec);
+}
+
+int main(int argc, char *argv[]) {
+  if (argc != 2) {
+    usage(argv[0]);
+    exit(EXIT_FAILURE);
+  }
+
+  bool execute_all = strcmp(argv[1], "all") == 0;
+
+  if (strcmp(argv[1], "test_batch_solve") == 0 || execute_all) {
+    test_batch_solve();
+  }
+  if (strcmp(argv[1], "test_batch_write_result") == 0 || execute_all) {
+    test_batch_write_result();
+  }
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,153 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+
+#include <string.h>
+#include <assert.h>
+#include <pthread.h>
+
+#include "clause_ring.h"
+
+void test_s_clause_ring_create() {
+  s_clause_ring r = s_clause_ring_create(5);
+  assert(r);
+  assert(s_clause_ring_capacity(r) == 8);   // Rounded up to a power of 2
+  assert(s_clause_ring_pushed(r) == 0);
+  s_clause_ring_free(r);
+
+  assert(!s_clause_ring_create(1));
+  assert(!s_clause_ring_create(0));
+}
+
+void test_s_clause_ring_push_read() {
+  s_clause_ring r = s_clause_ring_create(16);
+  assert(r);
+
+  int c1[] = {1, -2, 3}, c2[] = {-4}, c3[] = {5, 6, 7, 8, 9, 10};
+  int litts[16];
+  size_t cursor = 0, other = 0;
+
+  assert(s_clause_ring_read(r, &cursor, litts, 16) == 0);   // Empty
+
+  assert(s_clause_ring_push(r, c1, 3));
+  assert(s_clause_ring_push(r, c2, 1));
+  assert(!s_clause_ring_push(r, c1, 0));
+  assert(!s_clause_ring_push(r, litts, 16));   // Longer than the ring
+  assert(s_clause_ring_pushed(r) == 2);
+
+  // Each reader reads every clause, in order
+  assert(s_clause_ring_read(r, &cursor, litts, 16) == 3);
+  assert(memcmp(litts, c1, sizeof(c1)) == 0);
+  assert(s_clause_ring_read(r, &cursor, litts, 16) == 1);
+  assert(litts[0] == -4);
+  assert(s_clause_ring_read(r, &cursor, litts, 16) == 0);
+
+  // The clauses too long for a reader are skipped
+  assert(s_clause_ring_read(r, &other, litts, 2) == 1);
+  assert(litts[0] == -4);
+
+  // Across the end of the buffer
+  assert(s_clause_ring_push(r, c3, 6));
+  assert(s_clause_ring_read(r, &cursor, litts, 16) == 6);
+  assert(memcmp(litts, c3, sizeof(c3)) == 0);
+
+  // A reader which falls behind loses the clauses overwritten
+  other = 0;
+  assert(s_clause_ring_push(r, c3, 6));
+  assert(s_clause_ring_push(r, c2, 1));
+  assert(s_clause_ring_read(r, &other, litts, 16) == 0);
+  assert(s_clause_ring_read(r, &other, litts, 16) == 0);
+  assert(s_clause_ring_push(r, c1, 3));
+  assert(s_clause_ring_read(r, &other, litts, 16) == 3);
+  assert(memcmp(litts, c1, sizeof(c1)) == 0);
+
+  s_clause_ring_clear(r);
+  cursor = 0;
+  assert(s_clause_ring_pushed(r) == 0);
+  assert(s_clause_ring_read(r, &cursor, litts, 16) == 0);
+
+  s_clause_ring_free(r);
+}
+
+#define THREADED_CLAUSES 200000
+#define THREADED_READERS 3
+
+bool produced = false;
+
+void *producer(void *arg) {
+  s_clause_ring r = arg;
+  int litts[8];
+
+  // The clause k has 1 + k % 8 litterals k
+  for (int k = 1; k <= THREADED_CLAUSES; k++) {
+    for (int i = 0; i < 8; i++) litts[i] = k;
+    assert(s_clause_ring_push(r, litts, 1 + k % 8));
+  }
+  __atomic_store_n(&produced, true, __ATOMIC_RELEASE);
+  return NULL;
+}
+
+void *reader(void *arg) {
+  s_clause_ring r = arg;
+  size_t cursor = 0;
+  int litts[8], last = 0;
+
+  // Some clauses are lost but the ones read are whole and in order, until
+  // there is none left once the producer is done
+  while (true) {
+    bool done = __atomic_load_n(&produced, __ATOMIC_ACQUIRE);
+    size_t length = s_clause_ring_read(r, &cursor, litts, 8);
+    if (length == 0) {
+      if (done) break;
+      continue;
+    }
+
+    assert(litts[0] > last && length == (size_t) (1 + litts[0] % 8));
+    for (size_t i = 1; i < length; i++) assert(litts[i] == litts[0]);
+    last = litts[0];
+  }
+  return NULL;
+}
+
+void test_s_clause_ring_threads() {
+  s_clause_ring r = s_clause_ring_create(64);
+  assert(r);
+
+  pthread_t threads[THREADED_READERS + 1];
+  for (size_t k = 0; k < THREADED_READERS; k++)
+    assert(pthread_create(&threads[k], NULL, reader, r) == 0);
+  assert(pthread_create(&threads[THREADED_READERS], NULL, producer, r) == 0);
+
+  for (size_t k = 0; k <= THREADED_READERS; k++)
+    pthread_join(threads[k], NULL);
+
+  assert(s_clause_ring_pushed(r) == THREADED_CLAUSES);
+  s_clause_ring_free(r);
+}
+
+void usage(char *exec) {
+  printf("%s testname     -> Execute the given testname\n", exec);
+  printf("%s all    -> Execute every tests\n", exec);
+}
+
+int main(int argc, char *argv[]) {
+  if (argc != 2) {
+    usage(argv[0]);
+    exit(EXIT_FAILURE);
+  }
+
+  bool execute_all = strcmp(argv[1], "all") == 0;
+
+  if (strcmp(argv[1], "test_s_clause_ring_create") == 0 || execute_all) {
+    test_s_clause_ring_create();
+  }
+  if (strcmp(argv[1], "test_s_clause_ring_push_read") == 0 || execute_all) {
+    test_s_clause_ring_push_read();
+  }
+  if (strcmp(argv[1], "test_s_clause_ring_threads") == 0 || execute_all) {
+    test_s_clause_ring_threads();
+  }
+  return EXIT_SUCCESS;
+}
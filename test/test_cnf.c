@@ -38,6 +38,10 @@ void test_s_cnf_copy() {
   assert(s_cnf_clause_contains_litt(cnc, c_id, 2) == 1);
   assert(s_cnf_clause_contains_litt(cnc, c_id, -3) == 1);
 
+  // A clause added to the copy doesn't replace a copied one
+  assert(s_cnf_add_clause(cnc, litt, 1) != c_id);
+  assert(s_cnf_get_clauses_count(cnc) == 2);
+
   assert(s_cnf_copy(NULL) == NULL); // Invalid formula
 
   s_cnf_free(cnc);
@@ -230,6 +234,62 @@ void test_s_cnf_clause_get_litts() {
   s_cnf_free(cn);
 }
 
+void test_s_cnf_get_clauses_count() {
+  s_cnf cn = s_cnf_create();
+  assert(cn);
+
+  assert(s_cnf_get_clauses_count(cn) == 0);
+
+  int litt[] = {1, -2};
+  size_t c_id = s_cnf_add_clause(cn, litt, 2);
+  s_cnf_add_clause(cn, NULL, 0);
+  assert(s_cnf_get_clauses_count(cn) == 2);
+
+  s_cnf_remove_clause(cn, c_id);
+  assert(s_cnf_get_clauses_count(cn) == 1);
+
+  assert(s_cnf_get_clauses_count(NULL) == 0);   // Invalid formula
+
+  s_cnf_free(cn);
+}
+
+void test_s_cnf_get_litts_count() {
+  s_cnf cn = s_cnf_create();
+  assert(cn);
+
+  assert(s_cnf_get_litts_count(cn) == 0);
+
+  int litt1[] = {1, -2};
+  int litt2[] = {-1, 2, 3};
+  s_cnf_add_clause(cn, litt1, 2);
+  size_t c_id = s_cnf_add_clause(cn, litt2, 3);
+  assert(s_cnf_get_litts_count(cn) == 5);
+
+  s_cnf_clause_remove_litt(cn, c_id, 3);
+  assert(s_cnf_get_litts_count(cn) == 4);
+
+  assert(s_cnf_get_litts_count(NULL) == 0);     // Invalid formula
+
+  s_cnf_free(cn);
+}
+
+void test_s_cnf_get_vars_count() {
+  s_cnf cn = s_cnf_create();
+  assert(cn);
+
+  assert(s_cnf_get_vars_count(cn) == 0);
+
+  int litt1[] = {1, -7};
+  int litt2[] = {3};
+  s_cnf_add_clause(cn, litt1, 2);
+  s_cnf_add_clause(cn, litt2, 1);
+  assert(s_cnf_get_vars_count(cn) == 7);        // Negative litterals count
+
+  assert(s_cnf_get_vars_count(NULL) == 0);      // Invalid formula
+
+  s_cnf_free(cn);
+}
+
 void test_s_cnf_print() {
   s_cnf cn = s_cnf_create();
   assert(cn);
@@ -296,6 +356,15 @@ int main(int argc, char *argv[]) {
   if (strcmp(argv[1], "test_s_cnf_clause_get_litts") == 0 || execute_all) {
     test_s_cnf_clause_get_litts();
   }
+  if (strcmp(argv[1], "test_s_cnf_get_clauses_count") == 0 || execute_all) {
+    test_s_cnf_get_clauses_count();
+  }
+  if (strcmp(argv[1], "test_s_cnf_get_litts_count") == 0 || execute_all) {
+    test_s_cnf_get_litts_count();
+  }
+  if (strcmp(argv[1], "test_s_cnf_get_vars_count") == 0 || execute_all) {
+    test_s_cnf_get_vars_count();
+  }
   if (strcmp(argv[1], "test_s_cnf_print") == 0 || execute_all) {
     test_s_cnf_print();
   }
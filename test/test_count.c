@@ -0,0 +1,140 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+
+#include <string.h>
+#include <assert.h>
+
+#include "cnf.h"
+#include "count.h"
+
+/* Adds to cn the formula of the permutations of n items, the variables
+ * first + n * i + j meaning that item i goes to place j: it has n! models
+ */
+void add_permutations(s_cnf cn, int n, int first) {
+  for (int i = 0; i < n; i++) {
+    int clause[16];
+    for (int j = 0; j < n; j++) clause[j] = first + n * i + j;
+    assert(s_cnf_add_clause(cn, clause, n) >= 0);
+  }
+
+  for (int j = 0; j < n; j++) {
+    for (int i = 0; i < n; i++) {
+      for (int k = i + 1; k < n; k++) {
+        int clause[] = {-(first + n * i + j), -(first + n * k + j)};
+        assert(s_cnf_add_clause(cn, clause, 2) >= 0);
+      }
+    }
+  }
+}
+
+void test_count_models() {
+  count_number count;
+  count_stats stats;
+
+  // The empty formula has one model
+  s_cnf cn = s_cnf_create();
+  assert(cn);
+  assert(count_models(cn, &count, NULL) == 0);
+  assert(count == 1);
+
+  // x1 or x2 or x3 has 7 models, x4 is in no clause
+  int c1[] = {1, 2, 3};
+  int c2[] = {4, -4};
+  assert(s_cnf_add_clause(cn, c1, 3) >= 0);
+  assert(count_models(cn, &count, NULL) == 0);
+  assert(count == 7);
+  assert(s_cnf_add_clause(cn, c2, 2) >= 0);
+  assert(count_models(cn, &count, NULL) == 0);
+  assert(count == 14);
+
+  int c3[] = {-1};
+  assert(s_cnf_add_clause(cn, c3, 1) >= 0);
+  assert(count_models(cn, &count, NULL) == 0);
+  assert(count == 6);
+
+  // Unsatisfiable
+  int c4[] = {1};
+  assert(s_cnf_add_clause(cn, c4, 1) >= 0);
+  assert(count_models(cn, &count, NULL) == 0);
+  assert(count == 0);
+  s_cnf_free(cn);
+
+  cn = s_cnf_create();
+  assert(cn);
+  assert(s_cnf_add_clause(cn, NULL, 0) >= 0);
+  assert(count_models(cn, &count, NULL) == 0);
+  assert(count == 0);
+  s_cnf_free(cn);
+
+  // Two independent sets of permutations are counted apart and multiplied
+  cn = s_cnf_create();
+  assert(cn);
+  add_permutations(cn, 5, 1);
+  assert(count_models(cn, &count, &stats) == 0);
+  assert(count == 120);
+  assert(stats.vars == 25 && stats.cache_hits > 0);
+
+  add_permutations(cn, 6, 26);
+  assert(count_models(cn, &count, &stats) == 0);
+  assert(count == 120 * 720);
+  assert(stats.components > 0 && stats.cache_entries > 0 && stats.seconds >= 0);
+  s_cnf_free(cn);
+
+  // More than 2^64 models, and too many
+  cn = s_cnf_create();
+  assert(cn);
+  int c5[] = {100};
+  assert(s_cnf_add_clause(cn, c5, 1) >= 0);
+  assert(count_models(cn, &count, NULL) == 0);
+  assert(count == (count_number) 1 << 99);
+
+  int c6[] = {129, -129};
+  assert(s_cnf_add_clause(cn, c6, 2) >= 0);
+  assert(count_models(cn, &count, NULL) == -1);
+  s_cnf_free(cn);
+
+  assert(count_models(NULL, &count, NULL) == -1);
+}
+
+void test_count_render() {
+  char buffer[COUNT_DIGITS + 1];
+
+  assert(count_render(0, buffer, sizeof(buffer)) == 1);
+  assert(strcmp(buffer, "0") == 0);
+  assert(count_render(288, buffer, sizeof(buffer)) == 3);
+  assert(strcmp(buffer, "288") == 0);
+
+  count_number big = (count_number) 1 << 100;
+  assert(count_render(big, buffer, sizeof(buffer)) == 31);
+  assert(strcmp(buffer, "1267650600228229401496703205376") == 0);
+
+  assert(count_render(~(count_number) 0, buffer, sizeof(buffer)) == COUNT_DIGITS);
+  assert(strcmp(buffer, "340282366920938463463374607431768211455") == 0);
+
+  // No room for the null character
+  assert(count_render(288, buffer, 3) == 0);
+  assert(count_render(288, NULL, 0) == 0);
+}
+
+void usage(char *exec) {
+  printf("%s testname     -> Execute the given testname\n", exec);
+  printf("%s all    -> Execute every tests\n", exec);
+}
+
+int main(int argc, char *argv[]) {
+  if (argc != 2) {
+    usage(argv[0]);
+    exit(EXIT_FAILURE);
+  }
+
+  bool execute_all = strcmp(argv[1], "all") == 0;
+
+  if (strcmp(argv[1], "test_count_models") == 0 || execute_all) {
+    test_count_models();
+  }
+  if (strcmp(argv[1], "test_count_render") == 0 || execute_all) {
+    test_count_render();
+  }
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,167 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+
+#include <string.h>
+#include <assert.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#include "sudoku_cnf.h"
+#include "daemon.h"
+
+void test_daemon_answer() {
+  s_sudoku_solver sv = s_sudoku_solver_create();
+  assert(sv);
+
+  char answer[DAEMON_MAX_REQUEST + 1];
+
+  char grid[] = ".12....1.3.2.2..";
+  size_t length = daemon_answer(sv, grid, strlen(grid), answer);
+  assert(length == 17);
+  assert(strncmp(answer, "3124243113424213\n", length) == 0);
+
+  char unsolvable[] = "1..1............";
+  length = daemon_answer(sv, unsolvable, strlen(unsolvable), answer);
+  assert(strncmp(answer, "unsolvable\n", length) == 0);
+
+  char invalid[] = "1..1";
+  length = daemon_answer(sv, invalid, strlen(invalid), answer);
+  assert(strncmp(answer, "invalid\n", length) == 0);
+
+  s_sudoku_solver_free(sv);
+}
+
+void test_daemon_run_stream() {
+  char requests[] = ".12....1.3.2.2..\n\n1..1............\r\nabc\n.12....1.3.2.2..";
+  FILE *in = fmemopen(requests, strlen(requests), "r");
+  assert(in);
+
+  FILE *out = tmpfile();
+  assert(out);
+
+  assert(daemon_run_stream(in, out) == 0);
+
+  char buffer[1024];
+  rewind(out);
+  buffer[fread(buffer, 1, sizeof(buffer) - 1, out)] = '\0';
+  assert(strcmp(buffer, "3124243113424213\nunsolvable\ninvalid\n3124243113424213\n") == 0);
+
+  assert(daemon_run_stream(NULL, out) == -1);
+
+  fclose(in);
+  fclose(out);
+}
+
+void sleep_ms(long ms) {
+  struct timespec ts = {0, ms * 1000000};
+  nanosleep(&ts, NULL);
+}
+
+void *run_socket(void *path) {
+  long r = daemon_run_socket(path);
+  return (void *)r;
+}
+
+void test_daemon_run_socket() {
+  char path[] = "test_daemon.sock";
+
+  pthread_t thread;
+  assert(pthread_create(&thread, NULL, run_socket, path) == 0);
+
+  struct sockaddr_un addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  strcpy(addr.sun_path, path);
+
+  // Wait for the daemon to listen
+  int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  assert(fd != -1);
+  int tries = 0;
+  while (connect(fd, (struct sockaddr *)&addr, sizeof(addr)) == -1) {
+    assert(tries++ < 100);
+    sleep_ms(10);
+  }
+
+  // Requests may be split anywhere
+  char first[] = ".12....1.3.2.";
+  char second[] = "2..\n1..1............\n";
+  assert(write(fd, first, strlen(first)) == strlen(first));
+  sleep_ms(10);
+  assert(write(fd, second, strlen(second)) == strlen(second));
+  shutdown(fd, SHUT_WR);
+
+  char expected[] = "3124243113424213\nunsolvable\n";
+  char buffer[1024];
+  size_t length = 0;
+  ssize_t r;
+  while ((r = read(fd, buffer + length, sizeof(buffer) - 1 - length)) > 0)
+    length += r;
+  buffer[length] = '\0';
+  assert(strcmp(buffer, expected) == 0);
+
+  close(fd);
+
+  // A client sending requests without reading the answers is not read
+  // anymore once they pile up: its writes block
+  fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  assert(fd != -1);
+  assert(connect(fd, (struct sockaddr *)&addr, sizeof(addr)) == 0);
+  fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+
+  char requests[4096];
+  for (size_t k = 0; k < sizeof(requests); k += 2) memcpy(requests + k, "x\n", 2);
+  size_t sent = 0;
+  for (tries = 0; sent < ((size_t) 1 << 24) && tries < 100;) {
+    r = write(fd, requests, sizeof(requests));
+    if (r > 0) {
+      sent += r;
+      tries = 0;
+    } else {
+      assert(errno == EAGAIN);
+      tries++;
+      sleep_ms(10);
+    }
+  }
+  assert(sent < ((size_t) 1 << 24));
+  close(fd);
+
+  daemon_stop();
+
+  void *status;
+  pthread_join(thread, &status);
+  assert((long)status == 0);
+  assert(access(path, F_OK) == -1); // The socket was removed
+}
+
+void usage(char *exec) {
+  printf("%s testname     -> Execute the given testname\n", exec);
+  printf("%s all    -> Execute every tests\n", exec);
+}
+
+int main(int argc, char *argv[]) {
+  if (argc != 2) {
+    usage(argv[0]);
+    exit(EXIT_FAILURE);
+  }
+
+  bool execute_all = strcmp(argv[1], "all") == 0;
+
+  if (strcmp(argv[1], "test_daemon_answer") == 0 || execute_all) {
+    test_daemon_answer();
+  }
+  if (strcmp(argv[1], "test_daemon_run_stream") == 0 || execute_all) {
+    test_daemon_run_stream();
+  }
+  if (strcmp(argv[1], "test_daemon_run_socket") == 0 || execute_all) {
+    test_daemon_run_socket();
+  }
+  return EXIT_SUCCESS;
+}
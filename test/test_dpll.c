@@ -1,3 +1,5 @@
+#define _POSIX_C_SOURCE 200809L
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdbool.h>
@@ -163,6 +165,539 @@ void test_pure_litteral_assign() {
   s_cnf_free(cn);
 }
 
+void test_dpll_valuations_stats() {
+  // (x1) AND (NOT x1 OR x2) is solved by propagation only
+  s_cnf cn = s_cnf_create();
+  int unit[] = {1};
+  int implies[] = {-1, 2};
+  s_cnf_add_clause(cn, unit, 1);
+  s_cnf_add_clause(cn, implies, 2);
+
+  int *valuations = NULL;
+  size_t valuations_length = 0;
+  dpll_stats stats;
+  assert(dpll_valuations_stats(cn, &valuations, &valuations_length, &stats));
+  assert(stats.clauses == 2 && stats.litts == 3 && stats.vars == 2);
+  assert(stats.propagations == 2);
+  assert(stats.decisions == 0 && stats.conflicts == 0 && stats.backtracks == 0);
+  assert(stats.max_depth == 0);
+  assert(stats.seconds >= 0);
+
+  free(valuations);
+  s_cnf_free(cn);
+
+  // Every combination of x1 and x2 is forbidden, both branches fail
+  cn = s_cnf_create();
+  int clauses[4][2] = {{1, 2}, {-1, 2}, {1, -2}, {-1, -2}};
+  for (size_t k = 0; k < 4; k++)
+    s_cnf_add_clause(cn, clauses[k], 2);
+
+  valuations = NULL;
+  valuations_length = 0;
+  assert(!dpll_valuations_stats(cn, &valuations, &valuations_length, &stats));
+  assert(stats.clauses == 4 && stats.litts == 8 && stats.vars == 2);
+  assert(stats.decisions == 1 && stats.backtracks == 1);
+  assert(stats.conflicts == 2);
+  assert(stats.max_depth == 1);
+
+  // The statistics of several resolutions can be summed
+  dpll_stats total;
+  memset(&total, 0, sizeof(total));
+  dpll_stats_add(&total, &stats);
+  dpll_stats_add(&total, &stats);
+  assert(total.decisions == 2 && total.conflicts == 4 && total.clauses == 8);
+  assert(total.max_depth == 1);
+
+  // Statistics are optional
+  assert(!dpll_valuations_stats(cn, &valuations, &valuations_length, NULL));
+
+  free(valuations);
+  s_cnf_free(cn);
+}
+
+/* Adds to s the clauses saying that holes + 1 pigeons are each in one of
+ * holes holes, at most one per hole, which is unsatisfiable
+ */
+void add_pigeonhole(s_dpll s, int holes) {
+  int pigeons = holes + 1;
+
+  for (int p = 0; p < pigeons; p++) {
+    int clause[16];
+    for (int h = 0; h < holes; h++) clause[h] = p * holes + h + 1;
+    assert(s_dpll_add_clause(s, clause, holes) == 0);
+  }
+
+  for (int h = 0; h < holes; h++) {
+    for (int p = 0; p < pigeons; p++) {
+      for (int q = p + 1; q < pigeons; q++) {
+        int clause[] = {-(p * holes + h + 1), -(q * holes + h + 1)};
+        assert(s_dpll_add_clause(s, clause, 2) == 0);
+      }
+    }
+  }
+}
+
+void test_s_dpll_solve() {
+  s_dpll s = s_dpll_create();
+  assert(s);
+
+  // (x1 OR x2) AND (NOT x1 OR x3) AND (NOT x3) AND (x4 OR NOT x4 OR x2)
+  int c1[] = {1, 2}, c2[] = {-1, 3}, c3[] = {-3}, c4[] = {4, -4, 2};
+  assert(s_dpll_add_clause(s, c1, 2) == 0);
+  assert(s_dpll_add_clause(s, c2, 2) == 0);
+  assert(s_dpll_add_clause(s, c3, 1) == 0);
+  assert(s_dpll_add_clause(s, c4, 3) == 0);
+  assert(s_dpll_value(s, 1) == -1);          // Not solved yet
+
+  assert(s_dpll_solve(s) == 1);
+  assert(s_dpll_value(s, 1) == 0 && s_dpll_value(s, 2) == 1 && s_dpll_value(s, 3) == 0);
+  assert(s_dpll_value(s, 0) == -1 && s_dpll_value(s, 5) == -1);
+  assert(s_dpll_vars(s) == 4);
+
+  dpll_stats stats;
+  s_dpll_get_stats(s, &stats);
+  assert(stats.clauses == 4 && stats.litts == 8 && stats.vars == 4);
+  assert(stats.propagations > 0 && stats.conflicts == 0);
+
+  // Invalid litterals
+  int zero[] = {1, 0};
+  assert(s_dpll_add_clause(s, zero, 2) == -1);
+  assert(s_dpll_add_clause(NULL, c1, 2) == -1);
+
+  // The empty clause
+  assert(s_dpll_add_clause(s, NULL, 0) == 0);
+  assert(s_dpll_solve(s) == 0);
+  assert(s_dpll_value(s, 2) == -1);
+
+  // Unsatisfiable only by learning from conflicts
+  s_dpll_reset(s);
+  add_pigeonhole(s, 6);
+  assert(s_dpll_solve(s) == 0);
+  s_dpll_get_stats(s, &stats);
+  assert(stats.conflicts > 0 && stats.decisions > 0 && stats.backtracks > 0);
+  assert(stats.vars == 42);
+
+  // Same formula from a cnf
+  s_dpll_reset(s);
+  s_cnf cn = s_cnf_create();
+  s_cnf_add_clause(cn, c1, 2);
+  s_cnf_add_clause(cn, c2, 2);
+  assert(s_dpll_add_cnf(s, cn) == 0);
+  assert(s_dpll_solve(s) == 1);
+  assert(s_dpll_value(s, 1) == 0 || s_dpll_value(s, 3) == 1);
+  s_cnf_free(cn);
+
+  s_dpll_free(s);
+}
+
+void test_s_dpll_reset() {
+  s_dpll s = s_dpll_create();
+  assert(s);
+
+  add_pigeonhole(s, 5);
+  assert(s_dpll_solve(s) == 0);
+
+  // The formula is forgotten
+  s_dpll_reset(s);
+  assert(s_dpll_vars(s) == 0);
+  assert(s_dpll_solve(s) == 1);
+
+  // Loading and solving the same formula again allocates nothing
+  alloc_stats allocs;
+  alloc_set_counting(true);
+  alloc_reset_stats();
+
+  s_dpll_reset(s);
+  add_pigeonhole(s, 5);
+  assert(s_dpll_solve(s) == 0);
+
+  alloc_get_total(&allocs);
+  assert(allocs.allocations == 0);
+  alloc_set_counting(false);
+
+  s_dpll_free(s);
+}
+
+void test_s_dpll_solve_assuming() {
+  s_dpll s = s_dpll_create();
+  assert(s);
+
+  // (x1 OR x2) AND (NOT x1 OR x3)
+  int c1[] = {1, 2}, c2[] = {-1, 3};
+  assert(s_dpll_add_clause(s, c1, 2) == 0);
+  assert(s_dpll_add_clause(s, c2, 2) == 0);
+  assert(s_dpll_checkpoint(s) == 0);
+
+  int sat[] = {1};
+  assert(s_dpll_solve_assuming(s, sat, 1) == 1);
+  assert(s_dpll_value(s, 1) == 1 && s_dpll_value(s, 3) == 1);
+
+  // Unsatisfiable with the assumptions only
+  int unsat[] = {1, -3};
+  assert(s_dpll_solve_assuming(s, unsat, 2) == 0);
+  int none[] = {-1, -2};
+  assert(s_dpll_solve_assuming(s, none, 2) == 0);
+  assert(s_dpll_solve(s) == 1);
+
+  int invalid[] = {0};
+  assert(s_dpll_solve_assuming(s, invalid, 1) == -1);
+  assert(s_dpll_solve_assuming(s, NULL, 1) == -1);
+
+  // The clauses added after the checkpoint are forgotten
+  int c3[] = {-2};
+  assert(s_dpll_add_clause(s, c3, 1) == 0);
+  int c4[] = {-1};
+  assert(s_dpll_add_clause(s, c4, 1) == 0);
+  assert(s_dpll_solve(s) == 0);
+
+  assert(s_dpll_rollback(s) == 0);
+  assert(s_dpll_solve_assuming(s, none + 1, 1) == 1);
+  assert(s_dpll_value(s, 1) == 1 && s_dpll_value(s, 2) == 0);
+
+  // Learnt clauses are forgotten too and the search is the same again
+  s_dpll_reset(s);
+  add_pigeonhole(s, 5);
+  assert(s_dpll_checkpoint(s) == 0);
+  int assumption[] = {1};
+  dpll_stats first, second;
+  assert(s_dpll_solve_assuming(s, assumption, 1) == 0);
+  s_dpll_get_stats(s, &first);
+  assert(s_dpll_rollback(s) == 0);
+  assert(s_dpll_solve_assuming(s, assumption, 1) == 0);
+  s_dpll_get_stats(s, &second);
+  assert(first.conflicts == second.conflicts && first.decisions == second.decisions);
+
+  s_dpll_reset(s);
+  assert(s_dpll_rollback(s) == -1);     // No checkpoint
+
+  s_dpll_free(s);
+}
+
+void test_s_dpll_get_core() {
+  s_dpll s = s_dpll_create();
+  assert(s);
+
+  // x1 -> x2 -> x3 and x4 free
+  int c1[] = {-1, 2}, c2[] = {-2, 3};
+  assert(s_dpll_add_clause(s, c1, 2) == 0);
+  assert(s_dpll_add_clause(s, c2, 2) == 0);
+
+  size_t length = 1;
+  int assumptions[] = {4, 1, -3};
+  assert(s_dpll_solve_assuming(s, assumptions, 3) == 0);
+  const int *core = s_dpll_get_core(s, &length);
+  assert(core && length == 2);
+  assert((core[0] == -3 && core[1] == 1) || (core[0] == 1 && core[1] == -3));
+
+  // Several resolutions on the same formula
+  for (int k = 0; k < 100; k++) {
+    int assumption[] = {k % 2 ? 1 : -1, 4};
+    assert(s_dpll_solve_assuming(s, assumption, 2) == 1);
+    if (k % 2) assert(s_dpll_value(s, 3) == 1);
+    s_dpll_get_core(s, &length);
+    assert(length == 0);
+  }
+
+  // A clause added between two resolutions
+  int c3[] = {-3};
+  assert(s_dpll_add_clause(s, c3, 1) == 0);
+  assert(s_dpll_solve_assuming(s, assumptions + 1, 1) == 0);
+  core = s_dpll_get_core(s, &length);
+  assert(length == 1 && core[0] == 1);
+
+  // Unsatisfiable whatever the assumptions
+  assert(s_dpll_add_clause(s, NULL, 0) == 0);
+  assert(s_dpll_solve_assuming(s, assumptions, 3) == 0);
+  s_dpll_get_core(s, &length);
+  assert(length == 0);
+  assert(!s_dpll_get_core(s, NULL));
+
+  s_dpll_free(s);
+}
+
+void test_s_dpll_count_assuming() {
+  s_dpll s = s_dpll_create();
+  assert(s);
+
+  // x1 or x2 or x3 has 7 models
+  int c1[] = {1, 2, 3};
+  assert(s_dpll_add_clause(s, c1, 3) == 0);
+  assert(s_dpll_count_assuming(s, NULL, 0, 10) == 7);
+  assert(s_dpll_count_assuming(s, NULL, 0, 2) == 2);
+  assert(s_dpll_count_assuming(s, NULL, 0, 1) == 1);
+
+  // The formula is unchanged by the counts
+  int assumptions[] = {-1, -2};
+  assert(s_dpll_count_assuming(s, assumptions, 1, 10) == 3);
+  assert(s_dpll_count_assuming(s, assumptions, 2, 10) == 1);
+  assert(s_dpll_value(s, 3) == 1);
+  assert(s_dpll_count_assuming(s, NULL, 0, 10) == 7);
+  assert(s_dpll_solve_assuming(s, assumptions, 2) == 1);
+
+  // No model, the failed assumptions are known
+  int c2[] = {-3};
+  assert(s_dpll_add_clause(s, c2, 1) == 0);
+  size_t length = 0;
+  assert(s_dpll_count_assuming(s, assumptions, 2, 2) == 0);
+  s_dpll_get_core(s, &length);
+  assert(length == 2);
+  assert(s_dpll_value(s, 1) == -1);
+
+  assert(s_dpll_count_assuming(s, NULL, 0, 0) == -1);
+  assert(s_dpll_count_assuming(s, NULL, 1, 2) == -1);
+
+  // Unsatisfiable
+  s_dpll_reset(s);
+  add_pigeonhole(s, 5);
+  assert(s_dpll_count_assuming(s, NULL, 0, 2) == 0);
+
+  s_dpll_free(s);
+}
+
+// Models given to test_enumerate_model, as bits of the values of x1, x2, x3
+struct test_enumeration {
+  int seen[8];
+  int models, stop;
+};
+
+int test_enumerate_model(s_dpll s, void *ctx) {
+  struct test_enumeration *t = ctx;
+  int bits = 0;
+  for (int var = 1; var <= 3; var++)
+    if (s_dpll_value(s, var) == 1) bits |= 1 << (var - 1);
+  t->seen[bits]++;
+  return ++t->models == t->stop;
+}
+
+void test_s_dpll_enumerate_assuming() {
+  s_dpll s = s_dpll_create();
+  assert(s);
+
+  // x1 or x2 or x3 has 7 distinct models
+  int c1[] = {1, 2, 3};
+  assert(s_dpll_add_clause(s, c1, 3) == 0);
+  struct test_enumeration t = {{0}, 0, 0};
+  assert(s_dpll_enumerate_assuming(s, NULL, 0, test_enumerate_model, &t) == 7);
+  assert(t.models == 7 && t.seen[0] == 0);
+  for (int bits = 1; bits < 8; bits++)
+    assert(t.seen[bits] == 1);
+
+  // Stopped by the callback
+  t = (struct test_enumeration) {{0}, 0, 3};
+  assert(s_dpll_enumerate_assuming(s, NULL, 0, test_enumerate_model, &t) == 3);
+  assert(t.models == 3);
+
+  // The formula is unchanged by the enumerations
+  int assumptions[] = {-1, -2};
+  t = (struct test_enumeration) {{0}, 0, 0};
+  assert(s_dpll_enumerate_assuming(s, assumptions, 1, test_enumerate_model, &t) == 3);
+  assert(t.seen[2] == 1 && t.seen[4] == 1 && t.seen[6] == 1);
+  assert(s_dpll_count_assuming(s, NULL, 0, 10) == 7);
+  assert(s_dpll_solve_assuming(s, assumptions, 2) == 1);
+
+  // No model, the failed assumptions are known
+  int c2[] = {-3};
+  assert(s_dpll_add_clause(s, c2, 1) == 0);
+  size_t length = 0;
+  t = (struct test_enumeration) {{0}, 0, 0};
+  assert(s_dpll_enumerate_assuming(s, assumptions, 2, test_enumerate_model, &t) == 0);
+  assert(t.models == 0);
+  s_dpll_get_core(s, &length);
+  assert(length == 2);
+
+  assert(s_dpll_enumerate_assuming(s, NULL, 0, NULL, &t) == -1);
+  assert(s_dpll_enumerate_assuming(s, NULL, 1, test_enumerate_model, &t) == -1);
+
+  // Unsatisfiable
+  s_dpll_reset(s);
+  add_pigeonhole(s, 5);
+  assert(s_dpll_enumerate_assuming(s, NULL, 0, test_enumerate_model, &t) == 0);
+
+  s_dpll_free(s);
+}
+
+void test_s_dpll_lookahead() {
+  s_dpll s = s_dpll_create();
+  assert(s);
+  assert(s_dpll_lookahead(s, NULL, 0) == 0);   // No variable
+
+  // (x1 OR x2 OR x3) AND (NOT x1 OR x4) AND (NOT x1 OR x5) AND (NOT x4 OR
+  // NOT x5 OR x6): x1 implies the most variables of the shortest clause
+  int c1[] = {1, 2, 3}, c2[] = {-1, 4}, c3[] = {-1, 5}, c4[] = {-4, -5, 6};
+  assert(s_dpll_add_clause(s, c1, 3) == 0);
+  assert(s_dpll_add_clause(s, c2, 2) == 0);
+  assert(s_dpll_add_clause(s, c3, 2) == 0);
+  assert(s_dpll_add_clause(s, c4, 3) == 0);
+  int var = s_dpll_lookahead(s, NULL, 0);
+  assert(var == 1 || var == 4 || var == 5);
+
+  // Under x1 every clause is satisfied but the first one, which is too
+  int assumptions[] = {1, -6};
+  assert(s_dpll_lookahead(s, assumptions, 1) == 0);
+  assert(s_dpll_lookahead(s, assumptions, 2) == 0);   // Contradictory
+
+  // The formula is unchanged
+  assert(s_dpll_solve_assuming(s, assumptions, 2) == 0);
+  assert(s_dpll_solve_assuming(s, assumptions, 1) == 1);
+  assert(s_dpll_value(s, 6) == 1);
+
+  int zero[] = {0};
+  assert(s_dpll_lookahead(s, zero, 1) == -1);
+  assert(s_dpll_lookahead(NULL, NULL, 0) == -1);
+
+  // Every cube split by a lookahead of the pigeonhole is unsatisfiable too
+  s_dpll_reset(s);
+  add_pigeonhole(s, 5);
+  var = s_dpll_lookahead(s, NULL, 0);
+  assert(var > 0 && var <= 30);
+  int cube[] = {var};
+  assert(s_dpll_solve_assuming(s, cube, 1) == 0);
+  cube[0] = -var;
+  assert(s_dpll_solve_assuming(s, cube, 1) == 0);
+
+  s_dpll_free(s);
+}
+
+void test_s_dpll_set_options() {
+  s_dpll s = s_dpll_create();
+  assert(s);
+
+  dpll_options options, defaults;
+  dpll_default_options(&defaults);
+  s_dpll_get_options(s, &options);
+  assert(memcmp(&options, &defaults, sizeof(dpll_options)) == 0);
+  dpll_portfolio_options(0, &options);
+  assert(memcmp(&options, &defaults, sizeof(dpll_options)) == 0);
+
+  // Every configuration of a portfolio gives the same answers
+  int c1[] = {1, 2}, c2[] = {-1, 3}, c3[] = {-3};
+  for (size_t k = 0; k < 10; k++) {
+    dpll_portfolio_options(k, &options);
+    assert(s_dpll_set_options(s, &options) == 0);
+
+    s_dpll_reset(s);
+    add_pigeonhole(s, 6);
+    assert(s_dpll_solve(s) == 0);
+
+    s_dpll_reset(s);
+    assert(s_dpll_add_clause(s, c1, 2) == 0);
+    assert(s_dpll_add_clause(s, c2, 2) == 0);
+    assert(s_dpll_add_clause(s, c3, 1) == 0);
+    assert(s_dpll_solve(s) == 1);
+    assert(s_dpll_value(s, 1) == 0 && s_dpll_value(s, 2) == 1 && s_dpll_value(s, 3) == 0);
+  }
+
+  // Invalid options are refused and leave the solver unchanged
+  dpll_portfolio_options(3, &defaults);
+  assert(s_dpll_set_options(s, &defaults) == 0);
+  options = defaults;
+  options.phase = 2;
+  assert(s_dpll_set_options(s, &options) == -1);
+  options = defaults;
+  options.var_decay = 1;
+  assert(s_dpll_set_options(s, &options) == -1);
+  options = defaults;
+  options.random_decisions = -0.5;
+  assert(s_dpll_set_options(s, &options) == -1);
+  options = defaults;
+  options.restarts = DPLL_RESTARTS_GEOMETRIC;
+  options.restart_base = 0;
+  assert(s_dpll_set_options(s, &options) == -1);
+  assert(s_dpll_set_options(NULL, &defaults) == -1);
+  assert(s_dpll_set_options(s, NULL) == -1);
+  s_dpll_get_options(s, &options);
+  assert(memcmp(&options, &defaults, sizeof(dpll_options)) == 0);
+
+  // A cancelled resolution fails at its first conflict, the formula is kept
+  int cancel = 1;
+  options.cancel = &cancel;
+  assert(s_dpll_set_options(s, &options) == 0);
+  s_dpll_reset(s);
+  add_pigeonhole(s, 6);
+  assert(s_dpll_solve(s) == -1);
+  cancel = 0;
+  assert(s_dpll_solve(s) == 0);
+
+  // A conflict at level 0 is not cancelled, the next resolutions agree
+  int r1[] = {-1, 2}, r2[] = {-2, 3}, r3[] = {-3, -2}, r4[] = {1};
+  cancel = 1;
+  s_dpll_reset(s);
+  assert(s_dpll_add_clause(s, r1, 2) == 0);
+  assert(s_dpll_add_clause(s, r2, 2) == 0);
+  assert(s_dpll_add_clause(s, r3, 2) == 0);
+  assert(s_dpll_add_clause(s, r4, 1) == 0);
+  assert(s_dpll_solve(s) == 0);
+  cancel = 0;
+  assert(s_dpll_solve(s) == 0);
+
+  s_dpll_free(s);
+}
+
+// Clauses given to and by the sharing callbacks of test_s_dpll_share_clauses
+typedef struct shared_clauses {
+  size_t exported;
+  size_t next;                  // Next clause of clauses to import
+  const int *clauses[4];
+  size_t lengths[4];
+} shared_clauses;
+
+void export_clause(const int *litts, size_t length, size_t lbd, void *ctx) {
+  shared_clauses *shared = ctx;
+  assert(length > 0 && lbd > 0 && lbd <= length);
+  for (size_t k = 0; k < length; k++) assert(litts[k] != 0);
+  shared->exported++;
+}
+
+size_t import_clause(int *litts, size_t capacity, void *ctx) {
+  shared_clauses *shared = ctx;
+  if (shared->next == 4) return 0;
+
+  size_t length = shared->lengths[shared->next];
+  assert(length <= capacity);
+  memcpy(litts, shared->clauses[shared->next++], sizeof(int) * length);
+  return length;
+}
+
+void test_s_dpll_share_clauses() {
+  s_dpll s = s_dpll_create();
+  assert(s);
+  shared_clauses shared = {0};
+  dpll_options options;
+  dpll_stats stats;
+
+  s_dpll_get_options(s, &options);
+  options.export_clause = export_clause;
+  options.import_clause = import_clause;
+  options.sharing = &shared;
+  assert(s_dpll_set_options(s, &options) == 0);
+
+  // Every clause learnt is exported
+  add_pigeonhole(s, 5);
+  shared.next = 4;
+  assert(s_dpll_solve(s) == 0);
+  s_dpll_get_stats(s, &stats);
+  assert(shared.exported > 0 && stats.exported == shared.exported);
+  assert(stats.imported == 0);
+
+  // (x1 OR x2) AND (x1 OR NOT x2) AND (x2 OR x3), the clauses imported are
+  // kept unless they are satisfied or have unknown variables
+  s_dpll_reset(s);
+  int c1[] = {1, 2}, c2[] = {1, -2}, c3[] = {2, 3};
+  assert(s_dpll_add_clause(s, c1, 2) == 0);
+  assert(s_dpll_add_clause(s, c2, 2) == 0);
+  assert(s_dpll_add_clause(s, c3, 2) == 0);
+
+  int i1[] = {1}, i2[] = {-2, 4}, i3[] = {-1, 2, 3}, i4[] = {1, 3};
+  shared = (shared_clauses) {0, 0, {i1, i2, i3, i4}, {1, 2, 3, 2}};
+  assert(s_dpll_solve(s) == 1);
+  s_dpll_get_stats(s, &stats);
+  assert(stats.imported == 2 && shared.next == 4);
+  assert(s_dpll_value(s, 1) == 1);
+  assert(s_dpll_value(s, 2) == 1 || s_dpll_value(s, 3) == 1);
+
+  s_dpll_free(s);
+}
+
 void usage(char *exec) {
   printf("%s testname     -> Execute the given testname\n", exec);
   printf("%s all    -> Execute every tests\n", exec);
@@ -197,6 +732,36 @@ int main(int argc, char *argv[]) {
   if (strcmp(argv[1], "test_pure_litteral_assign") == 0 || execute_all) {
     test_pure_litteral_assign();
   }
+  if (strcmp(argv[1], "test_dpll_valuations_stats") == 0 || execute_all) {
+    test_dpll_valuations_stats();
+  }
+  if (strcmp(argv[1], "test_s_dpll_solve") == 0 || execute_all) {
+    test_s_dpll_solve();
+  }
+  if (strcmp(argv[1], "test_s_dpll_reset") == 0 || execute_all) {
+    test_s_dpll_reset();
+  }
+  if (strcmp(argv[1], "test_s_dpll_solve_assuming") == 0 || execute_all) {
+    test_s_dpll_solve_assuming();
+  }
+  if (strcmp(argv[1], "test_s_dpll_get_core") == 0 || execute_all) {
+    test_s_dpll_get_core();
+  }
+  if (strcmp(argv[1], "test_s_dpll_count_assuming") == 0 || execute_all) {
+    test_s_dpll_count_assuming();
+  }
+  if (strcmp(argv[1], "test_s_dpll_enumerate_assuming") == 0 || execute_all) {
+    test_s_dpll_enumerate_assuming();
+  }
+  if (strcmp(argv[1], "test_s_dpll_lookahead") == 0 || execute_all) {
+    test_s_dpll_lookahead();
+  }
+  if (strcmp(argv[1], "test_s_dpll_set_options") == 0 || execute_all) {
+    test_s_dpll_set_options();
+  }
+  if (strcmp(argv[1], "test_s_dpll_share_clauses") == 0 || execute_all) {
+    test_s_dpll_share_clauses();
+  }
 
   return EXIT_SUCCESS;
 }
@@ -0,0 +1,133 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+
+#include <string.h>
+#include <assert.h>
+
+#include "sudoku.h"
+#include "sudoku_writer.h"
+#include "pipeline.h"
+
+/* Reads the whole content of file in buffer and returns its length
+ */
+size_t read_file(FILE *file, char *buffer, size_t size) {
+  rewind(file);
+  size_t length = fread(buffer, 1, size - 1, file);
+  buffer[length] = '\0';
+  return length;
+}
+
+void test_pipeline_solve() {
+  char *filenames[] = {"../data/test.txt", "../data/test2.txt", "../data/test.txt",
+                       "../data/test1.txt", "../data/test2.txt"};
+  char expected[] =
+    "3124243113424213\n"
+    "1342241331244231\n"
+    "3124243113424213\n";
+
+  // The output is in the input order whatever the capacity of the queues
+  for (size_t capacity = 1; capacity <= 4; capacity++) {
+    FILE *file = tmpfile();
+    assert(file);
+
+    s_sudoku_writer w = s_sudoku_writer_create(file, SUDOKU_WRITER_CAPACITY);
+    assert(w);
+
+    pipeline_options options = {capacity, SUDOKU_FORMAT_LINE};
+    pipeline_stats stats;
+    assert(pipeline_solve(filenames, 5, w, options, &stats) == 0);
+    s_sudoku_writer_free(w);
+
+    for (size_t k = 0; k < PIPELINE_STAGES; k++)
+      assert(stats.stages[k].items == 5);
+    for (size_t k = 0; k < PIPELINE_STAGES - 1; k++)
+      assert(stats.queues[k].max_depth <= stats.queues[k].capacity);
+
+    char buffer[1024];
+    read_file(file, buffer, sizeof(buffer));
+
+    // test1.txt is empty so any valid solution can be found
+    assert(strncmp(buffer, expected, strlen(expected)) == 0);
+    assert(strlen(buffer) == 5 * 17);
+    assert(strncmp(buffer + 4 * 17, "1342241331244231\n", 17) == 0);
+
+    fclose(file);
+  }
+
+  FILE *file = tmpfile();
+  assert(file);
+  s_sudoku_writer w = s_sudoku_writer_create(file, SUDOKU_WRITER_CAPACITY);
+  assert(w);
+
+  pipeline_options options = {PIPELINE_QUEUE_CAPACITY, SUDOKU_FORMAT_LINE};
+
+  char *invalid[] = {"../data/test.txt", "../data/invalid_sudoku.txt"};
+  assert(pipeline_solve(invalid, 2, w, options, NULL) == -1);   // Invalid grid
+
+  char *missing[] = {"non-existing-file"};
+  assert(pipeline_solve(missing, 1, w, options, NULL) == -1);   // Invalid file
+
+  assert(pipeline_solve(filenames, 0, w, options, NULL) == -1); // No grid
+
+  options.queue_capacity = 0;
+  assert(pipeline_solve(filenames, 1, w, options, NULL) == -1); // No room
+
+  s_sudoku_writer_free(w);
+
+  // The valid grid was still solved
+  char buffer[1024];
+  read_file(file, buffer, sizeof(buffer));
+  assert(strcmp(buffer, "3124243113424213\n") == 0);
+
+  fclose(file);
+}
+
+void test_pipeline_stats_print() {
+  FILE *file = tmpfile();
+  assert(file);
+  s_sudoku_writer w = s_sudoku_writer_create(file, SUDOKU_WRITER_CAPACITY);
+  assert(w);
+
+  char *filenames[] = {"../data/test.txt"};
+  pipeline_options options = {PIPELINE_QUEUE_CAPACITY, SUDOKU_FORMAT_PRETTY};
+  pipeline_stats stats;
+  assert(pipeline_solve(filenames, 1, w, options, &stats) == 0);
+  s_sudoku_writer_free(w);
+  fclose(file);
+
+  file = tmpfile();
+  assert(file);
+  pipeline_stats_print(file, &stats);
+
+  char buffer[2048];
+  size_t length = read_file(file, buffer, sizeof(buffer));
+  assert(length > 0 && buffer[0] == '{' && buffer[length - 1] == '\n');
+  assert(strstr(buffer, "\"name\": \"parse\", \"items\": 1,"));
+  assert(strstr(buffer, "\"name\": \"emit\", \"items\": 1,"));
+  assert(strstr(buffer, "\"from\": \"solve\", \"to\": \"emit\", \"capacity\": 256,"));
+
+  fclose(file);
+}
+
+void usage(char *exec) {
+  printf("%s testname     -> Execute the given testname\n", exec);
+  printf("%s all    -> Execute every tests\n", exec);
+}
+
+int main(int argc, char *argv[]) {
+  if (argc != 2) {
+    usage(argv[0]);
+    exit(EXIT_FAILURE);
+  }
+
+  bool execute_all = strcmp(argv[1], "all") == 0;
+
+  if (strcmp(argv[1], "test_pipeline_solve") == 0 || execute_all) {
+    test_pipeline_solve();
+  }
+  if (strcmp(argv[1], "test_pipeline_stats_print") == 0 || execute_all) {
+    test_pipeline_stats_print();
+  }
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,248 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+
+#include <string.h>
+#include <assert.h>
+
+#include "cnf.h"
+#include "dpll.h"
+#include "portfolio.h"
+
+/* Adds to p the clauses saying that holes + 1 pigeons are each in one of
+ * holes holes, at most one per hole, which is unsatisfiable
+ */
+void add_pigeonhole(s_portfolio p, int holes) {
+  int pigeons = holes + 1;
+
+  for (int i = 0; i < pigeons; i++) {
+    int clause[16];
+    for (int h = 0; h < holes; h++) clause[h] = i * holes + h + 1;
+    assert(s_portfolio_add_clause(p, clause, holes) == 0);
+  }
+
+  for (int h = 0; h < holes; h++) {
+    for (int i = 0; i < pigeons; i++) {
+      for (int j = i + 1; j < pigeons; j++) {
+        int clause[] = {-(i * holes + h + 1), -(j * holes + h + 1)};
+        assert(s_portfolio_add_clause(p, clause, 2) == 0);
+      }
+    }
+  }
+}
+
+void test_s_portfolio_create() {
+  assert(s_portfolio_create(0) == NULL);
+
+  s_portfolio p = s_portfolio_create(4);
+  assert(p);
+  assert(s_portfolio_size(p) == 4);
+  assert(s_portfolio_winner(p) == NULL);
+  assert(s_portfolio_solver(p, 4) == NULL);
+
+  // Each solver has its own configuration
+  dpll_options first, options;
+  s_dpll_get_options(s_portfolio_solver(p, 0), &first);
+  for (size_t k = 1; k < 4; k++) {
+    s_dpll_get_options(s_portfolio_solver(p, k), &options);
+    assert(options.seed != first.seed && options.cancel == first.cancel);
+  }
+
+  s_portfolio_free(p);
+}
+
+void test_s_portfolio_solve_assuming() {
+  s_portfolio p = s_portfolio_create(3);
+  assert(p);
+
+  // (x1 OR x2) AND (NOT x1 OR x3), the model comes from the winner
+  s_cnf cn = s_cnf_create();
+  assert(cn);
+  int c1[] = {1, 2}, c2[] = {-1, 3};
+  s_cnf_add_clause(cn, c1, 2);
+  s_cnf_add_clause(cn, c2, 2);
+  assert(s_portfolio_add_cnf(p, cn) == 0);
+  s_cnf_free(cn);
+
+  int assumptions[] = {-3};
+  assert(s_portfolio_solve_assuming(p, assumptions, 1) == 1);
+  s_dpll winner = s_portfolio_winner(p);
+  assert(winner);
+  assert(s_dpll_value(winner, 1) == 0 && s_dpll_value(winner, 2) == 1);
+  assert(s_dpll_value(winner, 3) == 0);
+
+  int contradiction[] = {-3, 1};
+  assert(s_portfolio_solve_assuming(p, contradiction, 2) == 0);
+  assert(s_portfolio_winner(p));
+
+  // Unsatisfiable only by learning from conflicts, and every solver can
+  // still be used on its own after the race
+  add_pigeonhole(p, 7);
+  assert(s_portfolio_solve_assuming(p, NULL, 0) == 0);
+  for (size_t k = 0; k < s_portfolio_size(p); k++)
+    assert(s_dpll_solve(s_portfolio_solver(p, k)) == 0);
+
+  assert(s_portfolio_solve_assuming(p, NULL, 1) == -1);
+  assert(s_portfolio_solve_assuming(NULL, NULL, 0) == -1);
+
+  s_portfolio_free(p);
+}
+
+void test_s_portfolio_conquer_assuming() {
+  s_portfolio p = s_portfolio_create(3);
+  assert(p);
+  portfolio_stats stats;
+
+  // 6 pigeons in 6 holes, each hole gets a pigeon in the model found
+  for (int i = 0; i < 6; i++) {
+    int clause[6];
+    for (int h = 0; h < 6; h++) clause[h] = i * 6 + h + 1;
+    assert(s_portfolio_add_clause(p, clause, 6) == 0);
+  }
+  for (int h = 0; h < 6; h++) {
+    for (int i = 0; i < 6; i++) {
+      for (int j = i + 1; j < 6; j++) {
+        int clause[] = {-(i * 6 + h + 1), -(j * 6 + h + 1)};
+        assert(s_portfolio_add_clause(p, clause, 2) == 0);
+      }
+    }
+  }
+
+  int assumptions[] = {1, 8};
+  assert(s_portfolio_conquer_assuming(p, assumptions, 2) == 1);
+  s_dpll winner = s_portfolio_winner(p);
+  assert(winner);
+  assert(s_dpll_value(winner, 1) == 1 && s_dpll_value(winner, 8) == 1);
+  for (int h = 0; h < 6; h++) {
+    int pigeons = 0;
+    for (int i = 0; i < 6; i++) pigeons += s_dpll_value(winner, i * 6 + h + 1);
+    assert(pigeons == 1);
+  }
+  s_portfolio_get_stats(p, &stats);
+  assert(stats.cubes > 0);
+
+  int contradiction[] = {1, 7};
+  assert(s_portfolio_conquer_assuming(p, contradiction, 2) == 0);
+
+  // Unsatisfiable: every cube is refuted
+  s_portfolio_free(p);
+  p = s_portfolio_create(3);
+  assert(p);
+  add_pigeonhole(p, 7);
+  assert(s_portfolio_conquer_assuming(p, NULL, 0) == 0);
+  s_portfolio_get_stats(p, &stats);
+  assert(stats.cubes >= 3 * PORTFOLIO_CUBES_PER_SOLVER / 2);
+  assert(s_portfolio_winner(p));
+
+  // A race has no cube
+  assert(s_portfolio_solve_assuming(p, NULL, 0) == 0);
+  s_portfolio_get_stats(p, &stats);
+  assert(stats.cubes == 0 && stats.steals == 0);
+
+  assert(s_portfolio_conquer_assuming(p, NULL, 1) == -1);
+  assert(s_portfolio_conquer_assuming(NULL, NULL, 0) == -1);
+
+  s_portfolio_free(p);
+
+  // Small random formulas raced then conquered on the same portfolio, whose
+  // solvers were cancelled by the race: both answers match the one of a
+  // brute force search, and the model of the conquest is one
+  srand(42);
+  for (int round = 0; round < 500; round++) {
+    p = s_portfolio_create(3);
+    assert(p);
+    int vars = 4 + rand() % 9;
+    int clauses[64][3], lengths[64];
+    int length = vars * 4 + rand() % vars;
+    for (int k = 0; k < length; k++) {
+      lengths[k] = 2 + rand() % 2;
+      for (int l = 0; l < 3; l++) clauses[k][l] = (1 + rand() % vars) * (rand() % 2 ? 1 : -1);
+      assert(s_portfolio_add_clause(p, clauses[k], lengths[k]) == 0);
+    }
+
+    int expected = 0;
+    for (int values = 0; values < 1 << vars && !expected; values++) {
+      bool satisfied = true;
+      for (int k = 0; k < length && satisfied; k++) {
+        satisfied = false;
+        for (int l = 0; l < lengths[k]; l++)
+          satisfied |= ((values >> (abs(clauses[k][l]) - 1)) & 1) == (clauses[k][l] > 0);
+      }
+      expected = satisfied;
+    }
+
+    assert(s_portfolio_solve_assuming(p, NULL, 0) == expected);
+    assert(s_portfolio_conquer_assuming(p, NULL, 0) == expected);
+    winner = s_portfolio_winner(p);
+    for (int k = 0; k < length && expected; k++) {
+      bool satisfied = false;
+      for (int l = 0; l < lengths[k]; l++)
+        satisfied |= s_dpll_value(winner, abs(clauses[k][l])) == (clauses[k][l] > 0);
+      assert(satisfied);
+    }
+
+    s_portfolio_free(p);
+  }
+}
+
+void test_s_portfolio_set_sharing() {
+  portfolio_stats stats;
+  dpll_stats solver;
+  dpll_options options;
+
+  // The solvers give each other short clauses, racing or sharing the cubes,
+  // and the callbacks are removed after the resolution
+  for (int conquer = 0; conquer < 2; conquer++) {
+    s_portfolio p = s_portfolio_create(3);
+    assert(p);
+    add_pigeonhole(p, 7);
+    if (conquer) assert(s_portfolio_conquer_assuming(p, NULL, 0) == 0);
+    else assert(s_portfolio_solve_assuming(p, NULL, 0) == 0);
+
+    s_portfolio_get_stats(p, &stats);
+    assert(stats.shared > 0);
+    s_dpll_get_options(s_portfolio_solver(p, 1), &options);
+    assert(!options.export_clause && !options.import_clause);
+    s_portfolio_free(p);
+  }
+
+  s_portfolio p = s_portfolio_create(3);
+  assert(p);
+  add_pigeonhole(p, 7);
+  s_portfolio_set_sharing(p, false);
+  assert(s_portfolio_solve_assuming(p, NULL, 0) == 0);
+  s_portfolio_get_stats(p, &stats);
+  s_dpll_get_stats(s_portfolio_winner(p), &solver);
+  assert(stats.shared == 0 && stats.imported == 0);
+  assert(solver.exported == 0 && solver.imported == 0);
+
+  s_portfolio_free(p);
+}
+
+void usage(char *exec) {
+  printf("%s testname     -> Execute the given testname\n", exec);
+  printf("%s all    -> Execute every tests\n", exec);
+}
+
+int main(int argc, char *argv[]) {
+  if (argc != 2) {
+    usage(argv[0]);
+    exit(EXIT_FAILURE);
+  }
+
+  bool execute_all = strcmp(argv[1], "all") == 0;
+
+  if (strcmp(argv[1], "test_s_portfolio_create") == 0 || execute_all) {
+    test_s_portfolio_create();
+  }
+  if (strcmp(argv[1], "test_s_portfolio_solve_assuming") == 0 || execute_all) {
+    test_s_portfolio_solve_assuming();
+  }
+  if (strcmp(argv[1], "test_s_portfolio_conquer_assuming") == 0 || execute_all) {
+    test_s_portfolio_conquer_assuming();
+  }
+  if (strcmp(argv[1], "test_s_portfolio_set_sharing") == 0 || execute_all) {
+    test_s_portfolio_set_sharing();
+  }
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,265 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+
+#include <string.h>
+#include <assert.h>
+
+#include "cnf.h"
+#include "dpll.h"
+#include "preprocess.h"
+
+// Returns whether the litterals of model satisfy every clause of cn
+bool satisfies(s_cnf cn, const int *model) {
+  size_t clauses_length = 0;
+  size_t *clauses = s_cnf_get_clauses_ids(cn, &clauses_length);
+  bool satisfied = true;
+
+  for (size_t k = 0; k < clauses_length && satisfied; k++) {
+    size_t length = 0;
+    int *litts = s_cnf_clause_get_litts(cn, clauses[k], &length);
+    satisfied = false;
+    for (size_t l = 0; l < length; l++) satisfied |= model[abs(litts[l]) - 1] == litts[l];
+    free(litts);
+  }
+
+  free(clauses);
+  return satisfied;
+}
+
+/* Solves cn and stores its model in the vars litterals of model when it is
+ * satisfiable
+ */
+int solve(s_cnf cn, int *model, size_t vars) {
+  s_dpll s = s_dpll_create();
+  assert(s);
+  assert(s_dpll_add_cnf(s, cn) == 0);
+
+  int solved = s_dpll_solve(s);
+  for (size_t var = 1; var <= vars && solved == 1; var++)
+    model[var - 1] = s_dpll_value(s, var) == 1 ? (int) var : -(int) var;
+
+  s_dpll_free(s);
+  return solved;
+}
+
+// Solves cn with litt assumed
+int solve_assuming(s_cnf cn, int litt) {
+  s_dpll s = s_dpll_create();
+  assert(s);
+  assert(s_dpll_add_cnf(s, cn) == 0);
+
+  int solved = s_dpll_solve_assuming(s, &litt, 1);
+  s_dpll_free(s);
+  return solved;
+}
+
+/* Returns the preprocessing of the clauses of length 3 in clauses (0 for
+ * the missing litterals) with the variables frozen
+ */
+s_preprocess preprocess(int clauses[][3], size_t length, const int *frozen, size_t frozen_length) {
+  s_cnf cn = s_cnf_create();
+  assert(cn);
+  for (size_t k = 0; k < length; k++) {
+    size_t n = 0;
+    while (n < 3 && clauses[k][n] != 0) n++;
+    assert(s_cnf_add_clause(cn, clauses[k], n) >= 0);
+  }
+
+  s_preprocess pp = s_preprocess_create(cn, frozen, frozen_length);
+  assert(pp);
+  s_cnf_free(cn);
+  return pp;
+}
+
+void test_s_preprocess_create() {
+  preprocess_stats stats;
+  int frozen[] = {1, 2, 3, 4, 5, 6};
+
+  // The units are propagated, then the clauses left are removed by the
+  // elimination of their variables unless they are frozen
+  int units[][3] = {{1}, {-1, 2}, {-2, 3, 4}, {5, 6}, {-1, -2, 5}};
+  s_preprocess pp = preprocess(units, 5, NULL, 0);
+  s_preprocess_get_stats(pp, &stats);
+  assert(s_cnf_get_clauses_count(s_preprocess_cnf(pp)) == 0);
+  assert(stats.fixed == 3 && stats.eliminated == 1);
+  assert(stats.vars == 6 && stats.clauses == 5 && stats.litts == 11);
+  assert(stats.removed_clauses == 5 && stats.removed_litts == 11);
+  assert(s_preprocess_vars(pp) == 6);
+  s_preprocess_free(pp);
+
+  pp = preprocess(units, 5, frozen + 2, 4);
+  s_preprocess_get_stats(pp, &stats);
+  assert(s_cnf_get_clauses_count(s_preprocess_cnf(pp)) == 2);
+  assert(stats.fixed == 3 && stats.eliminated == 0 && stats.removed_clauses == 3);
+  s_preprocess_free(pp);
+
+  // Subsumption and self-subsuming resolution
+  int subsumed[][3] = {{1, 2}, {1, 2, 3}, {-1, 2, 4}};
+  pp = preprocess(subsumed, 3, frozen, 4);
+  s_preprocess_get_stats(pp, &stats);
+  assert(stats.subsumed == 1 && stats.strengthened == 1);
+  assert(s_cnf_get_litts_count(s_preprocess_cnf(pp)) == 4);
+  assert(stats.removed_clauses == 1 && stats.removed_litts == 4);
+  s_preprocess_free(pp);
+
+  // x1 is replaced by the resolvent of its clauses
+  int eliminated[][3] = {{1, 2}, {-1, 3}, {-1, 4}};
+  pp = preprocess(eliminated, 3, frozen + 1, 3);
+  s_preprocess_get_stats(pp, &stats);
+  assert(stats.eliminated == 1 && stats.resolvents == 2);
+  assert(s_cnf_get_clauses_count(s_preprocess_cnf(pp)) == 2);
+  s_preprocess_free(pp);
+
+  // The frozen variables fixed stay as units
+  pp = preprocess(units, 2, frozen + 1, 1);
+  assert(s_cnf_get_clauses_count(s_preprocess_cnf(pp)) == 1);
+  assert(s_cnf_get_litts_count(s_preprocess_cnf(pp)) == 1);
+  s_preprocess_free(pp);
+
+  // Unsatisfiable, the formula is the empty clause
+  int unsat[][3] = {{1, 2}, {-1, 2}, {1, -2}, {-1, -2}};
+  pp = preprocess(unsat, 4, NULL, 0);
+  assert(s_cnf_get_clauses_count(s_preprocess_cnf(pp)) == 1);
+  assert(s_cnf_get_litts_count(s_preprocess_cnf(pp)) == 0);
+  s_preprocess_free(pp);
+
+  assert(s_preprocess_create(NULL, NULL, 0) == NULL);
+  s_cnf cn = s_cnf_create();
+  assert(cn);
+  assert(s_preprocess_create(cn, NULL, 1) == NULL);
+  s_cnf_free(cn);
+}
+
+void test_s_preprocess_create_from_clauses() {
+  preprocess_stats stats;
+
+  // Same formula as the units of test_s_preprocess_create, the unit is
+  // given last
+  int litts[] = {-1, 2, 0, -2, 3, 4, 0, 5, 6, 0, -1, -2, 5, 0, 1, 0};
+  int frozen[] = {3, 4, 5, 6};
+  s_preprocess pp = s_preprocess_create_from_clauses(litts, 16, frozen, 4);
+  assert(pp);
+  s_preprocess_get_stats(pp, &stats);
+  assert(stats.fixed == 3 && stats.eliminated == 0);
+  assert(stats.vars == 6 && stats.clauses == 5 && stats.litts == 11);
+  assert(s_preprocess_vars(pp) == 6);
+
+  size_t length = 0;
+  const int *clauses = s_preprocess_clauses(pp, &length);
+  int expected[] = {5, 0, 3, 4, 0};
+  assert(length == 5 && memcmp(clauses, expected, sizeof(expected)) == 0);
+  assert(s_cnf_get_clauses_count(s_preprocess_cnf(pp)) == 2);
+  s_preprocess_free(pp);
+
+  // Unsatisfiable, the formula is the empty clause
+  int unsat[] = {1, 0, -1, 2, 0, -2, 0};
+  pp = s_preprocess_create_from_clauses(unsat, 7, NULL, 0);
+  assert(pp);
+  clauses = s_preprocess_clauses(pp, &length);
+  assert(length == 1 && clauses[0] == 0);
+  s_preprocess_free(pp);
+
+  pp = s_preprocess_create_from_clauses(NULL, 0, NULL, 0);
+  assert(pp);
+  assert(s_preprocess_clauses(pp, &length) && length == 0);
+  assert(s_preprocess_clauses(pp, NULL) == NULL);
+  s_preprocess_free(pp);
+
+  assert(s_preprocess_create_from_clauses(litts, 15, NULL, 0) == NULL);
+  assert(s_preprocess_create_from_clauses(NULL, 1, NULL, 0) == NULL);
+  assert(s_preprocess_create_from_clauses(litts, 16, NULL, 1) == NULL);
+}
+
+void test_s_preprocess_extend() {
+  // Random formulas around the threshold of 3-SAT, the simplified formula
+  // has the same answer and each of its models extends to the original one
+  srand(42);
+  int model[64];
+  size_t satisfiable = 0, eliminated = 0;
+
+  for (int round = 0; round < 300; round++) {
+    int vars = 5 + rand() % 40;
+    int clauses = vars * (3 + rand() % 3) + rand() % vars;
+
+    s_cnf cn = s_cnf_create();
+    assert(cn);
+    for (int k = 0; k < clauses; k++) {
+      int clause[3];
+      int length = k % 10 == 0 ? 2 : 3;
+      for (int l = 0; l < length; l++)
+        clause[l] = (1 + rand() % vars) * (rand() % 2 ? 1 : -1);
+      assert(s_cnf_add_clause(cn, clause, length) >= 0);
+    }
+
+    int frozen[] = {1 + rand() % vars};
+    size_t frozen_length = rand() % 2;
+    s_preprocess pp = s_preprocess_create(cn, frozen, frozen_length);
+    assert(pp);
+    preprocess_stats stats;
+    s_preprocess_get_stats(pp, &stats);
+    eliminated += stats.eliminated;
+
+    size_t n = s_preprocess_vars(pp);
+    int solved = solve(cn, model, n);
+    assert(solve(s_preprocess_cnf(pp), model, n) == solved);
+
+    if (solved == 1) {
+      s_preprocess_extend(pp, model);
+      assert(satisfies(cn, model));
+      satisfiable++;
+    }
+
+    // Same answers when a frozen variable is assumed
+    for (int sign = -1; sign <= 1 && frozen_length > 0; sign += 2) {
+      int assumption = sign * frozen[0];
+      assert(solve_assuming(cn, assumption) == solve_assuming(s_preprocess_cnf(pp), assumption));
+    }
+
+    s_preprocess_free(pp);
+    s_cnf_free(cn);
+  }
+
+  assert(satisfiable > 30 && satisfiable < 270 && eliminated > 0);
+}
+
+void test_preprocess_stats_add() {
+  preprocess_stats total, stats;
+  memset(&total, 0, sizeof(total));
+  memset(&stats, 0, sizeof(stats));
+
+  stats.eliminated = 2;
+  stats.removed_clauses = 5;
+  stats.seconds = 0.5;
+  preprocess_stats_add(&total, &stats);
+  preprocess_stats_add(&total, &stats);
+  assert(total.eliminated == 4 && total.removed_clauses == 10 && total.seconds == 1);
+}
+
+void usage(char *exec) {
+  printf("%s testname     -> Execute the given testname\n", exec);
+  printf("%s all    -> Execute every tests\n", exec);
+}
+
+int main(int argc, char *argv[]) {
+  if (argc != 2) {
+    usage(argv[0]);
+    exit(EXIT_FAILURE);
+  }
+
+  bool execute_all = strcmp(argv[1], "all") == 0;
+
+  if (strcmp(argv[1], "test_s_preprocess_create") == 0 || execute_all) {
+    test_s_preprocess_create();
+  }
+  if (strcmp(argv[1], "test_s_preprocess_create_from_clauses") == 0 || execute_all) {
+    test_s_preprocess_create_from_clauses();
+  }
+  if (strcmp(argv[1], "test_s_preprocess_extend") == 0 || execute_all) {
+    test_s_preprocess_extend();
+  }
+  if (strcmp(argv[1], "test_preprocess_stats_add") == 0 || execute_all) {
+    test_preprocess_stats_add();
+  }
+  return EXIT_SUCCESS;
+}
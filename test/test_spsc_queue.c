@@ -0,0 +1,109 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+
+#include <string.h>
+#include <stdint.h>
+#include <assert.h>
+#include <pthread.h>
+
+#include "spsc_queue.h"
+
+void test_s_spsc_queue_create() {
+  s_spsc_queue q = s_spsc_queue_create(5);
+  assert(q);
+  assert(s_spsc_queue_capacity(q) == 8);   // Rounded up to a power of 2
+  assert(s_spsc_queue_length(q) == 0);
+  s_spsc_queue_free(q);
+
+  q = s_spsc_queue_create(16);
+  assert(q);
+  assert(s_spsc_queue_capacity(q) == 16);
+  s_spsc_queue_free(q);
+
+  assert(!s_spsc_queue_create(0));
+}
+
+void test_s_spsc_queue_push_pop() {
+  s_spsc_queue q = s_spsc_queue_create(4);
+  assert(q);
+
+  int values[5] = {0, 1, 2, 3, 4};
+  void *item;
+
+  assert(!s_spsc_queue_pop(q, &item));     // Empty
+
+  for (size_t k = 0; k < 4; k++)
+    assert(s_spsc_queue_push(q, &values[k]));
+  assert(!s_spsc_queue_push(q, &values[4])); // Full
+  assert(s_spsc_queue_length(q) == 4);
+
+  // First in first out, also across the end of the buffer
+  for (size_t round = 0; round < 10; round++) {
+    assert(s_spsc_queue_pop(q, &item));
+    assert(*(int *) item == (int) (round % 5));
+    assert(s_spsc_queue_push(q, &values[(round + 4) % 5]));
+  }
+
+  for (size_t k = 0; k < 4; k++)
+    assert(s_spsc_queue_pop(q, &item));
+  assert(!s_spsc_queue_pop(q, &item));
+  assert(s_spsc_queue_length(q) == 0);
+
+  s_spsc_queue_free(q);
+}
+
+#define THREADED_ITEMS 100000
+
+void *producer(void *arg) {
+  s_spsc_queue q = arg;
+  for (uintptr_t k = 1; k <= THREADED_ITEMS; k++)
+    while (!s_spsc_queue_push(q, (void *) k)) ;
+  return NULL;
+}
+
+void test_s_spsc_queue_threads() {
+  s_spsc_queue q = s_spsc_queue_create(64);
+  assert(q);
+
+  pthread_t thread;
+  assert(pthread_create(&thread, NULL, producer, q) == 0);
+
+  // Every item is received once and in order
+  for (uintptr_t k = 1; k <= THREADED_ITEMS; k++) {
+    void *item;
+    while (!s_spsc_queue_pop(q, &item)) ;
+    assert((uintptr_t) item == k);
+  }
+
+  pthread_join(thread, NULL);
+  assert(s_spsc_queue_length(q) == 0);
+  s_spsc_queue_free(q);
+}
+
+void usage(char *exec) {
+  printf("%s testname     -> Execute the given testname\n", exec);
+  printf("%s all    -> Execute every tests\n", exec);
+}
+
+int main(int argc, char *argv[]) {
+  if (argc != 2) {
+    usage(argv[0]);
+    exit(EXIT_FAILURE);
+  }
+
+  bool execute_all = strcmp(argv[1], "all") == 0;
+
+  if (strcmp(argv[1], "test_s_spsc_queue_create") == 0 || execute_all) {
+    test_s_spsc_queue_create();
+  }
+  if (strcmp(argv[1], "test_s_spsc_queue_push_pop") == 0 || execute_all) {
+    test_s_spsc_queue_push_pop();
+  }
+  if (strcmp(argv[1], "test_s_spsc_queue_threads") == 0 || execute_all) {
+    test_s_spsc_queue_threads();
+  }
+  return EXIT_SUCCESS;
+}
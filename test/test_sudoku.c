@@ -99,6 +99,139 @@ void test_s_sudoku_create_from_file() {
   assert(!g);
 }
 
+void test_s_sudoku_create_from_buffer() {
+  char buffer[] = "0;1;2;0\n0;0;0;1\n0;3;0;2\n0;2;0;0\n";
+  s_sudoku g = s_sudoku_create_from_buffer(buffer, strlen(buffer));
+  assert(g);
+
+  assert(s_sudoku_size(g) == 4);
+  assert(s_sudoku_get_cell_value(g, 2, 1) == 3);
+  assert(s_sudoku_get_cell_value(g, 3, 1) == 2);
+  assert(s_sudoku_get_cell_value(g, 0, 0) == 0);
+
+  s_sudoku_free(g);
+
+  // The buffer does not need to be null terminated
+  g = s_sudoku_create_from_buffer(buffer, strlen(buffer) - 1);
+  assert(g);
+  s_sudoku_free(g);
+
+  char missing_line[] = "0;1;2;0\n0;0;0;1\n0;3;0;2\n";
+  g = s_sudoku_create_from_buffer(missing_line, strlen(missing_line));
+  assert(!g);
+
+  char missing_cell[] = "0;1;2;0\n0;0;0;1\n0;3;0\n0;2;0;0\n";
+  g = s_sudoku_create_from_buffer(missing_cell, strlen(missing_cell));
+  assert(!g);
+
+  char extra_cell[] = "0;1;2;0\n0;0;0;1;1\n0;3;0;2\n0;2;0;0\n";
+  g = s_sudoku_create_from_buffer(extra_cell, strlen(extra_cell));
+  assert(!g);
+
+  char invalid_value[] = "0;1;2;0\n0;0;0;5\n0;3;0;2\n0;2;0;0\n";
+  g = s_sudoku_create_from_buffer(invalid_value, strlen(invalid_value));
+  assert(!g);
+
+  char negative_value[] = "0;1;2;0\n0;0;0;-1\n0;3;0;2\n0;2;0;0\n";
+  g = s_sudoku_create_from_buffer(negative_value, strlen(negative_value));
+  assert(!g);
+
+  assert(!s_sudoku_create_from_buffer(NULL, 0));
+  assert(!s_sudoku_create_from_buffer(buffer, 0));
+}
+
+void test_s_sudoku_create_from_line() {
+  char line[] = ".12....1.3.2.2..\n";
+  s_sudoku g = s_sudoku_create_from_line(line, strlen(line));
+  assert(g);
+
+  assert(s_sudoku_size(g) == 4);
+  assert(s_sudoku_get_cell_value(g, 2, 1) == 3);
+  assert(s_sudoku_get_cell_value(g, 0, 0) == 0);
+
+  s_sudoku_free(g);
+
+  char zeros[] = "0120000103020200";
+  g = s_sudoku_create_from_line(zeros, strlen(zeros));
+  assert(g);
+  assert(s_sudoku_get_cell_value(g, 2, 3) == 2);
+  assert(s_sudoku_get_cell_value(g, 3, 3) == 0);
+  s_sudoku_free(g);
+
+  char invalid_length[] = ".12....1.3.2.2.";
+  assert(!s_sudoku_create_from_line(invalid_length, strlen(invalid_length)));
+
+  char invalid_value[] = ".12....1.3.2.5..";
+  assert(!s_sudoku_create_from_line(invalid_value, strlen(invalid_value)));
+
+  char invalid_char[] = ".12....1.3.2.;..";
+  assert(!s_sudoku_create_from_line(invalid_char, strlen(invalid_char)));
+
+  assert(!s_sudoku_create_from_line(NULL, 0));
+}
+
+void test_s_sudoku_char_to_value() {
+  assert(s_sudoku_char_to_value('.') == 0);
+  assert(s_sudoku_char_to_value('0') == 0);
+  assert(s_sudoku_char_to_value('7') == 7);
+  assert(s_sudoku_char_to_value('A') == 10);
+  assert(s_sudoku_char_to_value('g') == 16);
+  assert(s_sudoku_char_to_value(';') == -1);
+
+  for (size_t val = 0; val <= 35; val++)
+    assert(s_sudoku_char_to_value(s_sudoku_value_to_char(val)) == val);
+  assert(s_sudoku_value_to_char(36) == '?');
+}
+
+void test_s_sudoku_render_size() {
+  assert(s_sudoku_render_size(9, SUDOKU_FORMAT_LINE) == 82);
+  assert(s_sudoku_render_size(9, SUDOKU_FORMAT_SEMICOLON) == 162);
+  assert(s_sudoku_render_size(16, SUDOKU_FORMAT_SEMICOLON) == 768);
+  assert(s_sudoku_render_size(4, SUDOKU_FORMAT_PRETTY) > 0);
+}
+
+void test_s_sudoku_render() {
+  char line[] = ".12....1.3.2.2..";
+  s_sudoku g = s_sudoku_create_from_line(line, strlen(line));
+  assert(g);
+
+  char buffer[1024];
+
+  size_t length = s_sudoku_render(g, SUDOKU_FORMAT_LINE, buffer, sizeof(buffer));
+  assert(length == 17);
+  assert(strncmp(buffer, ".12....1.3.2.2..\n", length) == 0);
+
+  char semicolon[] = "0;1;2;0\n0;0;0;1\n0;3;0;2\n0;2;0;0\n";
+  length = s_sudoku_render(g, SUDOKU_FORMAT_SEMICOLON, buffer, sizeof(buffer));
+  assert(length == strlen(semicolon));
+  assert(strncmp(buffer, semicolon, length) == 0);
+
+  char pretty[] =
+    "   ┊ 1 ┃ 2 ┊   \n"
+    "┈┈┈┈┈┈┈┈┈┈┈┈┈┈┈┈\n"
+    "   ┊   ┃   ┊ 1 \n"
+    "━━━━━━━━━━━━━━━━\n"
+    "   ┊ 3 ┃   ┊ 2 \n"
+    "┈┈┈┈┈┈┈┈┈┈┈┈┈┈┈┈\n"
+    "   ┊ 2 ┃   ┊   \n";
+  length = s_sudoku_render(g, SUDOKU_FORMAT_PRETTY, buffer, sizeof(buffer));
+  assert(length == strlen(pretty));
+  assert(length <= s_sudoku_render_size(4, SUDOKU_FORMAT_PRETTY));
+  assert(strncmp(buffer, pretty, length) == 0);
+
+  // The rendered grid can be read back
+  length = s_sudoku_render(g, SUDOKU_FORMAT_SEMICOLON, buffer, sizeof(buffer));
+  s_sudoku g2 = s_sudoku_create_from_buffer(buffer, length);
+  assert(g2);
+  assert(s_sudoku_get_cell_value(g2, 2, 1) == 3);
+  s_sudoku_free(g2);
+
+  assert(s_sudoku_render(g, SUDOKU_FORMAT_LINE, buffer, 16) == 0);  // Too small
+  assert(s_sudoku_render(NULL, SUDOKU_FORMAT_LINE, buffer, sizeof(buffer)) == 0);
+
+  s_sudoku_free(g);
+}
+
 void test_s_sudoku_print() {
   s_sudoku g = s_sudoku_create(4);
   assert(g);
@@ -140,6 +273,21 @@ int main(int argc, char *argv[]) {
   if (strcmp(argv[1], "test_s_sudoku_create_from_file") == 0 || execute_all) {
     test_s_sudoku_create_from_file();
   }
+  if (strcmp(argv[1], "test_s_sudoku_create_from_buffer") == 0 || execute_all) {
+    test_s_sudoku_create_from_buffer();
+  }
+  if (strcmp(argv[1], "test_s_sudoku_create_from_line") == 0 || execute_all) {
+    test_s_sudoku_create_from_line();
+  }
+  if (strcmp(argv[1], "test_s_sudoku_char_to_value") == 0 || execute_all) {
+    test_s_sudoku_char_to_value();
+  }
+  if (strcmp(argv[1], "test_s_sudoku_render_size") == 0 || execute_all) {
+    test_s_sudoku_render_size();
+  }
+  if (strcmp(argv[1], "test_s_sudoku_render") == 0 || execute_all) {
+    test_s_sudoku_render();
+  }
   if (strcmp(argv[1], "test_s_sudoku_print") == 0 || execute_all) {
     test_s_sudoku_print();
   }
@@ -1,3 +1,5 @@
+#define _POSIX_C_SOURCE 200809L
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdbool.h>
@@ -8,6 +10,7 @@
 
 #include "sudoku_cnf.h"
 #include "sudoku.h"
+#include "alloc.h"
 
 void test_sat_var_to_litt() {
   s_sudoku g = s_sudoku_create(4);
@@ -51,6 +54,497 @@ void test_litt_to_sat_var() {
   s_sudoku_free(g);
 }
 
+void test_sudoku_solve() {
+  s_sudoku g = s_sudoku_create_from_file("../data/test.txt");
+  assert(g);
+
+  assert(sudoku_solve(g) == 1);
+
+  // Default values are kept
+  assert(s_sudoku_get_cell_value(g, 0, 1) == 1);
+  assert(s_sudoku_get_cell_value(g, 2, 1) == 3);
+
+  // Every line, col and block contains every value
+  for (int k = 0; k < 4; k++) {
+    int line = 0, col = 0, block = 0;
+    for (int l = 0; l < 4; l++) {
+      line |= 1 << s_sudoku_get_cell_value(g, k, l);
+      col |= 1 << s_sudoku_get_cell_value(g, l, k);
+      block |= 1 << s_sudoku_get_cell_value(g, k / 2 * 2 + l / 2, k % 2 * 2 + l % 2);
+    }
+    assert(line == 0x1e && col == 0x1e && block == 0x1e);
+  }
+
+  s_sudoku_free(g);
+
+  // Two 1 on the same line
+  char line[] = "1..1............";
+  g = s_sudoku_create_from_line(line, strlen(line));
+  assert(g);
+  assert(sudoku_solve(g) == 0);
+  assert(s_sudoku_get_cell_value(g, 0, 1) == 0); // Unchanged
+  s_sudoku_free(g);
+
+  assert(sudoku_solve(NULL) == -1);
+}
+
+void test_s_sudoku_solver_solve() {
+  s_sudoku_solver sv = s_sudoku_solver_create();
+  assert(sv);
+
+  // Grids of different sizes with the same solver
+  char *files[] = {"../data/test.txt", "../data/test3.txt", "../data/test2.txt"};
+  // test2.txt has several solutions, the one of the solver is checked
+  int expected[][3] = {{0, 0, 3}, {0, 0, 6}, {0, 1, 3}};
+
+  for (int k = 0; k < 3; k++) {
+    s_sudoku g = s_sudoku_create_from_file(files[k]);
+    assert(g);
+
+    assert(s_sudoku_solver_solve(sv, g) == 1);
+    assert(s_sudoku_get_cell_value(g, expected[k][0], expected[k][1]) == expected[k][2]);
+
+    s_sudoku_free(g);
+  }
+
+  char line[] = "1..1............";
+  s_sudoku g = s_sudoku_create_from_line(line, strlen(line));
+  assert(g);
+  assert(s_sudoku_solver_solve(sv, g) == 0);
+  s_sudoku_free(g);
+
+  assert(s_sudoku_solver_solve(sv, NULL) == -1);
+  assert(s_sudoku_solver_solve(NULL, NULL) == -1);
+
+  s_sudoku_solver_free(sv);
+}
+
+void test_s_sudoku_solver_create_portfolio() {
+  assert(s_sudoku_solver_create_portfolio(0, false) == NULL);
+
+  // The solvers racing, then sharing the search
+  for (int conquer = 0; conquer <= 1; conquer++) {
+    s_sudoku_solver sv = s_sudoku_solver_create_portfolio(3, conquer);
+    assert(sv);
+    count_number count;
+
+    // Whichever solver answers, its solution is complete and valid
+    char *files[] = {"../data/test.txt", "../data/hard.txt", "../data/test3.txt",
+                     "../data/hard.txt"};
+    for (int k = 0; k < 4; k++) {
+      s_sudoku g = s_sudoku_create_from_file(files[k]);
+      assert(g);
+
+      assert(s_sudoku_solver_solve(sv, g) == 1);
+      assert(s_sudoku_solver_count_all(sv, g, &count) == 0);
+      assert(count == 1);
+
+      s_sudoku_free(g);
+    }
+
+    // Counts use the first solver only, after the resolution
+    char line[] = ".12....1.3.2.2..";
+    s_sudoku g = s_sudoku_create_from_line(line, strlen(line));
+    assert(g);
+    assert(s_sudoku_solver_count(sv, g, 10) == 2);
+    assert(s_sudoku_solver_solve(sv, g) == 1);
+
+    line[3] = '1';
+    s_sudoku_free(g);
+    g = s_sudoku_create_from_line(line, strlen(line));
+    assert(g);
+    assert(s_sudoku_solver_solve(sv, g) == 0);
+    s_sudoku_free(g);
+
+    sudoku_stats stats;
+    s_sudoku_solver_get_stats(sv, &stats);
+    assert(stats.grids == 11 && stats.solvable == 10);
+
+    s_sudoku_solver_free(sv);
+  }
+}
+
+void test_s_sudoku_solver_set_preprocess() {
+  // A single solver, then a race of solvers
+  for (int solvers = 1; solvers <= 3; solvers += 2) {
+    s_sudoku_solver sv = solvers == 1 ? s_sudoku_solver_create()
+                                      : s_sudoku_solver_create_portfolio(solvers, false);
+    assert(sv);
+    s_sudoku_solver_set_preprocess(sv, true);
+    count_number count;
+
+    // The cells of the variables eliminated are set back from the model
+    char *files[] = {"../data/test.txt", "../data/hard.txt", "../data/test3.txt"};
+    for (int k = 0; k < 3; k++) {
+      s_sudoku g = s_sudoku_create_from_file(files[k]);
+      assert(g);
+
+      assert(s_sudoku_solver_solve(sv, g) == 1);
+      assert(s_sudoku_solver_count_all(sv, g, &count) == 0);
+      assert(count == 1);
+
+      s_sudoku_free(g);
+    }
+
+    char line[] = "1..1............";
+    s_sudoku g = s_sudoku_create_from_line(line, strlen(line));
+    assert(g);
+    assert(s_sudoku_solver_solve(sv, g) == 0);
+    s_sudoku_free(g);
+
+    sudoku_stats stats;
+    s_sudoku_solver_get_stats(sv, &stats);
+    assert(stats.grids == 7 && stats.solvable == 6);
+    assert(stats.preprocess.fixed > 0 && stats.preprocess.eliminated > 0);
+    assert(stats.preprocess.removed_clauses > 0 && stats.preprocess.seconds > 0);
+    assert(stats.encode_seconds > 0);
+
+    // The rules are loaded again without preprocessing
+    s_sudoku_solver_set_preprocess(sv, false);
+    g = s_sudoku_create_from_file("../data/test.txt");
+    assert(g);
+    assert(s_sudoku_solver_solve(sv, g) == 1);
+    assert(s_sudoku_get_cell_value(g, 0, 0) == 3);
+    s_sudoku_free(g);
+
+    s_sudoku_solver_get_stats(sv, &stats);
+    assert(stats.grids == 8 && stats.solvable == 7);
+
+    s_sudoku_solver_free(sv);
+  }
+}
+
+void test_s_sudoku_solver_get_stats() {
+  s_sudoku_solver sv = s_sudoku_solver_create();
+  assert(sv);
+
+  sudoku_stats stats;
+  s_sudoku_solver_get_stats(sv, &stats);
+  assert(stats.grids == 0 && stats.solvable == 0);
+  assert(stats.dpll.decisions == 0 && stats.dpll.clauses == 0);
+
+  char *lines[] = {".12....1.3.2.2..", "1..1............"};
+  for (int k = 0; k < 2; k++) {
+    s_sudoku g = s_sudoku_create_from_line(lines[k], strlen(lines[k]));
+    assert(g);
+    s_sudoku_solver_solve(sv, g);
+    s_sudoku_free(g);
+  }
+
+  s_sudoku_solver_get_stats(sv, &stats);
+  assert(stats.grids == 2 && stats.solvable == 1);
+  assert(stats.dpll.conflicts >= 1);         // The second grid can't be solved
+  assert(stats.dpll.propagations > 0);
+  assert(stats.dpll.clauses > 0 && stats.dpll.litts > stats.dpll.clauses);
+  assert(stats.dpll.vars > 0);
+  assert(stats.encode_seconds > 0 && stats.solve_seconds > 0);
+
+  // Statistics of several solvers can be summed
+  sudoku_stats total;
+  memset(&total, 0, sizeof(total));
+  sudoku_stats_add(&total, &stats);
+  sudoku_stats_add(&total, &stats);
+  assert(total.grids == 4 && total.solvable == 2);
+  assert(total.dpll.clauses == 2 * stats.dpll.clauses);
+
+  FILE *file = tmpfile();
+  assert(file);
+  sudoku_stats_print(file, &total);
+  rewind(file);
+  char buffer[1024];
+  size_t length = fread(buffer, 1, sizeof(buffer) - 1, file);
+  buffer[length] = '\0';
+  char expected[] = "{\"grids\": 4, \"solvable\": 2,";
+  assert(strncmp(buffer, expected, strlen(expected)) == 0);
+  assert(strstr(buffer, "\"peak_rss_kb\": "));
+  fclose(file);
+
+  s_sudoku_solver_free(sv);
+}
+
+void test_s_sudoku_solver_solve_assuming() {
+  s_sudoku_solver sv = s_sudoku_solver_create();
+  assert(sv);
+
+  char line[] = ".12....1.3.2.2..";
+  s_sudoku g = s_sudoku_create_from_line(line, strlen(line));
+  assert(g);
+
+  // One litteral per non empty cell
+  int assumptions[16];
+  size_t length = sudoku_to_assumptions(g, assumptions);
+  assert(length == 6);
+  sat_var v = {0, 1, 1, false};
+  assert(assumptions[0] == sat_var_to_litt(g, v));
+
+  assert(s_sudoku_solver_solve_assuming(sv, g, assumptions, length) == 1);
+  assert(s_sudoku_get_cell_value(g, 0, 0) == 3);
+
+  // The next grids of the same size neither encode the rules nor allocate
+  // (once the buffer of the assumptions is allocated by the first one)
+  s_sudoku grids[3];
+  for (int k = 0; k < 3; k++) {
+    grids[k] = s_sudoku_create_from_line(line, strlen(line));
+    assert(grids[k]);
+  }
+  assert(s_sudoku_solver_solve(sv, grids[0]) == 1);
+
+  alloc_stats allocs;
+  alloc_set_counting(true);
+  alloc_reset_stats();
+
+  for (int k = 1; k < 3; k++) {
+    assert(s_sudoku_solver_solve(sv, grids[k]) == 1);
+    assert(s_sudoku_get_cell_value(grids[k], 0, 0) == 3);
+  }
+
+  alloc_get_total(&allocs);
+  assert(allocs.allocations == 0);
+  alloc_set_counting(false);
+
+  for (int k = 0; k < 3; k++)
+    s_sudoku_free(grids[k]);
+
+  // The givens of the previous grid are not kept
+  s_sudoku empty = s_sudoku_create(4);
+  assert(empty);
+  assert(s_sudoku_solver_solve(sv, empty) == 1);
+  s_sudoku_free(empty);
+
+  char unsolvable[] = "11..............";
+  s_sudoku u = s_sudoku_create_from_line(unsolvable, strlen(unsolvable));
+  assert(u);
+  length = sudoku_to_assumptions(u, assumptions);
+  assert(s_sudoku_solver_solve_assuming(sv, u, assumptions, length) == 0);
+  assert(s_sudoku_solver_solve_assuming(sv, g, assumptions, 0) == 1);
+  assert(s_sudoku_solver_solve_assuming(sv, g, NULL, 1) == -1);
+  s_sudoku_free(u);
+
+  s_sudoku_free(g);
+  s_sudoku_solver_free(sv);
+}
+
+void test_s_sudoku_solver_count() {
+  s_sudoku_solver sv = s_sudoku_solver_create();
+  assert(sv);
+
+  // The empty grid of size 4 has 288 solutions
+  s_sudoku empty = s_sudoku_create(4);
+  assert(empty);
+  assert(s_sudoku_solver_count(sv, empty, 1000) == 288);
+  assert(s_sudoku_solver_count(sv, empty, 2) == 2);
+  assert(s_sudoku_get_cell_value(empty, 0, 0) == 0);
+  s_sudoku_free(empty);
+
+  char line[] = ".12....1.3.2.2..";
+  s_sudoku g = s_sudoku_create_from_line(line, strlen(line));
+  assert(g);
+  assert(s_sudoku_solver_count(sv, g, 2) == 2);
+
+  // A solution without one of its cells is unique
+  char unique[] = "3124243113424.13";
+  s_sudoku u = s_sudoku_create_from_line(unique, strlen(unique));
+  assert(u);
+  assert(s_sudoku_solver_count(sv, u, 2) == 1);
+  assert(s_sudoku_get_cell_value(u, 3, 1) == 0);
+
+  // The counts don't change the next resolutions
+  assert(s_sudoku_solver_solve(sv, g) == 1);
+  assert(s_sudoku_get_cell_value(g, 0, 0) == 3);
+
+  char unsolvable[] = "11..............";
+  s_sudoku_free(u);
+  u = s_sudoku_create_from_line(unsolvable, strlen(unsolvable));
+  assert(u);
+  assert(s_sudoku_solver_count(sv, u, 2) == 0);
+  assert(s_sudoku_solver_count(sv, u, 0) == -1);
+
+  sudoku_stats stats;
+  s_sudoku_solver_get_stats(sv, &stats);
+  assert(stats.grids == 6 && stats.solvable == 5);
+
+  s_sudoku_free(u);
+  s_sudoku_free(g);
+  s_sudoku_solver_free(sv);
+}
+
+void test_s_sudoku_solver_count_all() {
+  s_sudoku_solver sv = s_sudoku_solver_create();
+  assert(sv);
+  count_number count;
+
+  // The empty grid of size 4 has 288 solutions
+  s_sudoku empty = s_sudoku_create(4);
+  assert(empty);
+  assert(s_sudoku_solver_count_all(sv, empty, &count) == 0);
+  assert(count == 288);
+  assert(s_sudoku_get_cell_value(empty, 0, 0) == 0);
+  s_sudoku_free(empty);
+
+  char line[] = ".12....1.3.2.2..";
+  s_sudoku g = s_sudoku_create_from_line(line, strlen(line));
+  assert(g);
+  assert(s_sudoku_solver_count_all(sv, g, &count) == 0);
+  assert(count == 2);
+
+  // Same count as the one of the sat solver on a grid of size 9
+  char partial[] = ".....364.9.36..1.....491.....423.......8....."
+                   "2.7....3........684....691..9..1..5.";
+  s_sudoku p = s_sudoku_create_from_line(partial, strlen(partial));
+  assert(p);
+  assert(s_sudoku_solver_count_all(sv, p, &count) == 0);
+  assert(count == 668);
+  assert(s_sudoku_solver_count(sv, p, 1000) == 668);
+  s_sudoku_free(p);
+
+  char unsolvable[] = "11..............";
+  s_sudoku u = s_sudoku_create_from_line(unsolvable, strlen(unsolvable));
+  assert(u);
+  assert(s_sudoku_solver_count_all(sv, u, &count) == 0);
+  assert(count == 0);
+  assert(s_sudoku_solver_count_all(sv, u, NULL) == -1);
+
+  sudoku_stats stats;
+  s_sudoku_solver_get_stats(sv, &stats);
+  assert(stats.grids == 5 && stats.solvable == 4);
+
+  s_sudoku_free(u);
+  s_sudoku_free(g);
+  s_sudoku_solver_free(sv);
+}
+
+// Solutions given to test_enumerate_solution, as their first lines
+struct test_enumeration {
+  int seen[256];
+  int solutions, stop;
+};
+
+int test_enumerate_solution(s_sudoku solution, void *ctx) {
+  struct test_enumeration *t = ctx;
+  int line = 0;
+  for (size_t j = 0; j < 4; j++)
+    line = 4 * line + s_sudoku_get_cell_value(solution, 0, j) - 1;
+  t->seen[line]++;
+  return ++t->solutions == t->stop;
+}
+
+void test_s_sudoku_solver_enumerate() {
+  s_sudoku_solver sv = s_sudoku_solver_create();
+  assert(sv);
+
+  // The 288 solutions of the empty grid of size 4, 12 for each first line
+  s_sudoku empty = s_sudoku_create(4);
+  assert(empty);
+  struct test_enumeration t = {{0}, 0, 0};
+  assert(s_sudoku_solver_enumerate(sv, empty, test_enumerate_solution, &t) == 288);
+  int lines = 0;
+  for (int line = 0; line < 256; line++) {
+    assert(t.seen[line] == 0 || t.seen[line] == 12);
+    lines += t.seen[line] == 12;
+  }
+  assert(lines == 24);
+  assert(s_sudoku_get_cell_value(empty, 0, 0) == 0);
+
+  // Stopped by the callback
+  t = (struct test_enumeration) {{0}, 0, 5};
+  assert(s_sudoku_solver_enumerate(sv, empty, test_enumerate_solution, &t) == 5);
+  s_sudoku_free(empty);
+
+  char line[] = ".12....1.3.2.2..";
+  s_sudoku g = s_sudoku_create_from_line(line, strlen(line));
+  assert(g);
+  t = (struct test_enumeration) {{0}, 0, 0};
+  assert(s_sudoku_solver_enumerate(sv, g, test_enumerate_solution, &t) == 2);
+  assert(s_sudoku_get_cell_value(g, 0, 0) == 0);
+
+  char unsolvable[] = "11..............";
+  s_sudoku u = s_sudoku_create_from_line(unsolvable, strlen(unsolvable));
+  assert(u);
+  assert(s_sudoku_solver_enumerate(sv, u, test_enumerate_solution, &t) == 0);
+  assert(s_sudoku_solver_enumerate(sv, u, NULL, &t) == -1);
+
+  sudoku_stats stats;
+  s_sudoku_solver_get_stats(sv, &stats);
+  assert(stats.grids == 4 && stats.solvable == 3);
+
+  s_sudoku_free(u);
+  s_sudoku_free(g);
+  s_sudoku_solver_free(sv);
+}
+
+void test_sudoku_set_rules_cache() {
+  char directory[] = "test_cache_XXXXXX";
+  assert(mkdtemp(directory));
+  assert(sudoku_set_rules_cache(directory) == 0);
+
+  char path[256];
+  snprintf(path, sizeof(path), "%s/rules-4.sdkr", directory);
+
+  // The first solver writes the rules, the second one reads them
+  char line[] = ".12....1.3.2.2..";
+  char solutions[2][17];
+  for (int k = 0; k < 2; k++) {
+    s_sudoku_solver sv = s_sudoku_solver_create();
+    assert(sv);
+    s_sudoku g = s_sudoku_create_from_line(line, strlen(line));
+    assert(g);
+
+    assert(s_sudoku_solver_solve(sv, g) == 1);
+    assert(s_sudoku_render(g, SUDOKU_FORMAT_LINE, solutions[k], 17) == 17);
+    assert(access(path, R_OK) == 0);
+
+    // The formula of the rules is rebuilt from the file
+    s_cnf cn = s_sudoku_solver_encode(sv, g);
+    assert(cn && s_cnf_get_clauses_count(cn) > 16);
+    s_cnf_free(cn);
+
+    s_sudoku_free(g);
+    s_sudoku_solver_free(sv);
+  }
+  assert(memcmp(solutions[0], solutions[1], 17) == 0);
+
+  // An invalid file is encoded again and replaced
+  FILE *file = fopen(path, "w");
+  assert(file);
+  fputs("SDKR garbage", file);
+  fclose(file);
+
+  s_sudoku g = s_sudoku_create_from_line(line, strlen(line));
+  assert(g);
+  assert(sudoku_solve(g) == 1);
+  assert(s_sudoku_get_cell_value(g, 0, 0) == 3);
+  s_sudoku_free(g);
+
+  file = fopen(path, "r");
+  assert(file);
+  char magic[4];
+  assert(fread(magic, 1, 4, file) == 4 && memcmp(magic, "SDKR", 4) == 0);
+  assert(fgetc(file) == 1);     // Version
+  assert(fseek(file, 0, SEEK_END) == 0);
+  long size = ftell(file);
+  fclose(file);
+
+  // So is a truncated file, whose missing litterals are not read as empty
+  // clauses
+  assert(truncate(path, size / 2) == 0);
+  s_sudoku_solver sv = s_sudoku_solver_create();
+  assert(sv);
+  g = s_sudoku_create(4);
+  assert(g);
+  assert(s_sudoku_solver_solve(sv, g) == 1);
+  s_sudoku_free(g);
+  s_sudoku_solver_free(sv);
+
+  file = fopen(path, "r");
+  assert(file);
+  assert(fseek(file, 0, SEEK_END) == 0 && ftell(file) == size);
+  fclose(file);
+
+  assert(sudoku_set_rules_cache(NULL) == 0);
+  unlink(path);
+  rmdir(directory);
+}
+
 void usage(char *exec) {
   printf("%s testname     -> Execute the given testname\n", exec);
   printf("%s all    -> Execute every tests\n", exec);
@@ -70,5 +564,35 @@ int main(int argc, char *argv[]) {
   if (strcmp(argv[1], "test_litt_to_sat_var") == 0 || execute_all) {
     test_litt_to_sat_var();
   }
+  if (strcmp(argv[1], "test_sudoku_solve") == 0 || execute_all) {
+    test_sudoku_solve();
+  }
+  if (strcmp(argv[1], "test_s_sudoku_solver_solve") == 0 || execute_all) {
+    test_s_sudoku_solver_solve();
+  }
+  if (strcmp(argv[1], "test_s_sudoku_solver_create_portfolio") == 0 || execute_all) {
+    test_s_sudoku_solver_create_portfolio();
+  }
+  if (strcmp(argv[1], "test_s_sudoku_solver_set_preprocess") == 0 || execute_all) {
+    test_s_sudoku_solver_set_preprocess();
+  }
+  if (strcmp(argv[1], "test_s_sudoku_solver_get_stats") == 0 || execute_all) {
+    test_s_sudoku_solver_get_stats();
+  }
+  if (strcmp(argv[1], "test_s_sudoku_solver_solve_assuming") == 0 || execute_all) {
+    test_s_sudoku_solver_solve_assuming();
+  }
+  if (strcmp(argv[1], "test_s_sudoku_solver_count") == 0 || execute_all) {
+    test_s_sudoku_solver_count();
+  }
+  if (strcmp(argv[1], "test_s_sudoku_solver_count_all") == 0 || execute_all) {
+    test_s_sudoku_solver_count_all();
+  }
+  if (strcmp(argv[1], "test_s_sudoku_solver_enumerate") == 0 || execute_all) {
+    test_s_sudoku_solver_enumerate();
+  }
+  if (strcmp(argv[1], "test_sudoku_set_rules_cache") == 0 || execute_all) {
+    test_sudoku_set_rules_cache();
+  }
   return EXIT_SUCCESS;
 }
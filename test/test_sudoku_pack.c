@@ -0,0 +1,273 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+
+#include <unistd.h>
+#include <string.h>
+#include <assert.h>
+
+#include "sudoku.h"
+#include "sudoku_pack.h"
+#include "alloc.h"
+
+/* Writes a pack of count grids of size n to filename where grid k has the
+ * value (i + j + k) % (n + 1) in cell (i, j)
+ */
+void write_test_pack(char *filename, size_t n, size_t count) {
+  s_sudoku_pack_writer w = s_sudoku_pack_writer_create(filename, n);
+  assert(w);
+
+  s_sudoku g = s_sudoku_create(n);
+  assert(g);
+
+  for (size_t k = 0; k < count; k++) {
+    for (size_t i = 0; i < n; i++)
+      for (size_t j = 0; j < n; j++)
+        s_sudoku_set_cell_value(g, i, j, (i + j + k) % (n + 1));
+
+    assert(s_sudoku_pack_writer_add(w, g) == 0);
+  }
+
+  s_sudoku_free(g);
+  assert(s_sudoku_pack_writer_close(w) == 0);
+}
+
+/* Checks that g is grid k of write_test_pack
+ */
+void check_test_grid(s_sudoku g, size_t n, size_t k) {
+  assert(s_sudoku_size(g) == n);
+
+  for (size_t i = 0; i < n; i++)
+    for (size_t j = 0; j < n; j++)
+      assert(s_sudoku_get_cell_value(g, i, j) == (i + j + k) % (n + 1));
+}
+
+void test_s_sudoku_pack_writer_create() {
+  char filename[] = "test_pack_XXXXXX";
+  close(mkstemp(filename));
+
+  s_sudoku_pack_writer w = s_sudoku_pack_writer_create(filename, 9);
+  assert(w);
+  assert(s_sudoku_pack_writer_close(w) == 0);
+
+  assert(!s_sudoku_pack_writer_create(filename, 5)); // Invalid size
+  assert(!s_sudoku_pack_writer_create(NULL, 9));     // Invalid filename
+
+  unlink(filename);
+}
+
+void test_s_sudoku_pack_writer_add() {
+  char filename[] = "test_pack_XXXXXX";
+  close(mkstemp(filename));
+
+  s_sudoku_pack_writer w = s_sudoku_pack_writer_create(filename, 4);
+  assert(w);
+
+  s_sudoku g = s_sudoku_create(4);
+  assert(g);
+  assert(s_sudoku_pack_writer_add(w, g) == 0);
+  s_sudoku_free(g);
+
+  g = s_sudoku_create(9);
+  assert(g);
+  assert(s_sudoku_pack_writer_add(w, g) == -1);   // Invalid size
+  s_sudoku_free(g);
+
+  assert(s_sudoku_pack_writer_add(w, NULL) == -1);
+  assert(s_sudoku_pack_writer_close(w) == 0);
+
+  unlink(filename);
+}
+
+// Largest block asked to the allocator of test_s_sudoku_pack_open
+size_t largest_request = 0;
+
+void *record_malloc(void *ctx, size_t size) {
+  (void) ctx;
+  if (size > largest_request) largest_request = size;
+  return malloc(size);
+}
+
+void *record_calloc(void *ctx, size_t count, size_t size) {
+  (void) ctx;
+  if (count * size > largest_request) largest_request = count * size;
+  return calloc(count, size);
+}
+
+void *record_realloc(void *ctx, void *ptr, size_t size) {
+  (void) ctx;
+  if (size > largest_request) largest_request = size;
+  return realloc(ptr, size);
+}
+
+void record_free(void *ctx, void *ptr) {
+  (void) ctx;
+  free(ptr);
+}
+
+void test_s_sudoku_pack_open() {
+  char filename[] = "test_pack_XXXXXX";
+  close(mkstemp(filename));
+
+  write_test_pack(filename, 9, 10);
+
+  s_sudoku_pack pk = s_sudoku_pack_open(filename);
+  assert(pk);
+
+  // Header of 32 bytes and records of 41 bytes
+  FILE *file = fopen(filename, "rb");
+  assert(file);
+  fseek(file, 0, SEEK_END);
+  assert(ftell(file) == 32 + 10 * 41);
+  fclose(file);
+
+  s_sudoku_pack_close(pk);
+
+  // A header of grids of size 0, whose records would be empty
+  write_test_pack(filename, 4, 0);
+  file = fopen(filename, "r+b");
+  assert(file);
+  unsigned char header[32];
+  assert(fread(header, 32, 1, file) == 1);
+  memset(header + 6, 0, 2);
+  header[8] = 1;
+  memset(header + 12, 0, 4);
+  rewind(file);
+  assert(fwrite(header, 32, 1, file) == 1);
+  fclose(file);
+  assert(!s_sudoku_pack_open(filename));
+
+  // A header of grids of size 255 * 255 is rejected without allocating
+  // such a grid
+  file = fopen(filename, "r+b");
+  assert(file);
+  header[6] = 65025 & 0xff;
+  header[7] = 65025 >> 8;
+  header[8] = 16;
+  assert(fwrite(header, 32, 1, file) == 1);
+  fclose(file);
+
+  alloc_allocator recording = {record_malloc, record_calloc, record_realloc, record_free,
+                                NULL, NULL};
+  alloc_set_allocator(&recording);
+  assert(!s_sudoku_pack_open(filename));
+  alloc_set_allocator(NULL);
+  assert(largest_request < 1024);
+
+  assert(!s_sudoku_pack_open("../data/test.txt"));  // Not a pack
+  assert(!s_sudoku_pack_open("non-existing-file"));
+
+  unlink(filename);
+}
+
+void test_s_sudoku_pack_count() {
+  char filename[] = "test_pack_XXXXXX";
+  close(mkstemp(filename));
+
+  write_test_pack(filename, 16, 7);
+
+  s_sudoku_pack pk = s_sudoku_pack_open(filename);
+  assert(pk);
+  assert(s_sudoku_pack_count(pk) == 7);
+  assert(s_sudoku_pack_size(pk) == 16);
+  s_sudoku_pack_close(pk);
+
+  assert(s_sudoku_pack_count(NULL) == 0);
+  assert(s_sudoku_pack_size(NULL) == 0);
+
+  unlink(filename);
+}
+
+void test_s_sudoku_pack_get() {
+  char filename[] = "test_pack_XXXXXX";
+  close(mkstemp(filename));
+
+  size_t sizes[] = {4, 9, 16, 25};
+
+  for (size_t s = 0; s < 4; s++) {
+    size_t n = sizes[s];
+    write_test_pack(filename, n, 20);
+
+    s_sudoku_pack pk = s_sudoku_pack_open(filename);
+    assert(pk);
+
+    // Random access in any order
+    for (size_t k = 20; k-- > 0;) {
+      s_sudoku g = s_sudoku_pack_get(pk, k);
+      assert(g);
+      check_test_grid(g, n, k);
+      s_sudoku_free(g);
+    }
+
+    assert(!s_sudoku_pack_get(pk, 20)); // Invalid index
+
+    s_sudoku_pack_close(pk);
+  }
+
+  unlink(filename);
+}
+
+void test_s_sudoku_pack_load() {
+  char filename[] = "test_pack_XXXXXX";
+  close(mkstemp(filename));
+
+  write_test_pack(filename, 9, 3);
+
+  s_sudoku_pack pk = s_sudoku_pack_open(filename);
+  assert(pk);
+
+  s_sudoku g = s_sudoku_create(9);
+  assert(g);
+
+  for (size_t k = 0; k < 3; k++) {
+    assert(s_sudoku_pack_load(pk, k, g) == 0);
+    check_test_grid(g, 9, k);
+  }
+
+  assert(s_sudoku_pack_load(pk, 3, g) == -1);   // Invalid index
+  s_sudoku_free(g);
+
+  g = s_sudoku_create(4);
+  assert(g);
+  assert(s_sudoku_pack_load(pk, 0, g) == -1);   // Invalid size
+  s_sudoku_free(g);
+
+  s_sudoku_pack_close(pk);
+  unlink(filename);
+}
+
+void usage(char *exec) {
+  printf("%s testname     -> Execute the given testname\n", exec);
+  printf("%s all    -> Execute every tests\n", exec);
+}
+
+int main(int argc, char *argv[]) {
+  if (argc != 2) {
+    usage(argv[0]);
+    exit(EXIT_FAILURE);
+  }
+
+  bool execute_all = strcmp(argv[1], "all") == 0;
+
+  if (strcmp(argv[1], "test_s_sudoku_pack_writer_create") == 0 || execute_all) {
+    test_s_sudoku_pack_writer_create();
+  }
+  if (strcmp(argv[1], "test_s_sudoku_pack_writer_add") == 0 || execute_all) {
+    test_s_sudoku_pack_writer_add();
+  }
+  if (strcmp(argv[1], "test_s_sudoku_pack_open") == 0 || execute_all) {
+    test_s_sudoku_pack_open();
+  }
+  if (strcmp(argv[1], "test_s_sudoku_pack_count") == 0 || execute_all) {
+    test_s_sudoku_pack_count();
+  }
+  if (strcmp(argv[1], "test_s_sudoku_pack_get") == 0 || execute_all) {
+    test_s_sudoku_pack_get();
+  }
+  if (strcmp(argv[1], "test_s_sudoku_pack_load") == 0 || execute_all) {
+    test_s_sudoku_pack_load();
+  }
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,154 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+
+#include <string.h>
+#include <assert.h>
+
+#include "sudoku.h"
+#include "sudoku_stream.h"
+
+void test_s_sudoku_stream_create() {
+  char buffer[] = "";
+  FILE *file = fmemopen(buffer, 1, "r");
+  assert(file);
+
+  s_sudoku_stream st = s_sudoku_stream_create(file);
+  assert(st);
+
+  s_sudoku_stream_free(st);
+  fclose(file);
+
+  assert(!s_sudoku_stream_create(NULL)); // Invalid file
+}
+
+void test_s_sudoku_stream_free() {
+  char buffer[] = "";
+  FILE *file = fmemopen(buffer, 1, "r");
+  assert(file);
+
+  s_sudoku_stream st = s_sudoku_stream_create(file);
+  assert(st);
+
+  s_sudoku_stream_free(st);
+  fclose(file);
+}
+
+void test_s_sudoku_stream_next() {
+  char buffer[] =
+    "# Semicolon grid\n"
+    "0;1;2;0\n0;0;0;1\n0;3;0;2\n0;2;0;0\n"
+    "\n"
+    ".12....1.3.2.2..\n"
+    "0120000103020200\n"
+    "..1\n"                             // Invalid grid
+    "8..........36......7..9.2...5...7.......457.....1...3...1....68..85...1..9....4..\n"
+    "0;0;0;0\n0;0;0\n";                 // Invalid grid (missing line)
+  FILE *file = fmemopen(buffer, strlen(buffer), "r");
+  assert(file);
+
+  s_sudoku_stream st = s_sudoku_stream_create(file);
+  assert(st);
+
+  // Three times the same grid in different formats
+  for (int k = 0; k < 3; k++) {
+    s_sudoku g = s_sudoku_stream_next(st);
+    assert(g);
+    assert(s_sudoku_size(g) == 4);
+    assert(s_sudoku_get_cell_value(g, 0, 1) == 1);
+    assert(s_sudoku_get_cell_value(g, 2, 1) == 3);
+    assert(s_sudoku_get_cell_value(g, 3, 3) == 0);
+    s_sudoku_free(g);
+  }
+
+  assert(!s_sudoku_stream_next(st));  // Invalid grid is skipped
+  assert(!s_sudoku_stream_eof(st));
+
+  s_sudoku g = s_sudoku_stream_next(st);
+  assert(g);
+  assert(s_sudoku_size(g) == 9);
+  assert(s_sudoku_get_cell_value(g, 0, 0) == 8);
+  assert(s_sudoku_get_cell_value(g, 8, 6) == 4);
+  s_sudoku_free(g);
+
+  assert(!s_sudoku_stream_next(st));  // Missing line
+  assert(!s_sudoku_stream_eof(st));
+
+  assert(!s_sudoku_stream_next(st));  // End of the stream
+  assert(s_sudoku_stream_eof(st));
+  assert(!s_sudoku_stream_next(st));
+
+  s_sudoku_stream_free(st);
+  fclose(file);
+}
+
+void test_s_sudoku_stream_eof() {
+  char buffer[] = "\n\n# Nothing\n";
+  FILE *file = fmemopen(buffer, strlen(buffer), "r");
+  assert(file);
+
+  s_sudoku_stream st = s_sudoku_stream_create(file);
+  assert(st);
+
+  assert(!s_sudoku_stream_eof(st));
+  assert(!s_sudoku_stream_next(st));
+  assert(s_sudoku_stream_eof(st));
+
+  s_sudoku_stream_free(st);
+  fclose(file);
+}
+
+void test_s_sudoku_stream_line() {
+  char buffer[] = "\n.12....1.3.2.2..\n\n0;1;2;0\n0;0;0;1\n0;3;0;2\n0;2;0;0\n";
+  FILE *file = fmemopen(buffer, strlen(buffer), "r");
+  assert(file);
+
+  s_sudoku_stream st = s_sudoku_stream_create(file);
+  assert(st);
+
+  s_sudoku g = s_sudoku_stream_next(st);
+  assert(g);
+  assert(s_sudoku_stream_line(st) == 2);
+  s_sudoku_free(g);
+
+  g = s_sudoku_stream_next(st);
+  assert(g);
+  assert(s_sudoku_stream_line(st) == 4);
+  s_sudoku_free(g);
+
+  s_sudoku_stream_free(st);
+  fclose(file);
+}
+
+void usage(char *exec) {
+  printf("%s testname     -> Execute the given testname\n", exec);
+  printf("%s all    -> Execute every tests\n", exec);
+}
+
+int main(int argc, char *argv[]) {
+  if (argc != 2) {
+    usage(argv[0]);
+    exit(EXIT_FAILURE);
+  }
+
+  bool execute_all = strcmp(argv[1], "all") == 0;
+
+  if (strcmp(argv[1], "test_s_sudoku_stream_create") == 0 || execute_all) {
+    test_s_sudoku_stream_create();
+  }
+  if (strcmp(argv[1], "test_s_sudoku_stream_free") == 0 || execute_all) {
+    test_s_sudoku_stream_free();
+  }
+  if (strcmp(argv[1], "test_s_sudoku_stream_next") == 0 || execute_all) {
+    test_s_sudoku_stream_next();
+  }
+  if (strcmp(argv[1], "test_s_sudoku_stream_eof") == 0 || execute_all) {
+    test_s_sudoku_stream_eof();
+  }
+  if (strcmp(argv[1], "test_s_sudoku_stream_line") == 0 || execute_all) {
+    test_s_sudoku_stream_line();
+  }
+  return EXIT_SUCCESS;
+}
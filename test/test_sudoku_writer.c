@@ -0,0 +1,168 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+
+#include <string.h>
+#include <assert.h>
+
+#include "sudoku.h"
+#include "sudoku_writer.h"
+
+/* Reads the whole content of file in buffer and returns its length
+ */
+size_t read_file(FILE *file, char *buffer, size_t size) {
+  rewind(file);
+  size_t length = fread(buffer, 1, size - 1, file);
+  buffer[length] = '\0';
+  return length;
+}
+
+/* Returns the grid of data/test.txt
+ */
+s_sudoku create_test_grid() {
+  char line[] = ".12....1.3.2.2..";
+  s_sudoku g = s_sudoku_create_from_line(line, strlen(line));
+  assert(g);
+  return g;
+}
+
+void test_s_sudoku_writer_create() {
+  FILE *file = tmpfile();
+  assert(file);
+
+  s_sudoku_writer w = s_sudoku_writer_create(file, SUDOKU_WRITER_CAPACITY);
+  assert(w);
+  s_sudoku_writer_free(w);
+
+  assert(!s_sudoku_writer_create(NULL, 10)); // Invalid file
+  assert(!s_sudoku_writer_create(file, 0));  // Invalid capacity
+
+  fclose(file);
+}
+
+void test_s_sudoku_writer_free() {
+  FILE *file = tmpfile();
+  assert(file);
+
+  s_sudoku_writer w = s_sudoku_writer_create(file, SUDOKU_WRITER_CAPACITY);
+  assert(w);
+  assert(s_sudoku_writer_write_string(w, "abc", 3) == 0);
+
+  // Free flushes the writer
+  s_sudoku_writer_free(w);
+
+  char buffer[16];
+  assert(read_file(file, buffer, sizeof(buffer)) == 3);
+  assert(strcmp(buffer, "abc") == 0);
+
+  fclose(file);
+}
+
+void test_s_sudoku_writer_write() {
+  FILE *file = tmpfile();
+  assert(file);
+
+  // Small capacity so the buffer is flushed between grids
+  s_sudoku_writer w = s_sudoku_writer_create(file, 20);
+  assert(w);
+
+  s_sudoku g = create_test_grid();
+
+  assert(s_sudoku_writer_write(w, g, SUDOKU_FORMAT_LINE) == 0);
+  assert(s_sudoku_writer_write(w, g, SUDOKU_FORMAT_SEMICOLON) == 0);
+  assert(s_sudoku_writer_write(w, g, SUDOKU_FORMAT_PRETTY) == 0); // Bigger than capacity
+  assert(s_sudoku_writer_write(w, NULL, SUDOKU_FORMAT_LINE) == -1);
+
+  s_sudoku_writer_free(w);
+
+  char buffer[1024];
+  read_file(file, buffer, sizeof(buffer));
+
+  char expected[] = ".12....1.3.2.2..\n0;1;2;0\n0;0;0;1\n0;3;0;2\n0;2;0;0\n";
+  assert(strncmp(buffer, expected, strlen(expected)) == 0);
+
+  char pretty[1024];
+  size_t length = s_sudoku_render(g, SUDOKU_FORMAT_PRETTY, pretty, sizeof(pretty));
+  pretty[length] = '\0';
+  assert(strcmp(buffer + strlen(expected), pretty) == 0);
+
+  s_sudoku_free(g);
+  fclose(file);
+}
+
+void test_s_sudoku_writer_write_string() {
+  FILE *file = tmpfile();
+  assert(file);
+
+  s_sudoku_writer w = s_sudoku_writer_create(file, 4);
+  assert(w);
+
+  assert(s_sudoku_writer_write_string(w, "abc", 3) == 0);
+  assert(s_sudoku_writer_write_string(w, "defghij", 7) == 0);
+  assert(s_sudoku_writer_write_string(w, NULL, 0) == 0);
+  assert(s_sudoku_writer_write_string(w, NULL, 1) == -1);
+
+  s_sudoku_writer_free(w);
+
+  char buffer[16];
+  read_file(file, buffer, sizeof(buffer));
+  assert(strcmp(buffer, "abcdefghij") == 0);
+
+  fclose(file);
+}
+
+void test_s_sudoku_writer_flush() {
+  FILE *file = tmpfile();
+  assert(file);
+
+  s_sudoku_writer w = s_sudoku_writer_create(file, SUDOKU_WRITER_CAPACITY);
+  assert(w);
+
+  s_sudoku g = create_test_grid();
+  assert(s_sudoku_writer_write(w, g, SUDOKU_FORMAT_LINE) == 0);
+  s_sudoku_free(g);
+
+  // Nothing is written before the flush
+  char buffer[32];
+  assert(read_file(file, buffer, sizeof(buffer)) == 0);
+
+  assert(s_sudoku_writer_flush(w) == 0);
+  assert(read_file(file, buffer, sizeof(buffer)) == 17);
+  assert(strcmp(buffer, ".12....1.3.2.2..\n") == 0);
+
+  assert(s_sudoku_writer_flush(NULL) == -1);
+
+  s_sudoku_writer_free(w);
+  fclose(file);
+}
+
+void usage(char *exec) {
+  printf("%s testname     -> Execute the given testname\n", exec);
+  printf("%s all    -> Execute every tests\n", exec);
+}
+
+int main(int argc, char *argv[]) {
+  if (argc != 2) {
+    usage(argv[0]);
+    exit(EXIT_FAILURE);
+  }
+
+  bool execute_all = strcmp(argv[1], "all") == 0;
+
+  if (strcmp(argv[1], "test_s_sudoku_writer_create") == 0 || execute_all) {
+    test_s_sudoku_writer_create();
+  }
+  if (strcmp(argv[1], "test_s_sudoku_writer_free") == 0 || execute_all) {
+    test_s_sudoku_writer_free();
+  }
+  if (strcmp(argv[1], "test_s_sudoku_writer_write") == 0 || execute_all) {
+    test_s_sudoku_writer_write();
+  }
+  if (strcmp(argv[1], "test_s_sudoku_writer_write_string") == 0 || execute_all) {
+    test_s_sudoku_writer_write_string();
+  }
+  if (strcmp(argv[1], "test_s_sudoku_writer_flush") == 0 || execute_all) {
+    test_s_sudoku_writer_flush();
+  }
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,101 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+
+#include <string.h>
+#include <assert.h>
+
+#include "sudokusat.h"
+
+// Grid of data/test.txt and the solution found by the solver
+#define TEST_GRID ".12....1.3.2.2.."
+#define TEST_SOLUTION "3124243113424213"
+
+void test_sudokusat_solve_cells() {
+  int cells[16], solution[16];
+  for (size_t k = 0; k < 16; k++)
+    cells[k] = s_sudoku_char_to_value(TEST_GRID[k]);
+
+  // With a temporary solver and with a kept one
+  assert(sudokusat_solve_cells(NULL, cells, 4, solution) == 1);
+  for (size_t k = 0; k < 16; k++)
+    assert(solution[k] == TEST_SOLUTION[k] - '0');
+
+  s_sudoku_solver sv = s_sudoku_solver_create();
+  assert(sv);
+  memset(solution, 0, sizeof(solution));
+  assert(sudokusat_solve_cells(sv, cells, 4, solution) == 1);
+  for (size_t k = 0; k < 16; k++)
+    assert(solution[k] == TEST_SOLUTION[k] - '0');
+
+  // In place
+  assert(sudokusat_solve_cells(sv, cells, 4, cells) == 1);
+  assert(memcmp(cells, solution, sizeof(cells)) == 0);
+
+  // No solution, the solution is left unchanged
+  int unsolvable[16] = {1, 1};
+  memset(solution, 0, sizeof(solution));
+  assert(sudokusat_solve_cells(sv, unsolvable, 4, solution) == 0);
+  assert(solution[0] == 0);
+
+  // Invalid grids
+  int invalid[16] = {5};
+  assert(sudokusat_solve_cells(sv, invalid, 4, solution) == -1);
+  invalid[0] = -1;
+  assert(sudokusat_solve_cells(sv, invalid, 4, solution) == -1);
+  assert(sudokusat_solve_cells(sv, cells, 5, solution) == -1);
+  assert(sudokusat_solve_cells(sv, NULL, 4, solution) == -1);
+
+  s_sudoku_solver_free(sv);
+}
+
+void test_sudokusat_solve_string() {
+  char buffer[256];
+
+  assert(sudokusat_solve_string(NULL, TEST_GRID, 16, SUDOKU_FORMAT_LINE, buffer,
+                                sizeof(buffer)) == 17);
+  assert(strcmp(buffer, TEST_SOLUTION "\n") == 0);
+
+  // Semicolon format in and out
+  char grid[] = "0;1;2;0\n0;0;0;1\n0;3;0;2\n0;2;0;0\n";
+  s_sudoku_solver sv = s_sudoku_solver_create();
+  assert(sv);
+  assert(sudokusat_solve_string(sv, grid, strlen(grid), SUDOKU_FORMAT_SEMICOLON, buffer,
+                                sizeof(buffer)) == 32);
+  assert(strcmp(buffer, "3;1;2;4\n2;4;3;1\n1;3;4;2\n4;2;1;3\n") == 0);
+
+  // No solution, the buffer is left unchanged
+  assert(sudokusat_solve_string(sv, "11..............", 16, SUDOKU_FORMAT_LINE, buffer,
+                                sizeof(buffer)) == 0);
+  assert(buffer[0] == '3');
+
+  // Invalid grid and buffer too small
+  assert(sudokusat_solve_string(sv, "1234", 4, SUDOKU_FORMAT_LINE, buffer,
+                                sizeof(buffer)) == -1);
+  assert(sudokusat_solve_string(sv, TEST_GRID, 16, SUDOKU_FORMAT_LINE, buffer, 17) == -1);
+  assert(sudokusat_solve_string(sv, TEST_GRID, 16, SUDOKU_FORMAT_LINE, buffer, 18) == 17);
+
+  s_sudoku_solver_free(sv);
+}
+
+void usage(char *exec) {
+  printf("%s testname     -> Execute the given testname\n", exec);
+  printf("%s all    -> Execute every tests\n", exec);
+}
+
+int main(int argc, char *argv[]) {
+  if (argc != 2) {
+    usage(argv[0]);
+    exit(EXIT_FAILURE);
+  }
+
+  bool execute_all = strcmp(argv[1], "all") == 0;
+
+  if (strcmp(argv[1], "test_sudokusat_solve_cells") == 0 || execute_all) {
+    test_sudokusat_solve_cells();
+  }
+  if (strcmp(argv[1], "test_sudokusat_solve_string") == 0 || execute_all) {
+    test_sudokusat_solve_string();
+  }
+  return EXIT_SUCCESS;
+}
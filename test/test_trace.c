@@ -0,0 +1,110 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+
+#include <string.h>
+#include <assert.h>
+#include <unistd.h>
+#include <pthread.h>
+
+#include "trace.h"
+
+#define TRACE_FILE "test_trace.json"
+
+/* Reads the whole content of filename in buffer and returns its length
+ */
+size_t read_file(char *filename, char *buffer, size_t size) {
+  FILE *file = fopen(filename, "r");
+  assert(file);
+  size_t length = fread(buffer, 1, size - 1, file);
+  buffer[length] = '\0';
+  fclose(file);
+  return length;
+}
+
+void test_trace_start() {
+  assert(trace_available());            // The test is compiled with the macros
+
+  assert(trace_start(TRACE_FILE) == 0);
+  assert(trace_start(TRACE_FILE) == -1);  // Already started
+  assert(trace_stop() == 0);
+  assert(trace_stop() == -1);             // Not started
+
+  assert(trace_start(NULL) == -1);        // Invalid filename
+
+  unlink(TRACE_FILE);
+}
+
+void *record_events(void *arg) {
+  (void) arg;
+  for (int k = 0; k < 5000; k++) TRACE_INSTANT("test", "thread");
+  return NULL;
+}
+
+void test_trace_event() {
+  TRACE_BEGIN("test", "ignored");         // No trace started
+
+  assert(trace_start(TRACE_FILE) == 0);
+  TRACE_BEGIN("test", "span");
+  TRACE_INSTANT("test", "event \"quoted\"");
+  TRACE_END("test", "span");
+  assert(trace_stop() == 0);
+
+  TRACE_END("test", "ignored");
+
+  char buffer[4096];
+  read_file(TRACE_FILE, buffer, sizeof(buffer));
+
+  // Every event is recorded in order with its phase
+  char *begin = strstr(buffer, "{\"name\": \"span\", \"cat\": \"test\", \"ph\": \"B\"");
+  char *instant = strstr(buffer, "{\"name\": \"event \\\"quoted\\\"\", \"cat\": \"test\", \"ph\": \"i\"");
+  char *end = strstr(buffer, "{\"name\": \"span\", \"cat\": \"test\", \"ph\": \"E\"");
+  assert(begin && instant && end);
+  assert(begin < instant && instant < end);
+  assert(strstr(instant, "\"s\": \"t\"}"));
+
+  assert(!strstr(buffer, "ignored"));
+  assert(strstr(buffer, "\"dropped_events\": 0"));
+  assert(strstr(buffer, "\"traceEvents\": ["));
+
+  // Threads recording at once, over several chunks of records: every event
+  // is kept
+  assert(trace_start(TRACE_FILE) == 0);
+  pthread_t threads[4];
+  for (int k = 0; k < 4; k++) assert(pthread_create(&threads[k], NULL, record_events, NULL) == 0);
+  for (int k = 0; k < 4; k++) pthread_join(threads[k], NULL);
+  assert(trace_stop() == 0);
+
+  static char events[1 << 22];
+  read_file(TRACE_FILE, events, sizeof(events));
+  assert(strstr(events, "\"dropped_events\": 0"));
+  size_t count = 0;
+  for (char *e = events; (e = strstr(e, "\"name\": \"thread\"")); e++) count++;
+  assert(count == 4 * 5000);
+
+  unlink(TRACE_FILE);
+}
+
+void usage(char *exec) {
+  printf("%s testname     -> Execute the given testname\n", exec);
+  printf("%s all    -> Execute every tests\n", exec);
+}
+
+int main(int argc, char *argv[]) {
+  if (argc != 2) {
+    usage(argv[0]);
+    exit(EXIT_FAILURE);
+  }
+
+  bool execute_all = strcmp(argv[1], "all") == 0;
+
+  if (strcmp(argv[1], "test_trace_start") == 0 || execute_all) {
+    test_trace_start();
+  }
+  if (strcmp(argv[1], "test_trace_event") == 0 || execute_all) {
+    test_trace_event();
+  }
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,318 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+
+#include "sudoku.h"
+#include "sudoku_cnf.h"
+#include "sudoku_writer.h"
+
+
+// ===== USEFULL DEFINES =====
+
+// Largest size of grid supported, the candidates of a cell are a 64 bits mask
+#define SUDOKUGEN_MAX_SIZE 64
+
+// Search budget of the backtracking uniqueness check, faster on small grids,
+// the grids whose check runs out of it are checked by the sat solver
+#define SUDOKUGEN_NODES 10000
+
+// ===========================
+
+
+// ===== STRUCTS =====
+
+// State of the backtracking search counting the solutions of a grid
+struct search {
+  size_t n, b;
+  int *cells;           // Value of each cell, 0 when empty
+  uint64_t *rows;       // Values used by each row, column and block
+  uint64_t *cols;
+  uint64_t *blocks;
+  size_t nodes;         // Nodes left in the budget
+};
+
+// ===================
+
+
+// ===== PRIVATE =====
+
+/* splitmix64, a small generator whose output only depends on the seed so
+ * the same seed gives the same grids on every platform
+ */
+uint64_t next_random(uint64_t *state) {
+  uint64_t z = (*state += 0x9E3779B97F4A7C15ULL);
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+  return z ^ (z >> 31);
+}
+
+// Returns a random number in [0, bound)
+size_t random_below(uint64_t *state, size_t bound) {
+  return next_random(state) % bound;
+}
+
+// Shuffles the array values of length values
+void shuffle(uint64_t *state, size_t *values, size_t length) {
+  for (size_t k = length; k > 1; k--) {
+    size_t r = random_below(state, k);
+    size_t tmp = values[k - 1];
+    values[k - 1] = values[r];
+    values[r] = tmp;
+  }
+}
+
+/* Fills map with a random permutation of the rows (or columns) of a grid of
+ * size n = b * b that keeps the rows of a band together
+ */
+void shuffle_lines(uint64_t *state, size_t *map, size_t b) {
+  size_t bands[SUDOKUGEN_MAX_SIZE], lines[SUDOKUGEN_MAX_SIZE];
+  for (size_t k = 0; k < b; k++)
+    bands[k] = k;
+  shuffle(state, bands, b);
+
+  for (size_t band = 0; band < b; band++) {
+    for (size_t k = 0; k < b; k++)
+      lines[k] = k;
+    shuffle(state, lines, b);
+
+    for (size_t k = 0; k < b; k++)
+      map[band * b + k] = bands[band] * b + lines[k];
+  }
+}
+
+/* Fills g with a random complete grid : a valid pattern whose bands, rows,
+ * stacks, columns and values are shuffled and which is transposed half of
+ * the time
+ */
+void fill_grid(uint64_t *state, s_sudoku g, size_t b) {
+  size_t n = b * b;
+  size_t rows[SUDOKUGEN_MAX_SIZE], cols[SUDOKUGEN_MAX_SIZE], values[SUDOKUGEN_MAX_SIZE];
+
+  shuffle_lines(state, rows, b);
+  shuffle_lines(state, cols, b);
+  for (size_t k = 0; k < n; k++)
+    values[k] = k + 1;
+  shuffle(state, values, n);
+  bool transpose = random_below(state, 2);
+
+  for (size_t i = 0; i < n; i++) {
+    for (size_t j = 0; j < n; j++) {
+      size_t r = rows[i], c = cols[j];
+      size_t pattern = (b * (r % b) + r / b + c) % n;
+      if (transpose) s_sudoku_set_cell_value(g, j, i, values[pattern]);
+      else s_sudoku_set_cell_value(g, i, j, values[pattern]);
+    }
+  }
+}
+
+size_t search_block(struct search *s, size_t cell) {
+  size_t i = cell / s->n, j = cell % s->n;
+  return i / s->b * s->b + j / s->b;
+}
+
+void search_set(struct search *s, size_t cell, int value) {
+  uint64_t bit = (uint64_t) 1 << (value - 1);
+  s->cells[cell] = value;
+  s->rows[cell / s->n] ^= bit;
+  s->cols[cell % s->n] ^= bit;
+  s->blocks[search_block(s, cell)] ^= bit;
+}
+
+void search_unset(struct search *s, size_t cell) {
+  search_set(s, cell, s->cells[cell]);   // The masks are toggled back
+  s->cells[cell] = 0;
+}
+
+/* Counts the solutions of the grid of the search, stopping at limit
+ *
+ * Returns the number of solutions found (at most limit), or limit when the
+ * budget of nodes runs out
+ */
+size_t search_count(struct search *s, size_t limit) {
+  if (s->nodes == 0) return limit;
+  s->nodes--;
+
+  uint64_t full = s->n == 64 ? UINT64_MAX : ((uint64_t) 1 << s->n) - 1;
+
+  // Branch on the empty cell with the fewest candidates
+  size_t best = SIZE_MAX;
+  uint64_t best_candidates = 0;
+  int best_count = SUDOKUGEN_MAX_SIZE + 1;
+
+  for (size_t cell = 0; cell < s->n * s->n; cell++) {
+    if (s->cells[cell]) continue;
+
+    uint64_t used = s->rows[cell / s->n] | s->cols[cell % s->n]
+                    | s->blocks[search_block(s, cell)];
+    uint64_t candidates = ~used & full;
+    int count = __builtin_popcountll(candidates);
+
+    if (count < best_count) {
+      best = cell;
+      best_candidates = candidates;
+      best_count = count;
+      if (count <= 1) break;
+    }
+  }
+
+  if (best == SIZE_MAX) return 1;   // Every cell is filled
+  if (best_count == 0) return 0;
+
+  size_t found = 0;
+  while (best_candidates && found < limit) {
+    int value = __builtin_ctzll(best_candidates) + 1;
+    best_candidates &= best_candidates - 1;
+
+    search_set(s, best, value);
+    found += search_count(s, limit - found);
+    search_unset(s, best);
+  }
+
+  return found;
+}
+
+/* Returns whether g has exactly one solution, counted by the backtracking
+ * search or by the solver sv past its budget (see SUDOKUGEN_NODES)
+ */
+bool has_unique_solution(s_sudoku_solver sv, s_sudoku g, size_t b) {
+  size_t n = b * b;
+  struct search s = {n, b, calloc(n * n, sizeof(int)), calloc(n, sizeof(uint64_t)),
+                     calloc(n, sizeof(uint64_t)), calloc(n, sizeof(uint64_t)),
+                     SUDOKUGEN_NODES};
+  bool unique = false;
+
+  if (s.cells && s.rows && s.cols && s.blocks) {
+    for (size_t cell = 0; cell < n * n; cell++) {
+      int value = s_sudoku_get_cell_value(g, cell / n, cell % n);
+      if (value > 0) search_set(&s, cell, value);
+    }
+    size_t found = search_count(&s, 2);
+    unique = s.nodes > 0 ? found == 1 : s_sudoku_solver_count(sv, g, 2) == 1;
+  }
+
+  free(s.cells);
+  free(s.rows);
+  free(s.cols);
+  free(s.blocks);
+  return unique;
+}
+
+/* Empties cells of the complete grid g in a random order until it has clues
+ * given cells. With unique, a cell is only emptied if the grid keeps a
+ * unique solution, so the grid may keep more clues when it becomes minimal.
+ */
+void remove_clues(uint64_t *state, s_sudoku_solver sv, s_sudoku g, size_t b, size_t clues,
+                  bool unique) {
+  size_t n = b * b;
+  size_t *cells = malloc(sizeof(size_t) * n * n);
+  if (!cells) return;
+
+  for (size_t k = 0; k < n * n; k++)
+    cells[k] = k;
+  shuffle(state, cells, n * n);
+
+  size_t given = n * n;
+  for (size_t k = 0; k < n * n && given > clues; k++) {
+    size_t i = cells[k] / n, j = cells[k] % n;
+    int value = s_sudoku_get_cell_value(g, i, j);
+
+    s_sudoku_set_cell_value(g, i, j, 0);
+    if (unique && !has_unique_solution(sv, g, b)) s_sudoku_set_cell_value(g, i, j, value);
+    else given--;
+  }
+
+  free(cells);
+}
+
+void usage(char *exec) {
+  printf("%s [-n size] [-k count] [-c clues] [-u | -m] [-s seed] [-l]\n", exec);
+  printf("    Prints count (default 1) random solvable grids of size n (default 9)\n");
+  printf("    with clues given cells (default 2/5 of the cells).\n");
+  printf("    -u : only keep grids with a unique solution, cells are emptied while\n");
+  printf("      the solution stays unique so a grid may keep more clues\n");
+  printf("    -m : near-minimal grids, same as -u -c 0\n");
+  printf("    -s seed : the same seed always gives the same grids (default 1)\n");
+  printf("    -l : one grid per line instead of the semicolon format\n");
+}
+
+// ===================
+
+
+int main(int argc, char *argv[]) {
+  size_t n = 9, count = 1;
+  long clues = -1;
+  bool unique = false, line = false;
+  uint64_t seed = 1;
+
+  int opt;
+  while ((opt = getopt(argc, argv, "n:k:c:ums:l")) != -1) {
+    if (opt == 'n' && atoi(optarg) > 1) {
+      n = atoi(optarg);
+    } else if (opt == 'k' && atol(optarg) >= 0) {
+      count = atol(optarg);
+    } else if (opt == 'c' && atol(optarg) >= 0) {
+      clues = atol(optarg);
+    } else if (opt == 'u') {
+      unique = true;
+    } else if (opt == 'm') {
+      unique = true;
+      clues = 0;
+    } else if (opt == 's') {
+      seed = strtoull(optarg, NULL, 10);
+    } else if (opt == 'l') {
+      line = true;
+    } else {
+      usage(argv[0]);
+      exit(EXIT_FAILURE);
+    }
+  }
+
+  size_t b = 1;
+  while (b * b < n) b++;
+
+  if (optind != argc || b * b != n || n > SUDOKUGEN_MAX_SIZE) {
+    fprintf(stderr, "%zu: the size must be a perfect square up to %d\n", n, SUDOKUGEN_MAX_SIZE);
+    usage(argv[0]);
+    exit(EXIT_FAILURE);
+  }
+
+  if (line && n > 35) {
+    fprintf(stderr, "%zu: grids larger than 35 can't be written on one line\n", n);
+    exit(EXIT_FAILURE);
+  }
+
+  if (clues < 0) clues = n * n * 2 / 5;
+
+  s_sudoku g = s_sudoku_create(n);
+  s_sudoku_solver sv = s_sudoku_solver_create();
+  s_sudoku_writer w = s_sudoku_writer_create(stdout, SUDOKU_WRITER_CAPACITY);
+  if (!g || !sv || !w) return EXIT_FAILURE;
+
+  sudoku_format format = line ? SUDOKU_FORMAT_LINE : SUDOKU_FORMAT_SEMICOLON;
+  uint64_t state = seed;
+  int status = EXIT_SUCCESS;
+
+  for (size_t k = 0; k < count && status == EXIT_SUCCESS; k++) {
+    fill_grid(&state, g, b);
+    remove_clues(&state, sv, g, b, clues, unique);
+
+    // Blank line between two grids of the semicolon format
+    if (!line && k > 0 && s_sudoku_writer_write_string(w, "\n", 1) == -1)
+      status = EXIT_FAILURE;
+    if (s_sudoku_writer_write(w, g, format) == -1)
+      status = EXIT_FAILURE;
+  }
+
+  if (s_sudoku_writer_flush(w) == -1) status = EXIT_FAILURE;
+
+  s_sudoku_writer_free(w);
+  s_sudoku_solver_free(sv);
+  s_sudoku_free(g);
+  return status;
+}
@@ -0,0 +1,130 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+
+#include <string.h>
+
+#include "sudoku.h"
+#include "sudoku_stream.h"
+#include "sudoku_pack.h"
+#include "sudoku_writer.h"
+
+void usage(char *exec) {
+  printf("%s pack <input> <output>\n", exec);
+  printf("    Converts every grid of the text file input (- for the standard input)\n");
+  printf("    to the pack file output. Every grid must have the same size.\n");
+  printf("%s unpack [-l] <input> [first [count]]\n", exec);
+  printf("    Prints count grids of the pack file input starting at grid first\n");
+  printf("    in the semicolon format or one per line with -l.\n");
+}
+
+int pack(char *input, char *output) {
+  bool use_stdin = strcmp(input, "-") == 0;
+
+  FILE *file = use_stdin ? stdin : fopen(input, "r");
+  if (!file) return EXIT_FAILURE;
+
+  s_sudoku_stream st = s_sudoku_stream_create(file);
+  if (!st) return EXIT_FAILURE;
+
+  int status = EXIT_SUCCESS;
+  s_sudoku_pack_writer w = NULL;
+  size_t n = 0;
+
+  while (!s_sudoku_stream_eof(st)) {
+    s_sudoku g = s_sudoku_stream_next(st);
+    if (!g) {
+      if (!s_sudoku_stream_eof(st)) {
+        fprintf(stderr, "%s:%zu: invalid grid\n", input, s_sudoku_stream_line(st));
+        status = EXIT_FAILURE;
+      }
+      continue;
+    }
+
+    // The size of the pack is the size of its first grid
+    if (!w) {
+      n = s_sudoku_size(g);
+      w = s_sudoku_pack_writer_create(output, n);
+    }
+    if (!w) {
+      s_sudoku_free(g);
+      status = EXIT_FAILURE;
+      break;
+    }
+
+    if (s_sudoku_pack_writer_add(w, g) == -1) {
+      fprintf(stderr, "%s:%zu: grid of size %zu can't be added to a pack of grids of size %zu\n",
+              input, s_sudoku_stream_line(st), s_sudoku_size(g), n);
+      status = EXIT_FAILURE;
+    }
+
+    s_sudoku_free(g);
+  }
+
+  if (!w || s_sudoku_pack_writer_close(w) == -1) status = EXIT_FAILURE;
+
+  s_sudoku_stream_free(st);
+  if (!use_stdin) fclose(file);
+  return status;
+}
+
+int unpack(char *input, size_t first, size_t count, bool line) {
+  s_sudoku_pack pk = s_sudoku_pack_open(input);
+  if (!pk) return EXIT_FAILURE;
+
+  s_sudoku g = s_sudoku_create(s_sudoku_pack_size(pk));
+  s_sudoku_writer w = s_sudoku_writer_create(stdout, SUDOKU_WRITER_CAPACITY);
+  if (!g || !w) {
+    if (g) s_sudoku_free(g);
+    if (w) s_sudoku_writer_free(w);
+    s_sudoku_pack_close(pk);
+    return EXIT_FAILURE;
+  }
+
+  sudoku_format format = line ? SUDOKU_FORMAT_LINE : SUDOKU_FORMAT_SEMICOLON;
+
+  int status = EXIT_SUCCESS;
+
+  size_t last = s_sudoku_pack_count(pk);
+  if (first > last) first = last;
+  if (count < last - first) last = first + count;
+
+  for (size_t k = first; k < last; k++) {
+    if (s_sudoku_pack_load(pk, k, g) == -1 || s_sudoku_writer_write(w, g, format) == -1) {
+      status = EXIT_FAILURE;
+      break;
+    }
+
+    // Blank line between two grids of the semicolon format
+    if (!line && s_sudoku_writer_write_string(w, "\n", 1) == -1) {
+      status = EXIT_FAILURE;
+      break;
+    }
+  }
+
+  if (s_sudoku_writer_flush(w) == -1) status = EXIT_FAILURE;
+
+  s_sudoku_writer_free(w);
+  s_sudoku_free(g);
+  s_sudoku_pack_close(pk);
+  return status;
+}
+
+int main(int argc, char *argv[]) {
+  if (argc == 4 && strcmp(argv[1], "pack") == 0)
+    return pack(argv[2], argv[3]);
+
+  if (argc >= 3 && strcmp(argv[1], "unpack") == 0) {
+    bool line = strcmp(argv[2], "-l") == 0;
+    int k = line ? 3 : 2;
+
+    if (argc > k && argc <= k + 3) {
+      size_t first = argc > k + 1 ? strtoull(argv[k + 1], NULL, 10) : 0;
+      size_t count = argc > k + 2 ? strtoull(argv[k + 2], NULL, 10) : (size_t)-1;
+      return unpack(argv[k], first, count, line);
+    }
+  }
+
+  usage(argv[0]);
+  return EXIT_FAILURE;
+}